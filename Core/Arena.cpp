@@ -0,0 +1,123 @@
+#include "Arena.h"
+#include "Platform.h"
+#include <cstring>
+
+namespace
+{
+    std::size_t AlignUp(std::size_t value, std::size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    bool IsPowerOfTwo(std::size_t v)
+    {
+        return v != 0 && (v & (v - 1)) == 0;
+    }
+}
+
+namespace Memory
+{
+    Arena::Arena(const ArenaOptions& options)
+        : m_Options(options)
+    {
+        if (!IsPowerOfTwo(m_Options.alignment))
+            m_Options.alignment = 16;
+    }
+
+    Arena::~Arena()
+    {
+        Release();
+    }
+
+    int Arena::Reserve(std::size_t size, int tag, std::size_t alignment)
+    {
+        if (!IsPowerOfTwo(alignment))
+            alignment = m_Options.alignment;
+
+        ArenaBlock b;
+        b.offset = AlignUp(m_Planned, alignment);
+        b.size = size;
+        b.padding = b.offset - m_Planned;
+        b.tag = tag;
+
+        m_Blocks.push_back(b);
+        m_Planned = b.offset + size + m_Options.guardBytes;
+
+        return static_cast<int>(m_Blocks.size()) - 1;
+    }
+
+    bool Arena::Allocate()
+    {
+        if (m_Planned == 0)
+            return false;
+
+        m_Data = static_cast<std::uint8_t*>(Platform::AllocPages(m_Planned));
+        if (!m_Data)
+            return false;
+
+        m_Owned = true;
+        FillGuards();
+        return true;
+    }
+
+    void Arena::Attach(std::uint8_t* mem)
+    {
+        m_Data = mem;
+        m_Owned = false;
+        FillGuards();
+    }
+
+    void Arena::Release()
+    {
+        if (m_Owned)
+            Platform::FreePages(m_Data, m_Planned);
+
+        m_Data = nullptr;
+        m_Owned = false;
+        m_Blocks.clear();
+        m_Planned = 0;
+    }
+
+    void Arena::Reset(const ArenaOptions& options)
+    {
+        Release();
+
+        m_Options = options;
+        if (!IsPowerOfTwo(m_Options.alignment))
+            m_Options.alignment = 16;
+    }
+
+    void Arena::FillGuards()
+    {
+        if (!m_Data || m_Options.guardBytes == 0)
+            return;
+
+        for (const ArenaBlock& b : m_Blocks)
+            std::memset(m_Data + b.offset + b.size, GUARD_FILL, m_Options.guardBytes);
+    }
+
+    int Arena::CheckGuards(std::vector<int>* damaged) const
+    {
+        if (!m_Data || m_Options.guardBytes == 0)
+            return 0;
+
+        int bad = 0;
+        for (std::size_t i = 0; i < m_Blocks.size(); ++i)
+        {
+            const std::uint8_t* g = m_Data + m_Blocks[i].offset + m_Blocks[i].size;
+
+            for (std::size_t k = 0; k < m_Options.guardBytes; ++k)
+            {
+                if (g[k] != GUARD_FILL)
+                {
+                    ++bad;
+                    if (damaged)
+                        damaged->push_back(static_cast<int>(i));
+                    break;
+                }
+            }
+        }
+
+        return bad;
+    }
+}
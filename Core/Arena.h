@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Block arena with a planning step: every block is reserved first (size,
+// alignment, tag), then the whole arena is backed by one allocation of
+// exactly the planned size. Blocks may be followed by guard bytes filled with
+// GUARD_FILL; CheckGuards reports any block that wrote past its end.
+namespace Memory
+{
+    constexpr std::uint8_t GUARD_FILL = 0xFD;
+
+    struct ArenaOptions
+    {
+        std::size_t alignment = 16; // default block alignment (power of two)
+        std::size_t guardBytes = 0; // after each block; 0 disables guards
+    };
+
+    struct ArenaBlock
+    {
+        std::size_t offset = 0;   // from the arena start
+        std::size_t size = 0;     // requested bytes
+        std::size_t padding = 0;  // alignment bytes in front of the block
+        int         tag = -1;
+    };
+
+    class Arena
+    {
+    public:
+        explicit Arena(const ArenaOptions& options = ArenaOptions());
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        // Plans a block after the previous ones; alignment 0 uses the
+        // arena default. Returns the block id. Only before Allocate/Attach.
+        int Reserve(std::size_t size, int tag, std::size_t alignment = 0);
+
+        // Bytes the planned blocks need, guards included.
+        std::size_t PlannedBytes() const { return m_Planned; }
+
+        // Backs the plan with zeroed pages owned by the arena.
+        bool Allocate();
+
+        // Backs the plan with caller memory (zeroed, PlannedBytes() long),
+        // which the arena does not free.
+        void Attach(std::uint8_t* mem);
+
+        // Frees owned memory and forgets the plan.
+        void Release();
+
+        // Release, then plan with new options.
+        void Reset(const ArenaOptions& options);
+
+        std::uint8_t* Data() const { return m_Data; }
+        std::uint8_t* BlockData(int id) const { return m_Data + m_Blocks[id].offset; }
+
+        const std::vector<ArenaBlock>& Blocks() const { return m_Blocks; }
+        const ArenaOptions&            Options() const { return m_Options; }
+
+        // Number of blocks whose guard bytes changed; their ids go to damaged.
+        int CheckGuards(std::vector<int>* damaged = nullptr) const;
+
+    private:
+        void FillGuards();
+
+        ArenaOptions            m_Options;
+        std::vector<ArenaBlock> m_Blocks;
+        std::size_t             m_Planned = 0;
+        std::uint8_t*           m_Data = nullptr;
+        bool                    m_Owned = false;
+    };
+}
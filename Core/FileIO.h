@@ -1,12 +1,21 @@
 #pragma once
 #include <cstdio>
 
-// Simple helper for binary read-only open.
+// Simple helpers for binary open.
 // Kept as FILE* because the rest of the code uses C stdio.
-inline std::FILE* OpenFileRead(const char* path)
+inline std::FILE* OpenFile(const char* path, const char* mode)
 {
+#ifdef _MSC_VER
     std::FILE* f = nullptr;
-    if (fopen_s(&f, path, "rb") != 0)
+    if (fopen_s(&f, path, mode) != 0)
         return nullptr;
     return f;
+#else
+    return std::fopen(path, mode);
+#endif
+}
+
+inline std::FILE* OpenFileRead(const char* path)
+{
+    return OpenFile(path, "rb");
 }
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// 64-bit FNV-1a. Fast and good enough for cache keys and file checksums.
+constexpr std::uint64_t FNV1A_OFFSET = 14695981039346656037ull;
+constexpr std::uint64_t FNV1A_PRIME = 1099511628211ull;
+
+inline std::uint64_t HashBytes(const void* data,
+    std::size_t size,
+    std::uint64_t h = FNV1A_OFFSET)
+{
+    const auto* p = static_cast<const std::uint8_t*>(data);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        h ^= p[i];
+        h *= FNV1A_PRIME;
+    }
+    return h;
+}
+
+template <typename T>
+inline std::uint64_t HashValue(const T& v, std::uint64_t h)
+{
+    return HashBytes(&v, sizeof(v), h);
+}
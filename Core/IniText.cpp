@@ -0,0 +1,260 @@
+#include "IniText.h"
+#include "Platform.h"
+#include <cmath>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+#include <utility>
+
+namespace
+{
+    bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    void Trim(const char*& b, const char*& e)
+    {
+        while (b < e && IsSpace(*b))
+            ++b;
+        while (e > b && IsSpace(e[-1]))
+            --e;
+    }
+
+    char Lower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    bool RangeEqualsNoCase(const char* b, const char* e, const char* name)
+    {
+        for (; b < e && *name; ++b, ++name)
+        {
+            if (Lower(*b) != Lower(*name))
+                return false;
+        }
+        return b == e && *name == '\0';
+    }
+
+    // Calls onHeader(begin, end) with the trimmed name of every [section]
+    // line and onEntry(Entry) for every key = value line, in file order.
+    // Blank lines and ';' / '#' comment lines are skipped; a value ends at
+    // an inline ';'.
+    template <typename OnHeader, typename OnEntry>
+    void ScanLines(const std::string& text, OnHeader onHeader, OnEntry onEntry)
+    {
+        const char* p = text.data();
+        const char* end = p + text.size();
+
+        while (p < end)
+        {
+            const char* lineEnd = p;
+            while (lineEnd < end && *lineEnd != '\n')
+                ++lineEnd;
+
+            const char* b = p;
+            const char* e = lineEnd;
+            p = lineEnd < end ? lineEnd + 1 : end;
+
+            Trim(b, e);
+            if (b == e || *b == ';' || *b == '#')
+                continue;
+
+            if (*b == '[')
+            {
+                const char* close = b + 1;
+                while (close < e && *close != ']')
+                    ++close;
+
+                const char* nb = b + 1;
+                const char* ne = close;
+                Trim(nb, ne);
+
+                onHeader(nb, ne);
+                continue;
+            }
+
+            const char* eq = b;
+            while (eq < e && *eq != '=')
+                ++eq;
+            if (eq == e)
+                continue;
+
+            const char* kb = b;
+            const char* ke = eq;
+            Trim(kb, ke);
+
+            const char* vb = eq + 1;
+            const char* ve = vb;
+            while (ve < e && *ve != ';')
+                ++ve;
+            Trim(vb, ve);
+
+            if (kb == ke)
+                continue;
+
+            onEntry(IniText::Entry{ std::string(kb, ke), std::string(vb, ve) });
+        }
+    }
+}
+
+namespace IniText
+{
+    bool EqualsNoCase(const char* a, const char* b)
+    {
+        for (; *a && *b; ++a, ++b)
+        {
+            if (Lower(*a) != Lower(*b))
+                return false;
+        }
+        return *a == *b;
+    }
+
+    const Entry* Section::Find(const char* key) const
+    {
+        for (auto it = entries.rbegin(); it != entries.rend(); ++it)
+        {
+            if (EqualsNoCase(it->key.c_str(), key))
+                return &*it;
+        }
+        return nullptr;
+    }
+
+    bool ReadSection(const std::string& text, const char* name, Section& out)
+    {
+        out = Section{};
+        bool inSection = false;
+
+        ScanLines(text,
+            [&](const char* nb, const char* ne)
+            {
+                inSection = RangeEqualsNoCase(nb, ne, name);
+                if (inSection && !out.present)
+                {
+                    out.name.assign(nb, ne);
+                    out.present = true;
+                }
+            },
+            [&](Entry&& entry)
+            {
+                if (inSection)
+                    out.entries.push_back(std::move(entry));
+            });
+
+        return out.present;
+    }
+
+    const Section* Document::FindSection(const char* name) const
+    {
+        for (const Section& sec : sections)
+        {
+            if (EqualsNoCase(sec.name.c_str(), name))
+                return &sec;
+        }
+        return nullptr;
+    }
+
+    const Entry* Document::Find(const char* section, const char* key) const
+    {
+        const Section* sec = FindSection(section);
+        return sec ? sec->Find(key) : nullptr;
+    }
+
+    void Document::ListSections(const char* prefix, std::vector<std::string>& out) const
+    {
+        out.clear();
+
+        std::size_t prefixLen = 0;
+        while (prefix[prefixLen])
+            ++prefixLen;
+
+        for (const Section& sec : sections)
+        {
+            const char* nb = sec.name.data();
+            if (sec.name.size() > prefixLen && RangeEqualsNoCase(nb, nb + prefixLen, prefix))
+                out.push_back(sec.name.substr(prefixLen));
+        }
+    }
+
+    void ReadDocument(const std::string& text, Document& out)
+    {
+        out = Document{};
+        out.present = true;
+
+        Section* current = nullptr;
+
+        ScanLines(text,
+            [&](const char* nb, const char* ne)
+            {
+                current = nullptr;
+                for (Section& sec : out.sections)
+                {
+                    if (RangeEqualsNoCase(nb, ne, sec.name.c_str()))
+                        current = &sec;
+                }
+
+                if (!current)
+                {
+                    out.sections.emplace_back();
+                    current = &out.sections.back();
+                    current->name.assign(nb, ne);
+                    current->present = true;
+                }
+            },
+            [&](Entry&& entry)
+            {
+                if (current)
+                    current->entries.push_back(std::move(entry));
+            });
+    }
+
+    bool LoadDocument(const std::string& path, Document& out)
+    {
+        std::string text;
+        if (!Platform::ReadWholeFile(path, text))
+        {
+            out = Document{};
+            return false;
+        }
+
+        ReadDocument(text, out);
+        return true;
+    }
+
+    bool ParseInt(const std::string& s, int& out)
+    {
+        if (s.empty())
+            return false;
+
+        errno = 0;
+        char* endp = nullptr;
+        const long v = std::strtol(s.c_str(), &endp, 10);
+        if (endp == s.c_str() || *endp != '\0' || errno == ERANGE ||
+            v < INT_MIN || v > INT_MAX)
+            return false;
+
+        out = static_cast<int>(v);
+        return true;
+    }
+
+    bool ParseDouble(const std::string& s, double& out)
+    {
+        // strtod also takes hex, inf and nan; INI values are plain decimals
+        if (s.empty())
+            return false;
+
+        for (const char c : s)
+        {
+            if (!((c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+' || c == 'e' || c == 'E'))
+                return false;
+        }
+
+        char*        endp = nullptr;
+        const double v = std::strtod(s.c_str(), &endp);
+        if (endp == s.c_str() || *endp != '\0' || !std::isfinite(v))
+            return false;
+
+        out = v;
+        return true;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Minimal INI scanner: one section of a text (Track INIs) or a whole file
+// parsed once (GP4MD.ini), with the keys each section actually contains.
+namespace IniText
+{
+    struct Entry
+    {
+        std::string key;
+        std::string value; // trimmed, inline ';' comment removed
+    };
+
+    struct Section
+    {
+        std::string        name;            // as written in the first header
+        bool               present = false;
+        std::vector<Entry> entries; // file order; later duplicates win when applied in order
+
+        // Last entry with this key (case-insensitive), or nullptr
+        const Entry* Find(const char* key) const;
+    };
+
+    // Collects every key=value of [name] (case-insensitive, repeated headers merge).
+    bool ReadSection(const std::string& text, const char* name, Section& out);
+
+    // Every section of a file in file order, repeated headers merged; keys
+    // before the first header are ignored.
+    struct Document
+    {
+        bool                 present = false; // the file was read
+        std::vector<Section> sections;
+
+        // nullptr when the file has no such section (case-insensitive)
+        const Section* FindSection(const char* name) const;
+
+        // Last entry of key in section, or nullptr
+        const Entry* Find(const char* section, const char* key) const;
+
+        // Names of the sections whose name starts with prefix (case-insensitive),
+        // without the prefix, in file order.
+        void ListSections(const char* prefix, std::vector<std::string>& out) const;
+    };
+
+    void ReadDocument(const std::string& text, Document& out);
+
+    // False (and out empty) when the file is missing or unreadable.
+    bool LoadDocument(const std::string& path, Document& out);
+
+    // Decimal integer with optional sign; trailing text is an error.
+    bool ParseInt(const std::string& s, int& out);
+
+    // Decimal number as strtod reads it (no hex, inf or nan); trailing text
+    // is an error.
+    bool ParseDouble(const std::string& s, double& out);
+
+    bool EqualsNoCase(const char* a, const char* b);
+}
@@ -0,0 +1,798 @@
+#include "Logging.h"
+#include "FileIO.h"
+#include "IniText.h"
+#include "Platform.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    // -------------------------------------------------------------------------
+    // Records
+    // -------------------------------------------------------------------------
+    constexpr std::size_t RING_SIZE = 1024; // power of two
+    constexpr int         MAX_ARGS = 12;
+    constexpr std::size_t TEXT_BYTES = 160; // copied %s arguments
+    constexpr std::uint16_t NO_TEXT = 0xFFFF;
+
+    enum class ArgKind : std::uint8_t
+    {
+        Int, UInt, Long, ULong, LLong, ULLong, Size, PtrDiff,
+        Double, LongDouble, Pointer, String
+    };
+
+    struct Arg
+    {
+        ArgKind kind;
+        union
+        {
+            long long          i;
+            unsigned long long u;
+            long double        ld;
+            double             d;
+            const void*        p;
+            std::uint16_t      str; // offset into Record::text
+        };
+    };
+
+    struct Record
+    {
+        const char*   prefix;
+        const char*   fmt;           // nullptr: written by the caller (WriteNow)
+        int           argCount;
+        std::uint16_t textUsed;
+        Arg           args[MAX_ARGS];
+        char          text[TEXT_BYTES];
+    };
+
+    struct Slot
+    {
+        std::atomic<std::size_t> seq;
+        Record                   rec;
+    };
+
+    // -------------------------------------------------------------------------
+    // Format specs
+    // -------------------------------------------------------------------------
+    enum class Length { None, hh, h, l, ll, z, j, t, L };
+
+    struct Spec
+    {
+        const char* begin = nullptr; // at '%'
+        const char* end = nullptr;   // one past the conversion
+        char        conv = 0;
+        Length      length = Length::None;
+        bool        starWidth = false;
+        bool        starPrecision = false;
+    };
+
+    // Parses the spec starting at p ('%'); false on a malformed tail.
+    bool ParseSpec(const char* p, Spec& s)
+    {
+        s = Spec{};
+        s.begin = p++;
+
+        while (*p && std::strchr("-+ #0", *p))
+            ++p;
+
+        if (*p == '*')
+        {
+            s.starWidth = true;
+            ++p;
+        }
+        while (*p >= '0' && *p <= '9')
+            ++p;
+
+        if (*p == '.')
+        {
+            ++p;
+            if (*p == '*')
+            {
+                s.starPrecision = true;
+                ++p;
+            }
+            while (*p >= '0' && *p <= '9')
+                ++p;
+        }
+
+        switch (*p)
+        {
+        case 'h': ++p; if (*p == 'h') { s.length = Length::hh; ++p; } else s.length = Length::h; break;
+        case 'l': ++p; if (*p == 'l') { s.length = Length::ll; ++p; } else s.length = Length::l; break;
+        case 'z': ++p; s.length = Length::z; break;
+        case 'j': ++p; s.length = Length::j; break;
+        case 't': ++p; s.length = Length::t; break;
+        case 'L': ++p; s.length = Length::L; break;
+        default: break;
+        }
+
+        if (!*p)
+            return false;
+
+        s.conv = *p++;
+        s.end = p;
+        return true;
+    }
+
+    bool IsSigned(char c) { return c == 'd' || c == 'i'; }
+    bool IsUnsigned(char c) { return c == 'u' || c == 'o' || c == 'x' || c == 'X'; }
+    bool IsFloat(char c) { return std::strchr("fFeEgGaA", c) != nullptr; }
+
+    // -------------------------------------------------------------------------
+    // Capture (producer side)
+    // -------------------------------------------------------------------------
+    // False when the text does not fit what is left of the record.
+    bool CaptureString(Record& r, Arg& a, const char* s)
+    {
+        a.kind = ArgKind::String;
+        a.str = NO_TEXT;
+
+        if (!s)
+            s = "(null)";
+
+        const std::size_t n = std::strlen(s);
+        if (n >= TEXT_BYTES - r.textUsed)
+            return false;
+
+        std::memcpy(r.text + r.textUsed, s, n);
+        r.text[r.textUsed + n] = '\0';
+
+        a.str = r.textUsed;
+        r.textUsed = static_cast<std::uint16_t>(r.textUsed + n + 1);
+        return true;
+    }
+
+    void CaptureInt(Arg& a, Length len, bool isSigned, va_list& ap)
+    {
+        switch (len)
+        {
+        case Length::l:
+            if (isSigned) { a.kind = ArgKind::Long; a.i = va_arg(ap, long); }
+            else { a.kind = ArgKind::ULong; a.u = va_arg(ap, unsigned long); }
+            break;
+        case Length::ll:
+        case Length::j:
+            if (isSigned) { a.kind = ArgKind::LLong; a.i = va_arg(ap, long long); }
+            else { a.kind = ArgKind::ULLong; a.u = va_arg(ap, unsigned long long); }
+            break;
+        case Length::z:
+            a.kind = ArgKind::Size;
+            a.u = va_arg(ap, std::size_t);
+            break;
+        case Length::t:
+            a.kind = ArgKind::PtrDiff;
+            a.i = va_arg(ap, std::ptrdiff_t);
+            break;
+        default: // hh / h are promoted to int
+            if (isSigned) { a.kind = ArgKind::Int; a.i = va_arg(ap, int); }
+            else { a.kind = ArgKind::UInt; a.u = va_arg(ap, unsigned int); }
+            break;
+        }
+    }
+
+    // False when the arguments do not fit the record (more than MAX_ARGS,
+    // or %s text over TEXT_BYTES); the record is then incomplete.
+    bool Capture(Record& r, const char* fmt, va_list ap)
+    {
+        va_list args;
+        va_copy(args, ap);
+
+        bool fits = true;
+
+        for (const char* p = fmt; *p; ++p)
+        {
+            if (*p != '%')
+                continue;
+
+            Spec s;
+            if (!ParseSpec(p, s))
+                break;
+
+            p = s.end - 1;
+            if (s.conv == '%')
+                continue;
+
+            const int needed = (s.starWidth ? 1 : 0) + (s.starPrecision ? 1 : 0) + 1;
+            if (r.argCount + needed > MAX_ARGS)
+            {
+                fits = false;
+                break;
+            }
+
+            if (s.starWidth)
+                CaptureInt(r.args[r.argCount++], Length::None, true, args);
+            if (s.starPrecision)
+                CaptureInt(r.args[r.argCount++], Length::None, true, args);
+
+            Arg& a = r.args[r.argCount++];
+
+            if (s.conv == 's')
+            {
+                if (!CaptureString(r, a, va_arg(args, const char*)))
+                {
+                    fits = false;
+                    break;
+                }
+            }
+            else if (s.conv == 'c')
+                CaptureInt(a, Length::None, true, args);
+            else if (IsSigned(s.conv) || IsUnsigned(s.conv))
+                CaptureInt(a, s.length, IsSigned(s.conv), args);
+            else if (IsFloat(s.conv) && s.length == Length::L)
+            {
+                a.kind = ArgKind::LongDouble;
+                a.ld = va_arg(args, long double);
+            }
+            else if (IsFloat(s.conv))
+            {
+                a.kind = ArgKind::Double;
+                a.d = va_arg(args, double);
+            }
+            else if (s.conv == 'p' || s.conv == 'n')
+            {
+                a.kind = ArgKind::Pointer;
+                a.p = va_arg(args, const void*);
+            }
+            else
+            {
+                // Unknown conversion: its argument type is unknown too, so
+                // the rest of the message is printed as literal text
+                --r.argCount;
+                break;
+            }
+        }
+
+        va_end(args);
+        return fits;
+    }
+
+    // -------------------------------------------------------------------------
+    // Formatting (consumer side)
+    // -------------------------------------------------------------------------
+    int FormatArg(char* out, std::size_t room, const char* spec, const Record& r, const Arg& a)
+    {
+        switch (a.kind)
+        {
+        case ArgKind::Int:        return std::snprintf(out, room, spec, static_cast<int>(a.i));
+        case ArgKind::UInt:       return std::snprintf(out, room, spec, static_cast<unsigned int>(a.u));
+        case ArgKind::Long:       return std::snprintf(out, room, spec, static_cast<long>(a.i));
+        case ArgKind::ULong:      return std::snprintf(out, room, spec, static_cast<unsigned long>(a.u));
+        case ArgKind::LLong:      return std::snprintf(out, room, spec, a.i);
+        case ArgKind::ULLong:     return std::snprintf(out, room, spec, a.u);
+        case ArgKind::Size:       return std::snprintf(out, room, spec, static_cast<std::size_t>(a.u));
+        case ArgKind::PtrDiff:    return std::snprintf(out, room, spec, static_cast<std::ptrdiff_t>(a.i));
+        case ArgKind::Double:     return std::snprintf(out, room, spec, a.d);
+        case ArgKind::LongDouble: return std::snprintf(out, room, spec, a.ld);
+        case ArgKind::Pointer:    return std::snprintf(out, room, spec, a.p);
+        case ArgKind::String:
+            return std::snprintf(out, room, spec, a.str == NO_TEXT ? "" : r.text + a.str);
+        }
+        return 0;
+    }
+
+    // Rebuilds the message; returns its length (clamped to size - 1).
+    std::size_t FormatRecord(const Record& r, char* out, std::size_t size)
+    {
+        std::size_t n = 0;
+        int         next = 0;
+
+        auto room = [&]() { return size - n; };
+        auto advance = [&](int w)
+            {
+                if (w > 0)
+                    n += static_cast<std::size_t>(w) < room() ? static_cast<std::size_t>(w) : room() - 1;
+            };
+
+        if (r.prefix)
+            advance(std::snprintf(out, size, "%s", r.prefix));
+
+        for (const char* p = r.fmt; *p && room() > 1;)
+        {
+            if (*p != '%')
+            {
+                out[n++] = *p++;
+                continue;
+            }
+
+            Spec s;
+            if (!ParseSpec(p, s))
+                break;
+
+            p = s.end;
+
+            if (s.conv == '%')
+            {
+                out[n++] = '%';
+                continue;
+            }
+
+            const int needed = (s.starWidth ? 1 : 0) + (s.starPrecision ? 1 : 0) + 1;
+            if (s.conv == 'n' && next + needed <= r.argCount)
+            {
+                next += needed; // never written back
+                continue;
+            }
+
+            if (next + needed > r.argCount)
+            {
+                advance(std::snprintf(out + n, room(), "%.*s",
+                    static_cast<int>(s.end - s.begin), s.begin));
+                continue;
+            }
+
+            // Copy of the spec with '*' resolved and 'L' kept for long double
+            char spec[48];
+            std::size_t k = 0;
+
+            for (const char* q = s.begin; q < s.end && k + 12 < sizeof(spec); ++q)
+            {
+                if (*q == '*')
+                    k += static_cast<std::size_t>(std::snprintf(spec + k, sizeof(spec) - k, "%d",
+                        static_cast<int>(r.args[next++].i)));
+                else
+                    spec[k++] = *q;
+            }
+            spec[k] = '\0';
+
+            advance(FormatArg(out + n, room(), spec, r, r.args[next++]));
+        }
+
+        out[n] = '\0';
+        return n;
+    }
+
+    // -------------------------------------------------------------------------
+    // Ring + state
+    // -------------------------------------------------------------------------
+    Slot                     g_Ring[RING_SIZE];
+    std::atomic<std::size_t> g_Tail(0); // next ticket for producers
+    std::atomic<std::size_t> g_Head(0); // written by whoever holds g_Consuming
+
+    std::atomic<bool>          g_Consuming(false);
+    std::atomic<bool>          g_Async(true);
+    std::atomic<bool>          g_FlusherStarted(false);
+    std::atomic<bool>          g_ShuttingDown(false);
+    std::atomic<std::uint64_t> g_Queued(0);
+    std::atomic<std::uint64_t> g_Written(0);
+    std::atomic<std::uint64_t> g_Dropped(0);
+    std::atomic<std::uint64_t> g_Oversized(0);
+    std::uint64_t              g_DropsReported = 0;
+
+    // Flusher wake-up. Never destroyed: the detached flusher may still be
+    // waiting on them while statics are torn down at exit.
+    std::mutex&              g_WakeMutex = *new std::mutex;
+    std::condition_variable& g_Wake = *new std::condition_variable;
+    std::atomic<bool>        g_FlusherIdle(false);
+
+    // Sinks; only touched while holding g_Consuming
+    Logging::Config g_Config;
+    std::FILE*      g_File = nullptr;
+    std::size_t     g_FileBytes = 0;
+
+    struct RingInit
+    {
+        RingInit()
+        {
+            for (std::size_t i = 0; i < RING_SIZE; ++i)
+                g_Ring[i].seq.store(i, std::memory_order_relaxed);
+        }
+    } g_RingInit;
+
+    // -------------------------------------------------------------------------
+    // Sinks
+    // -------------------------------------------------------------------------
+    void CloseFile()
+    {
+        if (g_File)
+            std::fclose(g_File);
+
+        g_File = nullptr;
+        g_FileBytes = 0;
+    }
+
+    void WriteFile(const char* line, std::size_t len)
+    {
+        const std::string& path = g_Config.filePath;
+
+        if (!g_File)
+        {
+            g_File = OpenFile(path.c_str(), "ab");
+            if (!g_File)
+                return;
+
+            std::fseek(g_File, 0, SEEK_END);
+            const long pos = std::ftell(g_File);
+            g_FileBytes = pos > 0 ? static_cast<std::size_t>(pos) : 0;
+        }
+
+        if (g_FileBytes > 0 && g_FileBytes + len > g_Config.fileMaxBytes)
+        {
+            CloseFile();
+
+            const std::string old = path + ".1";
+            std::remove(old.c_str());
+            std::rename(path.c_str(), old.c_str());
+
+            g_File = OpenFile(path.c_str(), "wb");
+            if (!g_File)
+                return;
+        }
+
+        std::fwrite(line, 1, len, g_File);
+        g_FileBytes += len;
+    }
+
+    void WriteLine(const char* line, std::size_t len)
+    {
+        if (g_Config.debugOutput)
+            Platform::DebugOutput(line);
+        if (g_Config.stdoutSink)
+            std::fwrite(line, 1, len, stdout);
+        if (!g_Config.filePath.empty())
+            WriteFile(line, len);
+
+        g_Written.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // -------------------------------------------------------------------------
+    // Consumer
+    // -------------------------------------------------------------------------
+    bool TryBeginConsume()
+    {
+        bool expected = false;
+        return g_Consuming.compare_exchange_strong(expected, true, std::memory_order_acquire);
+    }
+
+    void EndConsume()
+    {
+        g_Consuming.store(false, std::memory_order_release);
+    }
+
+    // Drains everything published so far; caller holds g_Consuming.
+    std::size_t Drain()
+    {
+        char        line[1024];
+        std::size_t drained = 0;
+        std::size_t head = g_Head.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            Slot& slot = g_Ring[head & (RING_SIZE - 1)];
+            if (slot.seq.load(std::memory_order_acquire) != head + 1)
+                break;
+
+            const bool        queued = slot.rec.fmt != nullptr;
+            const std::size_t len = queued ? FormatRecord(slot.rec, line, sizeof(line)) : 0;
+
+            slot.seq.store(head + RING_SIZE, std::memory_order_release);
+            g_Head.store(++head, std::memory_order_release);
+            ++drained;
+
+            if (queued)
+                WriteLine(line, len);
+        }
+
+        const std::uint64_t dropped = g_Dropped.load(std::memory_order_relaxed);
+        if (dropped != g_DropsReported)
+        {
+            const int len = std::snprintf(line, sizeof(line),
+                "GP4MD Logging: %llu message(s) dropped, ring full\n",
+                static_cast<unsigned long long>(dropped - g_DropsReported));
+            g_DropsReported = dropped;
+
+            if (len > 0)
+                WriteLine(line, static_cast<std::size_t>(len));
+        }
+
+        if (drained && g_File)
+            std::fflush(g_File);
+        if (drained && g_Config.stdoutSink)
+            std::fflush(stdout);
+
+        return drained;
+    }
+
+    // Tickets are taken before a record is published, so this is also true
+    // while a producer is still capturing.
+    bool HasTickets()
+    {
+        return g_Head.load(std::memory_order_acquire) != g_Tail.load();
+    }
+
+    void FlusherMain()
+    {
+        for (;;)
+        {
+            std::size_t drained = 0;
+            if (TryBeginConsume())
+            {
+                drained = Drain();
+                EndConsume();
+            }
+
+            if (drained)
+                continue;
+
+            // The idle flag is raised before the tickets are checked, and
+            // producers test it after taking one (WakeFlusher), so either
+            // the flusher sees the ticket or the producer sees the flag.
+            std::unique_lock<std::mutex> lock(g_WakeMutex);
+            g_FlusherIdle.store(true);
+
+            if (HasTickets())
+            {
+                // A record still being captured, or another consumer draining
+                g_FlusherIdle.store(false);
+                lock.unlock();
+                std::this_thread::yield();
+                continue;
+            }
+
+            g_Wake.wait(lock, HasTickets);
+            g_FlusherIdle.store(false);
+        }
+    }
+
+    void WakeFlusher()
+    {
+        if (!g_FlusherIdle.load())
+            return;
+
+        std::lock_guard<std::mutex> lock(g_WakeMutex);
+        g_Wake.notify_one();
+    }
+
+    void FlushAtExit()
+    {
+        Logging::Flush();
+    }
+
+    void StartFlusher()
+    {
+        if (g_FlusherStarted.exchange(true))
+            return;
+
+        // Detached: at process exit Windows kills it before DLL detach, so
+        // the atexit flush drains whatever it left.
+        std::thread(FlusherMain).detach();
+        std::atexit(FlushAtExit);
+    }
+
+    enum class PushResult { Queued, Full, TooLarge };
+
+    // TooLarge: the arguments did not fit, and the slot was published
+    // empty so the caller can write the message itself.
+    PushResult Push(const char* prefix, const char* fmt, va_list ap)
+    {
+        std::size_t pos = g_Tail.load(std::memory_order_relaxed);
+        Slot*       slot = nullptr;
+
+        for (;;)
+        {
+            slot = &g_Ring[pos & (RING_SIZE - 1)];
+            const std::size_t seq = slot->seq.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff =
+                static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0)
+            {
+                // seq_cst: ordered against the flusher's idle flag
+                if (g_Tail.compare_exchange_weak(pos, pos + 1, std::memory_order_seq_cst,
+                    std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return PushResult::Full;
+            }
+            else
+            {
+                pos = g_Tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        Record& r = slot->rec;
+        r.prefix = prefix;
+        r.fmt = fmt;
+        r.argCount = 0;
+        r.textUsed = 0;
+
+        const bool fits = Capture(r, fmt, ap);
+        if (!fits)
+            r.fmt = nullptr;
+
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return fits ? PushResult::Queued : PushResult::TooLarge;
+    }
+
+    // Waits for the sinks, bounded: the flusher may have been killed
+    // mid-drain at exit. Caller ends with EndConsume.
+    bool BeginConsumeWait()
+    {
+        const double deadline = Platform::NowMs() + 200.0;
+
+        while (!TryBeginConsume())
+        {
+            if (Platform::NowMs() > deadline)
+                return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    // Formats on the caller's thread and writes after everything queued
+    // before it; for messages whose arguments do not fit a record.
+    bool WriteNow(const char* prefix, const char* fmt, va_list ap)
+    {
+        char line[1024];
+        int  n = std::snprintf(line, sizeof(line), "%s", prefix ? prefix : "");
+        if (n < 0)
+            n = 0;
+
+        const int body = std::vsnprintf(line + n, sizeof(line) - n, fmt, ap);
+        if (body > 0)
+            n += body;
+
+        const std::size_t len = static_cast<std::size_t>(n) < sizeof(line) ? n : sizeof(line) - 1;
+
+        if (!BeginConsumeWait())
+            return false;
+
+        Drain();
+        WriteLine(line, len);
+        if (g_File)
+            std::fflush(g_File);
+
+        EndConsume();
+        return true;
+    }
+}
+
+namespace Logging
+{
+    std::atomic<int> g_Level[CATEGORY_COUNT] = {
+        { GP4MD_LOG_LEVEL_DEBUG }, { GP4MD_LOG_LEVEL_DEBUG },
+        { GP4MD_LOG_LEVEL_DEBUG }, { GP4MD_LOG_LEVEL_DEBUG },
+    };
+
+    namespace
+    {
+        const char* const k_CategoryNames[CATEGORY_COUNT] = {
+            "MagicData", "RaceSettings", "GPxTrack", "IO",
+        };
+
+        const char* const k_Prefixes[CATEGORY_COUNT] = {
+            "GP4MD MagicData: ", "GP4MD RaceSettings: ", "GP4MD GPxTrack: ", "GP4MD IO: ",
+        };
+
+        const char* const k_LevelNames[] = { "off", "error", "info", "debug", "trace" };
+    }
+
+    void SetLevel(Category category, Level level)
+    {
+        g_Level[static_cast<int>(category)].store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+
+    void SetAllLevels(Level level)
+    {
+        for (int c = 0; c < CATEGORY_COUNT; ++c)
+            SetLevel(static_cast<Category>(c), level);
+    }
+
+    bool ParseLevel(const std::string& text, Level& out)
+    {
+        for (int l = GP4MD_LOG_LEVEL_OFF; l <= GP4MD_LOG_LEVEL_TRACE; ++l)
+        {
+            if (IniText::EqualsNoCase(text.c_str(), k_LevelNames[l]))
+            {
+                out = static_cast<Level>(l);
+                return true;
+            }
+        }
+
+        int n = 0;
+        if (!IniText::ParseInt(text, n) || n < GP4MD_LOG_LEVEL_OFF || n > GP4MD_LOG_LEVEL_TRACE)
+            return false;
+
+        out = static_cast<Level>(n);
+        return true;
+    }
+
+    const char* CategoryName(Category category)
+    {
+        return k_CategoryNames[static_cast<int>(category)];
+    }
+
+    void Configure(const Config& config)
+    {
+        Flush();
+
+        while (!TryBeginConsume())
+            std::this_thread::yield();
+
+        if (g_Config.filePath != config.filePath)
+            CloseFile();
+
+        g_Config = config;
+        g_Async = config.async;
+
+        EndConsume();
+    }
+
+    void Flush()
+    {
+        if (!BeginConsumeWait())
+            return;
+
+        Drain();
+        EndConsume();
+    }
+
+    Stats GetStats()
+    {
+        Stats s;
+        s.queued = g_Queued.load();
+        s.written = g_Written.load();
+        s.dropped = g_Dropped.load();
+        s.oversized = g_Oversized.load();
+        return s;
+    }
+
+    void BeginShutdown()
+    {
+        g_ShuttingDown = true;
+    }
+
+    void Enqueue(const char* prefix, const char* fmt, va_list ap)
+    {
+        // No flusher is started or woken from here on; each message is
+        // written by its caller after whatever is still queued
+        if (g_ShuttingDown.load(std::memory_order_relaxed))
+        {
+            g_Queued.fetch_add(1, std::memory_order_relaxed);
+            if (!WriteNow(prefix, fmt, ap))
+                g_Dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const PushResult pushed = Push(prefix, fmt, ap);
+
+        if (pushed == PushResult::Full)
+        {
+            g_Dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        g_Queued.fetch_add(1, std::memory_order_relaxed);
+
+        if (pushed == PushResult::TooLarge)
+        {
+            g_Oversized.fetch_add(1, std::memory_order_relaxed);
+            if (!WriteNow(prefix, fmt, ap))
+                g_Dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        if (g_Async.load(std::memory_order_relaxed))
+        {
+            StartFlusher();
+            WakeFlusher();
+        }
+        else
+            Flush();
+    }
+
+    void Write(Category category, const char* fmt, ...)
+    {
+        va_list ap;
+        va_start(ap, fmt);
+        Enqueue(k_Prefixes[static_cast<int>(category)], fmt, ap);
+        va_end(ap);
+    }
+}
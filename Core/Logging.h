@@ -1,43 +1,134 @@
 #pragma once
-#include <windows.h>
+#include <atomic>
 #include <cstdarg>
-#include <cstdio>
-#include "../MagicData/MagicData.h"
+#include <cstdint>
+#include <string>
+
+// Log calls only capture their arguments into a lock-free ring; a background
+// flusher formats them and feeds the sinks. The format string and prefix
+// must be string literals (only their pointers are kept); %s arguments are
+// copied at the call. A message whose arguments do not fit a ring record
+// (more than 12, or over 160 bytes of %s text) is formatted and written by
+// the caller instead.
+//
+// Call sites use the GP4MD_LOG_<LEVEL>(Category, fmt, ...) macros below:
+// levels above GP4MD_LOG_MAX_LEVEL compile to nothing, and the per-category
+// runtime level is checked before any argument is evaluated.
+
+#define GP4MD_LOG_LEVEL_OFF   0
+#define GP4MD_LOG_LEVEL_ERROR 1
+#define GP4MD_LOG_LEVEL_INFO  2
+#define GP4MD_LOG_LEVEL_DEBUG 3
+#define GP4MD_LOG_LEVEL_TRACE 4
+
+// Build-time ceiling; override with /D GP4MD_LOG_MAX_LEVEL=<n>.
+#ifndef GP4MD_LOG_MAX_LEVEL
+#if defined(_DEBUG)
+#define GP4MD_LOG_MAX_LEVEL GP4MD_LOG_LEVEL_TRACE
+#else
+#define GP4MD_LOG_MAX_LEVEL GP4MD_LOG_LEVEL_DEBUG
+#endif
+#endif
 
 namespace Logging
 {
-    inline void LogV(const char* prefix, const char* fmt, va_list ap)
+    enum class Level : int
     {
-        if (!MagicData::g_EnableLogging)
-            return;
+        Off = GP4MD_LOG_LEVEL_OFF,
+        Error = GP4MD_LOG_LEVEL_ERROR,
+        Info = GP4MD_LOG_LEVEL_INFO,
+        Debug = GP4MD_LOG_LEVEL_DEBUG,
+        Trace = GP4MD_LOG_LEVEL_TRACE,
+    };
 
-        char buf[512];
+    enum class Category : int
+    {
+        MagicData,
+        RaceSettings,
+        GPxTrack,
+        IO,
+    };
 
-        int written = 0;
-        if (prefix && *prefix)
-        {
-            written = std::snprintf(buf, sizeof(buf), "%s", prefix);
-            if (written < 0 || static_cast<std::size_t>(written) >= sizeof(buf))
-                return;
-        }
+    constexpr int CATEGORY_COUNT = 4;
 
-        std::vsnprintf(buf + written, sizeof(buf) - written, fmt, ap);
-        OutputDebugStringA(buf);
-    }
+    struct Config
+    {
+        bool        async = true;        // false: the caller flushes its own message
+        bool        debugOutput = true;  // Platform::DebugOutput (OutputDebugStringA)
+        bool        stdoutSink = false;
+        std::string filePath;            // empty: no file
+        std::size_t fileMaxBytes = 1u << 20; // rotate to <file>.1 past this size
+    };
 
-    inline void LogMD(const char* fmt, ...)
+    struct Stats
     {
-        va_list ap;
-        va_start(ap, fmt);
-        LogV("GP4MD MagicData: ", fmt, ap);
-        va_end(ap);
-    }
+        std::uint64_t queued = 0;
+        std::uint64_t written = 0;
+        std::uint64_t dropped = 0;   // ring was full
+        std::uint64_t oversized = 0; // written by the caller, see above
+    };
+
+    void  Configure(const Config& config);
+    void  Flush();
+    Stats GetStats();
+
+    // DLL detach: from here on every message is formatted and written by
+    // its caller, and the flusher thread is never started (not under the
+    // loader lock).
+    void BeginShutdown();
+
+    // Runtime level per category; Debug until configured.
+    extern std::atomic<int> g_Level[CATEGORY_COUNT];
 
-    inline void LogRS(const char* fmt, ...)
+    inline bool Enabled(Category category, Level level)
     {
-        va_list ap;
-        va_start(ap, fmt);
-        LogV("GP4MD RaceSettings: ", fmt, ap);
-        va_end(ap);
+        return static_cast<int>(level) <=
+            g_Level[static_cast<int>(category)].load(std::memory_order_relaxed);
     }
+
+    void SetLevel(Category category, Level level);
+    void SetAllLevels(Level level);
+
+    // "off", "error", "info", "debug", "trace" (any case) or 0-4.
+    bool ParseLevel(const std::string& text, Level& out);
+
+    // "MagicData", "RaceSettings", "GPxTrack", "IO"
+    const char* CategoryName(Category category);
+
+    // Captures fmt's arguments from ap into the ring.
+    void Enqueue(const char* prefix, const char* fmt, va_list ap);
+
+    // Enqueues with the category's prefix; use the macros, which filter first.
+    void Write(Category category, const char* fmt, ...);
 }
+
+#define GP4MD_LOG(category, level, ...)                                                   \
+    do                                                                                    \
+    {                                                                                     \
+        if (::Logging::Enabled(::Logging::Category::category, ::Logging::Level::level))  \
+            ::Logging::Write(::Logging::Category::category, __VA_ARGS__);                 \
+    } while (0)
+
+#if GP4MD_LOG_MAX_LEVEL >= GP4MD_LOG_LEVEL_ERROR
+#define GP4MD_LOG_ERROR(category, ...) GP4MD_LOG(category, Error, __VA_ARGS__)
+#else
+#define GP4MD_LOG_ERROR(category, ...) ((void)0)
+#endif
+
+#if GP4MD_LOG_MAX_LEVEL >= GP4MD_LOG_LEVEL_INFO
+#define GP4MD_LOG_INFO(category, ...) GP4MD_LOG(category, Info, __VA_ARGS__)
+#else
+#define GP4MD_LOG_INFO(category, ...) ((void)0)
+#endif
+
+#if GP4MD_LOG_MAX_LEVEL >= GP4MD_LOG_LEVEL_DEBUG
+#define GP4MD_LOG_DEBUG(category, ...) GP4MD_LOG(category, Debug, __VA_ARGS__)
+#else
+#define GP4MD_LOG_DEBUG(category, ...) ((void)0)
+#endif
+
+#if GP4MD_LOG_MAX_LEVEL >= GP4MD_LOG_LEVEL_TRACE
+#define GP4MD_LOG_TRACE(category, ...) GP4MD_LOG(category, Trace, __VA_ARGS__)
+#else
+#define GP4MD_LOG_TRACE(category, ...) ((void)0)
+#endif
@@ -0,0 +1,163 @@
+#include "Patch.h"
+#include "Platform.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr std::uintptr_t PAGE_SIZE = 0x1000;
+
+    std::uint32_t Mask(std::uint8_t width)
+    {
+        return width >= 4 ? 0xFFFFFFFFu : ((1u << (width * 8)) - 1u);
+    }
+
+    // Little-endian bytes of a record that fall inside [begin, end)
+    void ApplyChange(const Patch::Change& c, std::uint32_t begin, std::uint32_t end,
+        std::uint8_t* image)
+    {
+        for (std::uint32_t i = 0; i < c.width; ++i)
+        {
+            const std::uint32_t at = c.offset + i;
+            if (at >= begin && at < end)
+                image[at - begin] = static_cast<std::uint8_t>(c.newValue >> (i * 8));
+        }
+    }
+
+    std::uintptr_t PageOf(const std::uint8_t* p)
+    {
+        return reinterpret_cast<std::uintptr_t>(p) / PAGE_SIZE;
+    }
+}
+
+namespace Patch
+{
+    Transaction::Transaction(std::uint8_t* base, std::size_t size)
+        : m_Base(base)
+        , m_Size(size)
+    {
+    }
+
+    std::uint32_t Transaction::Read(std::uint32_t offset, std::uint8_t width) const
+    {
+        if (width == 0 || width > 4 || offset + width > m_Size)
+            return 0;
+
+        std::uint8_t bytes[4] = {};
+        std::memcpy(bytes, m_Base + offset, width);
+
+        for (const Change& c : m_Changes)
+        {
+            if (c.offset < offset + width && offset < c.offset + c.width)
+                ApplyChange(c, offset, offset + width, bytes);
+        }
+
+        return static_cast<std::uint32_t>(bytes[0]) |
+            (static_cast<std::uint32_t>(bytes[1]) << 8) |
+            (static_cast<std::uint32_t>(bytes[2]) << 16) |
+            (static_cast<std::uint32_t>(bytes[3]) << 24);
+    }
+
+    bool Transaction::Stage(std::uint32_t offset, std::uint8_t width, std::uint32_t value,
+        std::uint32_t* oldValue)
+    {
+        if (width == 0 || width > 4 || offset + width > m_Size)
+            return false;
+
+        value &= Mask(width);
+
+        const std::uint32_t current = Read(offset, width);
+        if (oldValue)
+            *oldValue = current;
+
+        if (current == value)
+            return false;
+
+        // Same field edited again: update in place so Changes() stays one
+        // record per field and the first old value is kept.
+        for (Change& c : m_Changes)
+        {
+            if (c.offset == offset && c.width == width)
+            {
+                c.newValue = value;
+                c.source = m_Source;
+                return true;
+            }
+        }
+
+        Change c;
+        c.offset = offset;
+        c.width = width;
+        c.oldValue = current;
+        c.newValue = value;
+        c.source = m_Source;
+        m_Changes.push_back(c);
+        return true;
+    }
+
+    std::size_t Transaction::Commit(CommitMode mode)
+    {
+        if (m_Changes.empty())
+            return 0;
+
+        // Sort by offset, then group into runs. Records apply in staging
+        // order inside a run, so overlapping edits resolve as they were made.
+        std::vector<std::size_t> order(m_Changes.size());
+        for (std::size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+
+        std::stable_sort(order.begin(), order.end(),
+            [this](std::size_t a, std::size_t b)
+            {
+                return m_Changes[a].offset < m_Changes[b].offset;
+            });
+
+        std::vector<std::uint8_t> image;
+        std::size_t               runs = 0;
+        std::size_t               i = 0;
+
+        while (i < order.size())
+        {
+            const std::uint32_t begin = m_Changes[order[i]].offset;
+            std::uint32_t       end = begin + m_Changes[order[i]].width;
+            std::size_t         j = i + 1;
+
+            for (; j < order.size(); ++j)
+            {
+                const Change& c = m_Changes[order[j]];
+
+                // Plain stores only join touching records; protected writes
+                // also join records that share a page, filling the gap with
+                // the current bytes, so each page is unprotected once.
+                const bool joins = mode == CommitMode::Plain
+                    ? c.offset <= end
+                    : PageOf(m_Base + c.offset) <= PageOf(m_Base + end - 1);
+
+                if (!joins)
+                    break;
+
+                end = std::max(end, c.offset + c.width);
+            }
+
+            image.assign(m_Base + begin, m_Base + end);
+
+            std::vector<std::size_t> members(order.begin() + i, order.begin() + j);
+            std::sort(members.begin(), members.end());
+
+            for (std::size_t m : members)
+                ApplyChange(m_Changes[m], begin, end, image.data());
+
+            if (mode == CommitMode::Plain)
+                std::memcpy(m_Base + begin, image.data(), image.size());
+            else
+                Platform::PatchBytes(m_Base + begin, image.data(), image.size());
+
+            m_Written += image.size();
+            ++runs;
+            i = j;
+        }
+
+        m_Changes.clear();
+        return runs;
+    }
+}
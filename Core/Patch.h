@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Staged memory edits. Fields are recorded as (offset, width, value) against
+// one base pointer and written in a single commit: adjacent and overlapping
+// records are coalesced into runs, so our own memory gets one memcpy per run
+// and protected game memory one Platform::PatchBytes (one protection change)
+// per group of touched pages.
+namespace Patch
+{
+    struct Change
+    {
+        std::uint32_t offset = 0;
+        std::uint8_t  width = 0;    // 1, 2 or 4
+        std::uint32_t oldValue = 0; // value before the first edit of this field
+        std::uint32_t newValue = 0;
+        std::uint8_t  source = 0;   // caller's tag of the last edit (SetSource)
+    };
+
+    enum class CommitMode
+    {
+        Plain,     // memory we own (arena, scratch): direct stores
+        Protected  // game memory: Platform::PatchBytes per page group
+    };
+
+    class Transaction
+    {
+    public:
+        Transaction(std::uint8_t* base, std::size_t size);
+
+        // Current value of a field, staged edits included.
+        std::uint32_t Read(std::uint32_t offset, std::uint8_t width) const;
+
+        // Tag stored with the following edits, e.g. the layer they come from.
+        void SetSource(std::uint8_t source) { m_Source = source; }
+
+        // Records value for the field; false (nothing staged) if it already
+        // holds that value. oldValue receives the value it replaces.
+        bool Stage(std::uint32_t offset, std::uint8_t width, std::uint32_t value,
+            std::uint32_t* oldValue = nullptr);
+
+        // Staged edits in staging order; a re-staged field keeps its slot.
+        const std::vector<Change>& Changes() const { return m_Changes; }
+
+        // Writes all staged edits and clears them; returns the number of runs.
+        std::size_t Commit(CommitMode mode);
+
+        void Clear() { m_Changes.clear(); }
+
+        std::uint8_t* Base() const { return m_Base; }
+
+        // Bytes written by all commits so far (runs, gap bytes included).
+        std::size_t BytesWritten() const { return m_Written; }
+
+    private:
+        std::uint8_t*       m_Base;
+        std::size_t         m_Size;
+        std::vector<Change> m_Changes;
+        std::uint8_t        m_Source = 0;
+        std::size_t         m_Written = 0;
+    };
+}
@@ -0,0 +1,415 @@
+#include "Platform.h"
+#include "FileIO.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#include "../GP4MemLib/GP4MemLib.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <poll.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#endif
+
+namespace
+{
+#ifdef _WIN32
+    std::string FolderOf(const std::string& full)
+    {
+        const std::size_t pos = full.find_last_of("\\/");
+        if (pos == std::string::npos)
+            return {};
+
+        return full.substr(0, pos + 1);
+    }
+
+    std::uint8_t* DefaultAddressToPtr(std::uint32_t addr)
+    {
+        return GP4MemLib::MemUtils::addressToPtr<std::uint8_t>(addr);
+    }
+
+    std::string DefaultModuleFolder()
+    {
+        char path[MAX_PATH]{};
+        HMODULE hMod = nullptr;
+        GetModuleHandleExA(
+            GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS |
+            GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+            reinterpret_cast<LPCSTR>(&DefaultModuleFolder),
+            &hMod
+        );
+        GetModuleFileNameA(hMod, path, MAX_PATH);
+        return FolderOf(path);
+    }
+
+    std::string DefaultGameFolder()
+    {
+        char path[MAX_PATH]{};
+        HMODULE hExe = GetModuleHandleA(nullptr);
+        if (!hExe)
+            return {};
+
+        GetModuleFileNameA(hExe, path, MAX_PATH);
+        return FolderOf(path);
+    }
+
+    void DefaultPatchBytes(void* dst, const void* src, std::size_t size)
+    {
+        DWORD oldProt{};
+        if (!VirtualProtect(dst, size, PAGE_EXECUTE_READWRITE, &oldProt))
+            return;
+
+        std::memcpy(dst, src, size);
+
+        DWORD dummy{};
+        VirtualProtect(dst, size, oldProt, &dummy);
+    }
+
+    void DefaultDebugOutput(const char* text)
+    {
+        OutputDebugStringA(text);
+    }
+
+    // Link timestamp + image size from the PE header of GP4MD.dll itself
+    std::uint64_t DefaultModuleBuildId()
+    {
+        HMODULE hMod = nullptr;
+        if (!GetModuleHandleExA(
+            GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS |
+            GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+            reinterpret_cast<LPCSTR>(&DefaultModuleBuildId),
+            &hMod
+        ))
+            return 0;
+
+        const auto* base = reinterpret_cast<const std::uint8_t*>(hMod);
+        const auto* dos = reinterpret_cast<const IMAGE_DOS_HEADER*>(base);
+        if (dos->e_magic != IMAGE_DOS_SIGNATURE)
+            return 0;
+
+        const auto* nt = reinterpret_cast<const IMAGE_NT_HEADERS*>(base + dos->e_lfanew);
+        if (nt->Signature != IMAGE_NT_SIGNATURE)
+            return 0;
+
+        return (static_cast<std::uint64_t>(nt->FileHeader.TimeDateStamp) << 32) |
+            nt->OptionalHeader.SizeOfImage;
+    }
+#else
+    // Outside Windows there is no GP4 process; a simulator must be installed.
+    std::uint8_t* DefaultAddressToPtr(std::uint32_t)
+    {
+        return nullptr;
+    }
+
+    std::string FolderFromEnv(const char* name)
+    {
+        const char* v = std::getenv(name);
+        if (!v || !*v)
+            return "./";
+
+        std::string folder(v);
+        if (folder.back() != '/')
+            folder += '/';
+        return folder;
+    }
+
+    std::string DefaultModuleFolder()
+    {
+        return FolderFromEnv("GP4MD_DIR");
+    }
+
+    std::string DefaultGameFolder()
+    {
+        return FolderFromEnv("GP4_ROOT");
+    }
+
+    void DefaultPatchBytes(void* dst, const void* src, std::size_t size)
+    {
+        std::memcpy(dst, src, size);
+    }
+
+    void DefaultDebugOutput(const char* text)
+    {
+        std::fputs(text, stderr);
+    }
+
+    // Size + mtime of the running executable
+    std::uint64_t DefaultModuleBuildId()
+    {
+        std::uint64_t size = 0;
+        std::uint64_t mtime = 0;
+        if (!Platform::StatFile("/proc/self/exe", size, mtime))
+            return 0;
+
+        return (mtime << 20) ^ size;
+    }
+#endif
+
+    Platform::Providers g_Providers = Platform::DefaultProviders();
+}
+
+namespace Platform
+{
+    Providers DefaultProviders()
+    {
+        Providers p;
+        p.addressToPtr = &DefaultAddressToPtr;
+        p.moduleFolder = &DefaultModuleFolder;
+        p.gameFolder = &DefaultGameFolder;
+        p.patchBytes = &DefaultPatchBytes;
+        p.debugOutput = &DefaultDebugOutput;
+        p.moduleBuildId = &DefaultModuleBuildId;
+        return p;
+    }
+
+    void SetProviders(const Providers& providers)
+    {
+        const Providers d = DefaultProviders();
+
+        g_Providers.addressToPtr = providers.addressToPtr ? providers.addressToPtr : d.addressToPtr;
+        g_Providers.moduleFolder = providers.moduleFolder ? providers.moduleFolder : d.moduleFolder;
+        g_Providers.gameFolder = providers.gameFolder ? providers.gameFolder : d.gameFolder;
+        g_Providers.patchBytes = providers.patchBytes ? providers.patchBytes : d.patchBytes;
+        g_Providers.debugOutput = providers.debugOutput ? providers.debugOutput : d.debugOutput;
+        g_Providers.moduleBuildId = providers.moduleBuildId ? providers.moduleBuildId : d.moduleBuildId;
+    }
+
+    const Providers& Current()
+    {
+        return g_Providers;
+    }
+
+    void* AllocPages(std::size_t size)
+    {
+#ifdef _WIN32
+        return VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return p == MAP_FAILED ? nullptr : p;
+#endif
+    }
+
+    void FreePages(void* p, std::size_t size)
+    {
+        if (!p)
+            return;
+#ifdef _WIN32
+        (void)size;
+        VirtualFree(p, 0, MEM_RELEASE);
+#else
+        munmap(p, size);
+#endif
+    }
+
+    double NowMs()
+    {
+        using namespace std::chrono;
+        return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool StatFile(const std::string& path, std::uint64_t& size, std::uint64_t& mtime)
+    {
+        size = 0;
+        mtime = 0;
+
+#ifdef _WIN32
+        WIN32_FILE_ATTRIBUTE_DATA fa{};
+        if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &fa))
+            return false;
+
+        size = (static_cast<std::uint64_t>(fa.nFileSizeHigh) << 32) | fa.nFileSizeLow;
+        mtime = (static_cast<std::uint64_t>(fa.ftLastWriteTime.dwHighDateTime) << 32) |
+            fa.ftLastWriteTime.dwLowDateTime;
+        return true;
+#else
+        struct stat st{};
+        if (stat(path.c_str(), &st) != 0)
+            return false;
+
+        size = static_cast<std::uint64_t>(st.st_size);
+        mtime = static_cast<std::uint64_t>(st.st_mtim.tv_sec) * 1000000000ull +
+            static_cast<std::uint64_t>(st.st_mtim.tv_nsec);
+        return true;
+#endif
+    }
+
+    bool ReadWholeFile(const std::string& path, std::string& out)
+    {
+        out.clear();
+
+        std::FILE* f = OpenFileRead(path.c_str());
+        if (!f)
+            return false;
+
+        char buf[4096];
+        std::size_t n = 0;
+        while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0)
+            out.append(buf, n);
+
+        std::fclose(f);
+        return true;
+    }
+
+    bool MapFileRead(const std::string& path, MappedFile& out)
+    {
+        out = MappedFile{};
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+            nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view)
+        {
+            if (mapping)
+                CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        out.data = static_cast<const std::uint8_t*>(view);
+        out.size = static_cast<std::size_t>(size.QuadPart);
+        out.file = file;
+        out.mapping = mapping;
+        return true;
+#else
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+            close(fd);
+            return false;
+        }
+
+        void* view = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (view == MAP_FAILED)
+            return false;
+
+        out.data = static_cast<const std::uint8_t*>(view);
+        out.size = static_cast<std::size_t>(st.st_size);
+        return true;
+#endif
+    }
+
+    void UnmapFile(MappedFile& f)
+    {
+#ifdef _WIN32
+        if (f.data)
+            UnmapViewOfFile(f.data);
+        if (f.mapping)
+            CloseHandle(static_cast<HANDLE>(f.mapping));
+        if (f.file)
+            CloseHandle(static_cast<HANDLE>(f.file));
+#else
+        if (f.data)
+            munmap(const_cast<std::uint8_t*>(f.data), f.size);
+#endif
+        f = MappedFile{};
+    }
+
+    void SleepMs(unsigned ms)
+    {
+#ifdef _WIN32
+        Sleep(ms);
+#else
+        usleep(static_cast<useconds_t>(ms) * 1000);
+#endif
+    }
+
+    bool WatchFolder(const std::string& folder, FolderWatch& out)
+    {
+        out = FolderWatch{};
+
+#ifdef _WIN32
+        HANDLE h = FindFirstChangeNotificationA(folder.c_str(), FALSE,
+            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE |
+            FILE_NOTIFY_CHANGE_LAST_WRITE);
+        if (h == INVALID_HANDLE_VALUE)
+            return false;
+
+        out.handle = h;
+        return true;
+#elif defined(__linux__)
+        const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0)
+            return false;
+
+        if (inotify_add_watch(fd, folder.c_str(),
+            IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE | IN_DELETE) < 0)
+        {
+            close(fd);
+            return false;
+        }
+
+        out.fd = fd;
+        return true;
+#else
+        (void)folder;
+        return false;
+#endif
+    }
+
+    bool WaitFolderChange(FolderWatch& w, unsigned timeoutMs)
+    {
+#ifdef _WIN32
+        if (!w.handle)
+            return false;
+
+        if (WaitForSingleObject(static_cast<HANDLE>(w.handle), timeoutMs) != WAIT_OBJECT_0)
+            return false;
+
+        FindNextChangeNotification(static_cast<HANDLE>(w.handle));
+        return true;
+#else
+        if (w.fd < 0)
+            return false;
+
+        pollfd pfd{};
+        pfd.fd = w.fd;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, static_cast<int>(timeoutMs)) <= 0)
+            return false;
+
+        // Drain the queued events; callers re-stat the files they care about
+        char buf[4096];
+        while (read(w.fd, buf, sizeof(buf)) > 0)
+        {
+        }
+        return true;
+#endif
+    }
+
+    void CloseFolderWatch(FolderWatch& w)
+    {
+#ifdef _WIN32
+        if (w.handle)
+            FindCloseChangeNotification(static_cast<HANDLE>(w.handle));
+#else
+        if (w.fd >= 0)
+            close(w.fd);
+#endif
+        w = FolderWatch{};
+    }
+}
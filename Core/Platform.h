@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Everything the MagicData / RaceSettings core needs from the host process.
+// The defaults talk to the real GP4 process (Win32) or the local filesystem
+// (other platforms); Sim/GP4Sim swaps them for a simulated memory image so
+// the core can run headless.
+namespace Platform
+{
+    struct Providers
+    {
+        // GP4.exe absolute address -> pointer in this process
+        std::uint8_t* (*addressToPtr)(std::uint32_t addr) = nullptr;
+
+        // Folder holding GP4MD.dll and its INIs (with trailing separator)
+        std::string (*moduleFolder)() = nullptr;
+
+        // GP4 root folder, parent of Circuits (with trailing separator)
+        std::string (*gameFolder)() = nullptr;
+
+        // Write into game memory that may be write-protected
+        void (*patchBytes)(void* dst, const void* src, std::size_t size) = nullptr;
+
+        // Log sink for a fully formatted line
+        void (*debugOutput)(const char* text) = nullptr;
+
+        // Identity of the loaded GP4MD build; changes whenever the module is
+        // relinked (keys the startup snapshot)
+        std::uint64_t (*moduleBuildId)() = nullptr;
+    };
+
+    Providers DefaultProviders();
+
+    // Null members fall back to the defaults.
+    void SetProviders(const Providers& providers);
+    const Providers& Current();
+
+    inline std::uint8_t* AddressToPtr(std::uint32_t addr) { return Current().addressToPtr(addr); }
+    inline std::string   ModuleFolder() { return Current().moduleFolder(); }
+    inline std::string   GameFolder() { return Current().gameFolder(); }
+    inline void          DebugOutput(const char* text) { Current().debugOutput(text); }
+    inline std::uint64_t ModuleBuildId() { return Current().moduleBuildId(); }
+
+    inline void PatchBytes(void* dst, const void* src, std::size_t size)
+    {
+        Current().patchBytes(dst, src, size);
+    }
+
+    // OS services (not injectable)
+    void* AllocPages(std::size_t size);
+    void  FreePages(void* p, std::size_t size);
+
+    double NowMs();
+
+    // Size and last-write time (opaque units) of a file; false if missing.
+    bool StatFile(const std::string& path, std::uint64_t& size, std::uint64_t& mtime);
+
+    // Reads a whole file into out; false if missing or unreadable.
+    bool ReadWholeFile(const std::string& path, std::string& out);
+
+    struct MappedFile
+    {
+        const std::uint8_t* data = nullptr;
+        std::size_t         size = 0;
+        void*               file = nullptr;
+        void*               mapping = nullptr;
+    };
+
+    bool MapFileRead(const std::string& path, MappedFile& out);
+    void UnmapFile(MappedFile& f);
+
+    void SleepMs(unsigned ms);
+
+    // Change notifications for one folder (not recursive): directory change
+    // notifications on Windows, inotify on Linux. Elsewhere WatchFolder fails
+    // and callers fall back to polling.
+    struct FolderWatch
+    {
+        void* handle = nullptr;
+        int   fd = -1;
+    };
+
+    bool WatchFolder(const std::string& folder, FolderWatch& out);
+
+    // True when something in the folder changed within timeoutMs.
+    bool WaitFolderChange(FolderWatch& w, unsigned timeoutMs);
+    void CloseFolderWatch(FolderWatch& w);
+}
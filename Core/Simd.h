@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+
+// SSE2 is the baseline on every x86 build; AVX2 functions are compiled with
+// GP4MD_TARGET_AVX2 and only called after a run-time CPU check.
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define GP4MD_HAS_SSE2 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#define GP4MD_TARGET_AVX2
+#else
+#define GP4MD_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Simd
+{
+    // Index of the lowest set bit; mask must not be 0.
+    inline unsigned LowestBit(std::uint32_t mask)
+    {
+#ifdef _MSC_VER
+        unsigned long idx = 0;
+        _BitScanForward(&idx, mask);
+        return static_cast<unsigned>(idx);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+}
@@ -2,28 +2,55 @@
 #include <string>
 
 #include "MagicData/MagicData.h"
+#include "MagicData/MagicData_Reload.h"
+#include "MagicData/MagicData_Hooks.h"
 #include "GPxTrack/GPxTrack.h"
 #include "RaceSettings/RaceSettings.h"
-#include "IniLib/IniLib.h"
 #include "Core/Logging.h"
+#include "Core/Platform.h"
+
+namespace
+{
+    double g_AttachMs = 0.0;
+}
 
 DWORD WINAPI MainThread(LPVOID)
 {
-    // Wait until gpxtrack.gxm is loaded
-    HMODULE hGPx = nullptr;
-    while (!(hGPx = GetModuleHandleA("gpxtrack.gxm")))
-        Sleep(100);
+    // See gpxtrack.gxm load as it happens rather than on the next poll
+    GPxTrack::WatchModuleLoad();
 
-    // Optional: small delay to ensure module initialization
-    Sleep(200);
+    // Read everything that does not need GP4's memory while GP4 is still
+    // loading: GP4MD.ini, RaceSettings, pack, .dat files and Track INIs
+    if (!MagicData::PrepareInputs())
+        GP4MD_LOG_ERROR(MagicData, "PrepareInputs failed\n");
+
+    const double inputsMs = Platform::NowMs();
+
+    // Wait until gpxtrack.gxm is loaded and initialized
+    double loadMs = 0.0;
+    GPxTrack::WaitForModule(loadMs);
+    const double readyMs = Platform::NowMs();
 
     // Patch MagicData first
     if (!MagicData::PatchAllTracks())
-        Logging::LogMD("PatchAllTracks failed\n");
+        GP4MD_LOG_ERROR(MagicData, "PatchAllTracks failed\n");
+
+    const double patchedMs = Platform::NowMs();
 
     // Install GPxTrack hooks
     GPxTrack::InstallMagicHooks();
 
+    const double hookedMs = Platform::NowMs();
+
+    // Milliseconds after DLL attach
+    GP4MD_LOG_INFO(MagicData, "Startup: inputs %.3f, module loaded %.3f, ready %.3f, patched %.3f, "
+        "hooked %.3f ms; module load -> hooks installed %.3f ms\n",
+        inputsMs - g_AttachMs, loadMs - g_AttachMs, readyMs - g_AttachMs,
+        patchedMs - g_AttachMs, hookedMs - g_AttachMs, hookedMs - loadMs);
+
+    // Optional: rebuild tracks when their INIs change ([General] HotReload=1)
+    MagicData::StartHotReload();
+
     return 0;
 }
 
@@ -32,10 +59,22 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD reason, LPVOID)
     if (reason == DLL_PROCESS_ATTACH)
     {
         DisableThreadLibraryCalls(hModule);
+        g_AttachMs = Platform::NowMs();
 
         HANDLE hThread = CreateThread(nullptr, 0, MainThread, nullptr, 0, nullptr);
         if (hThread)
             CloseHandle(hThread); // avoid handle leak
     }
+    else if (reason == DLL_PROCESS_DETACH)
+    {
+        // Loader lock held: no thread is joined or started from here
+        Logging::BeginShutdown();
+        MagicData::SignalHotReloadStop();
+
+        // How often GP4 went through each hook this session
+        MagicData::Hooks::LogStats();
+        MagicData::CheckArena();
+        Logging::Flush();
+    }
     return TRUE;
 }
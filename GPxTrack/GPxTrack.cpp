@@ -1,9 +1,10 @@
 #include "GPxTrack.h"
+#include <cstring>
 #include "../MagicData/MagicData.h"
+#include "../MagicData/MagicData_Hooks.h"
 #include "../Core/Logging.h"
 #include "../Core/GP4Addresses.h"
-
-static const int kMagicBlockLayoutSize = sizeof(MagicData::MagicBlockLayout);
+#include "../Core/Platform.h"
 
 namespace GPxTrack
 {
@@ -17,40 +18,156 @@ namespace GPxTrack
     // staging pointer is ALSO inside gpxtrack.gxm → now resolved dynamically
     std::uint32_t* g_pMagicGlobal = nullptr;
 
-    GPxOverrideEntry g_GPxOverride[MagicData::TRACK_COUNT] = {};
+    GPxOverrideEntry g_GPxOverride[MagicData::MAX_TRACK_COUNT] = {};
 }
 
 // -----------------------------------------------------------------------------
-// Track index resolver
+// Module load notification (ntdll LdrRegisterDllNotification)
 // -----------------------------------------------------------------------------
 namespace
 {
-    int GetTrackIndexFromBase(std::uint8_t* ptr)
+    struct LdrUnicodeString
+    {
+        USHORT Length; // bytes
+        USHORT MaximumLength;
+        PWSTR  Buffer;
+    };
+
+    // LDR_DLL_LOADED_NOTIFICATION_DATA (same layout for unload)
+    struct LdrDllNotificationData
+    {
+        ULONG                   Flags;
+        const LdrUnicodeString* FullDllName;
+        const LdrUnicodeString* BaseDllName;
+        PVOID                   DllBase;
+        ULONG                   SizeOfImage;
+    };
+
+    constexpr ULONG LDR_DLL_NOTIFICATION_REASON_LOADED = 1;
+
+    using LdrDllNotificationFn = VOID(CALLBACK*)(ULONG, const LdrDllNotificationData*, PVOID);
+    using LdrRegisterDllNotificationFn = LONG(NTAPI*)(ULONG, LdrDllNotificationFn, PVOID, PVOID*);
+    using LdrUnregisterDllNotificationFn = LONG(NTAPI*)(PVOID);
+
+    const wchar_t k_ModuleName[] = L"gpxtrack.gxm";
+
+    HANDLE  g_ModuleLoaded = nullptr; // manual-reset, set once
+    PVOID   g_NotifyCookie = nullptr;
+    HMODULE g_Module = nullptr;
+    wchar_t g_ModulePath[MAX_PATH] = {};
+    double  g_ModuleLoadMs = 0.0;
+
+    bool IsModuleName(const LdrUnicodeString* name)
+    {
+        const std::size_t len = sizeof(k_ModuleName) / sizeof(wchar_t) - 1;
+        if (!name || !name->Buffer || name->Length != len * sizeof(wchar_t))
+            return false;
+
+        // ASCII case folding only: no locale work under the loader lock
+        for (std::size_t i = 0; i < len; ++i)
+        {
+            wchar_t c = name->Buffer[i];
+            if (c >= L'A' && c <= L'Z')
+                c = static_cast<wchar_t>(c - L'A' + L'a');
+            if (c != k_ModuleName[i])
+                return false;
+        }
+        return true;
+    }
+
+    // Runs under the loader lock before the module's DllMain: only note the
+    // time and path and wake the waiter, which loads it once the lock is free.
+    VOID CALLBACK OnDllNotification(ULONG reason, const LdrDllNotificationData* data, PVOID)
     {
-        for (int t = 0; t < MagicData::TRACK_COUNT; ++t)
+        if (reason != LDR_DLL_NOTIFICATION_REASON_LOADED || !data || !IsModuleName(data->BaseDllName))
+            return;
+
+        g_ModuleLoadMs = Platform::NowMs();
+
+        const LdrUnicodeString* full = data->FullDllName;
+        const std::size_t chars = full && full->Buffer ? full->Length / sizeof(wchar_t) : 0;
+        if (chars > 0 && chars < MAX_PATH)
         {
-            std::uint8_t* base = MagicData::g_Layout[t].origBase;
-            if (base == ptr)
-                return t;
+            memcpy(g_ModulePath, full->Buffer, chars * sizeof(wchar_t));
+            g_ModulePath[chars] = L'\0';
         }
-        return -1;
+
+        SetEvent(g_ModuleLoaded);
     }
+}
 
-    std::uint32_t GetRelocatedMagicPtr(std::uint8_t* orig)
+namespace GPxTrack
+{
+    void WatchModuleLoad()
     {
-        using namespace MagicData;
+        if (g_ModuleLoaded)
+            return;
+
+        g_ModuleLoaded = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (!g_ModuleLoaded)
+            return;
 
-        const int t = GetTrackIndexFromBase(orig);
-        if (t < 0 || t >= TRACK_COUNT)
-            return reinterpret_cast<std::uint32_t>(orig);
+        HMODULE ntdll = GetModuleHandleA("ntdll.dll");
+        auto reg = ntdll ? reinterpret_cast<LdrRegisterDllNotificationFn>(
+            GetProcAddress(ntdll, "LdrRegisterDllNotification")) : nullptr;
 
-        MagicBlockLayout& lay = g_Layout[t];
-        if (!lay.valid || !lay.base)
-            return reinterpret_cast<std::uint32_t>(orig);
+        if (!reg || reg(0, OnDllNotification, nullptr, &g_NotifyCookie) != 0)
+        {
+            g_NotifyCookie = nullptr;
+            GP4MD_LOG_INFO(GPxTrack, "GPxTrack: load notification unavailable, polling for gpxtrack.gxm\n");
+        }
 
-        return reinterpret_cast<std::uint32_t>(lay.base);
+        // Registered after a load that already happened: nothing will come
+        if (GetModuleHandleW(k_ModuleName))
+        {
+            g_ModuleLoadMs = Platform::NowMs();
+            SetEvent(g_ModuleLoaded);
+        }
     }
 
+    HMODULE WaitForModule(double& loadMs)
+    {
+        if (!g_Module)
+        {
+            WatchModuleLoad();
+
+            if (g_NotifyCookie)
+            {
+                WaitForSingleObject(g_ModuleLoaded, INFINITE);
+            }
+            else
+            {
+                while (!GetModuleHandleW(k_ModuleName))
+                    Sleep(100);
+                if (g_ModuleLoadMs == 0.0)
+                    g_ModuleLoadMs = Platform::NowMs();
+            }
+
+            // Returns once the loader has run the module's initialization,
+            // and keeps it loaded while the hooks jump into it
+            g_Module = LoadLibraryW(g_ModulePath[0] ? g_ModulePath : k_ModuleName);
+
+            if (g_NotifyCookie)
+            {
+                HMODULE ntdll = GetModuleHandleA("ntdll.dll");
+                auto unreg = reinterpret_cast<LdrUnregisterDllNotificationFn>(
+                    GetProcAddress(ntdll, "LdrUnregisterDllNotification"));
+                if (unreg)
+                    unreg(g_NotifyCookie);
+                g_NotifyCookie = nullptr;
+            }
+        }
+
+        loadMs = g_ModuleLoadMs;
+        return g_Module;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+namespace
+{
     void PatchJump(void* src, void* dst)
     {
         DWORD oldProt{};
@@ -92,9 +209,10 @@ namespace
     {
         using namespace GPxTrackAddresses;
 
-        HMODULE hGPx = nullptr;
-        while (!(hGPx = GetModuleHandleA("gpxtrack.gxm")))
-            Sleep(100);
+        double loadMs = 0.0;
+        HMODULE hGPx = GPxTrack::WaitForModule(loadMs);
+        if (!hGPx)
+            return false;
 
         auto* base = reinterpret_cast<std::uint8_t*>(hGPx);
 
@@ -128,16 +246,9 @@ void __declspec(naked) GPxMagicHook_Mem()
     __asm {
         pushad
 
-        mov  eax, esi
-        push eax
-        call GetTrackIndexFromBase
-        add  esp, 4
-
-        mov  MagicData::g_CurrentTrackIndex, eax
-
-        mov  eax, esi
-        push eax
-        call GetRelocatedMagicPtr
+        // one lookup: sets g_CurrentTrackIndex, returns the relocated block
+        push esi
+        call MagicData::Hooks::ResolveMem
         add  esp, 4
 
         mov  edx, GPxTrack::g_pMagicGlobal
@@ -158,31 +269,18 @@ void __declspec(naked) GPxMagicHook_Dat()
     __asm {
         pushad
 
-        mov  eax, MagicData::g_CurrentTrackIndex
-        cmp  eax, 0
-        jl   no_map
-        cmp  eax, MagicData::TRACK_COUNT
-        jge  no_map
-
-        mov  ecx, eax
-        mov  edx, OFFSET MagicData::g_Layout
-        mov  eax, kMagicBlockLayoutSize
-        imul ecx, eax
-        add  edx, ecx
-        mov  eax, [edx + 4]
-        jmp  write_ptr
-
-        no_map :
-        mov  eax, edx
+        // relocated block of the current track; GP4's own pointer (edx) otherwise
+        push edx
+        call MagicData::Hooks::ResolveDat
+        add  esp, 4
 
-            write_ptr :
         mov  edx, GPxTrack::g_pMagicGlobal
-            mov[edx], eax
+        mov[edx], eax
 
-            popad
+        popad
 
-            mov  eax, GPxTrack::g_pMagicResumeDat
-            jmp  eax
+        mov  eax, GPxTrack::g_pMagicResumeDat
+        jmp  eax
     }
 }
 
@@ -193,7 +291,7 @@ void GPxTrack::InstallMagicHooks()
 {
     if (!ResolveGPxTrackAddresses())
     {
-        Logging::LogMD("GPxTrack: InstallMagicHooks aborted\n");
+        GP4MD_LOG_ERROR(GPxTrack, "GPxTrack: InstallMagicHooks aborted\n");
         return;
     }
 
@@ -2,6 +2,7 @@
 
 #include <windows.h>
 #include <cstdint>
+#include "../MagicData/MagicData.h"
 
 namespace GPxTrack
 {
@@ -23,7 +24,18 @@ namespace GPxTrack
     // common staging pointer [9D12B74]
     extern std::uint32_t* g_pMagicGlobal;
 
-    extern GPxOverrideEntry g_GPxOverride[17];
+    // Indexed by track; sized for the largest TrackCount
+    extern GPxOverrideEntry g_GPxOverride[MagicData::MAX_TRACK_COUNT];
+
+    // Registers for the loader's notification of gpxtrack.gxm, so its load
+    // is seen when it happens instead of on the next poll. Call as early as
+    // possible; later calls do nothing.
+    void WatchModuleLoad();
+
+    // Blocks until gpxtrack.gxm is loaded and initialized and returns it,
+    // pinned while the hooks point into it. loadMs: Platform::NowMs() when
+    // the loader mapped it (when the wait found it if already loaded).
+    HMODULE WaitForModule(double& loadMs);
 
     void InstallMagicHooks();
 }
@@ -1,243 +1,1128 @@
-#include <windows.h>
 #include <cstdio>
 #include <vector>
 #include <string>
 #include <cstring>
-#include <array>
+#include <atomic>
+#include <thread>
+#include <utility>
 
 #include "MagicData.h"
 #include "MagicData_IO.h"
+#include "MagicData_DatCache.h"
+#include "MagicData_Snapshot.h"
 #include "MagicData_Internal.h"
+#include "MagicData_Publish.h"
+#include "MagicData_Hooks.h"
+#include "MagicData_Overlay.h"
+#include "MagicData_Pack.h"
+#include "MagicData_Timing.h"
 #include "../Core/Logging.h"
 #include "../Core/Encoding.h"
 #include "../RaceSettings/RaceSettings.h"
-#include "../GPxTrack/GPxTrack.h"
-#include "../IniLib/IniLib.h"
-#include "../GP4MemLib/GP4MemLib.h"
+#include "../RaceSettings/RaceRules.h"
 #include "../Core/GP4Addresses.h"
+#include "../Core/Platform.h"
+#include "../Core/Patch.h"
+#include "../Core/Arena.h"
 
-using namespace IniLib;
-using namespace GP4MemLib;
 
 namespace MagicData
 {
-    bool            g_EnableLogging = true;
     bool            g_LogDefaults = false;
-    MagicBlockLayout g_Layout[TRACK_COUNT];
-    DescInfo         g_Desc[DESC_COUNT];
+    int              g_TrackCount = 0;
+    MagicBlockLayout* g_Layout = nullptr; // g_TrackCount entries
     std::uint8_t* g_LapTable = nullptr; // relocated lap table
     std::uint8_t* g_LapTableOrig = nullptr; // original GP4 lap table
     int              g_CurrentTrackIndex = -1;
 
-    // Static arena for all relocated magicdata + laps
-    // 32 KB should be enough for all tracks + lap table
-    static std::array<std::uint8_t, 0x5000> g_StaticArena{};
+    // Relocated magicdata + laps: one block per track, sized from the
+    // prepared (post-.dat) block, then the lap table. Reload generations use
+    // the same block layout in memory owned by Publish.
+    static Memory::Arena g_Arena;
+    static std::size_t   g_ArenaPeak = 0; // arena + unreclaimed generations
+
+    // Original GP4 layout from the scan; kept for hot reload, which rebuilds
+    // tracks after g_Layout was relocated.
+    static std::vector<MagicBlockLayout> g_OrigLayout;
+    static std::vector<MagicBlockLayout> g_LayoutTable;
+    static bool                          g_Published = false;
+
+    // GP4's lap table as first scanned; WriteLapTableToGP4 overwrites the
+    // original, and later builds (reload, profiles) must not start from it.
+    static std::vector<std::uint8_t> g_LapDefaults;
+
+    // -------------------------------------------------------------------------
+    // Internal helpers
+    // -------------------------------------------------------------------------
+    // Returns the bytes written to GP4's memory.
+    static std::size_t WriteLapTableToGP4()
+    {
+        // Original GP4 lap table location: game memory, so the edits are
+        // staged and written with one protection change
+        auto* dst = Platform::AddressToPtr(GP4Addresses::LAP_TABLE_ADDR);
+
+        Patch::Transaction txn(dst, g_TrackCount);
+
+        for (int t = 0; t < g_TrackCount; ++t)
+            txn.Stage(static_cast<std::uint32_t>(t), 1, g_LapTable[t]);
+
+        for (const Patch::Change& c : txn.Changes())
+        {
+            GP4MD_LOG_DEBUG(MagicData, "WriteLapTable GP4[%02d] %u -> %u (addr=%p)\n",
+                c.offset + 1, c.oldValue, c.newValue, dst + c.offset);
+        }
+
+        const std::size_t changed = txn.Changes().size();
+        const std::size_t runs = txn.Commit(Patch::CommitMode::Protected);
+
+        GP4MD_LOG_INFO(MagicData, "WriteLapTable: %zu of %d entries changed, %zu write(s)\n",
+            changed, g_TrackCount, runs);
+
+        return txn.BytesWritten();
+    }
+
+    // -------------------------------------------------------------------------
+    // Per-track prepare (runs on the worker pool)
+    // -------------------------------------------------------------------------
+    namespace
+    {
+        // [General] integer key; missing, blank or non-integer keys give def
+        int GetGeneralInt(const IniText::Document& globalIni, const char* key, int def)
+        {
+            const IniText::Entry* e = globalIni.Find("General", key);
+            if (!e || e->value.empty())
+                return def;
+
+            int v = def;
+            if (!IniText::ParseInt(e->value, v))
+            {
+                GP4MD_LOG_INFO(MagicData, "GP4MD.ini: ignored %s (not an integer)\n", key);
+                return def;
+            }
+            return v;
+        }
+
+        // A GP4MD.ini section; empty (present = false) when missing
+        const IniText::Section& GlobalSection(const IniText::Document& globalIni, const char* name)
+        {
+            static const IniText::Section k_Missing;
+
+            const IniText::Section* sec = globalIni.FindSection(name);
+            return sec ? *sec : k_Missing;
+        }
+
+        // [General] text value, raw; empty when missing
+        std::string GetGeneralText(const IniText::Document& globalIni, const char* key)
+        {
+            const IniText::Entry* e = globalIni.Find("General", key);
+            return e ? e->value : std::string();
+        }
+
+        // A Track INI read ahead of the prepare (PrepareInputs)
+        struct TrackInput
+        {
+            bool             hasIni = false;
+            IniText::Section sec; // [TrackNN]
+        };
+
+        // TrackNN.ini and its [TrackNN] section; false when there is no file.
+        // bytesRead (optional) receives the file size.
+        bool ReadTrackIni(const std::string& folder, int t, IniText::Section& sec,
+            std::size_t* bytesRead = nullptr)
+        {
+            char file[64];
+            std::snprintf(file, sizeof(file), "Track%02d.ini", t + 1);
+
+            std::string iniText;
+            if (!Platform::ReadWholeFile(folder + file, iniText))
+                return false;
+
+            if (bytesRead)
+                *bytesRead = iniText.size();
+
+            char section[32];
+            std::snprintf(section, sizeof(section), "Track%02d", t + 1);
+
+            IniText::ReadSection(iniText, section, sec);
+            return true;
+        }
+
+        struct PrepareContext
+        {
+            std::string        folder;
+            RaceConfig         race;                // [RaceSettings], parsed once
+            RaceRules::Program rules;               // [Rules]; empty with RaceRules=0
+            bool               hasGlobal = false;
+            std::size_t        lastDescEnd = 0;
+            bool               raceSettings = true; // false: pack content only
+            bool               record = true;       // keep provenance (Overlay)
+            const TrackInput*  inputs = nullptr;    // Track INIs read ahead, else read here
+            TrackTiming*       timing = nullptr;    // per-track timers (startup only)
+        };
+
+        // One track's relocated block, built in private scratch memory.
+        struct TrackBuild
+        {
+            std::uint8_t*             block = nullptr; // descriptors + bump region
+            std::size_t               size = 0;
+            std::uint8_t              laps = 0;
+            std::uint8_t              sprintLaps = 0;  // Track INI SprintLaps, 0 = none
+            bool                      hasTrackIni = false;
+            std::vector<std::uint8_t> defaults;        // descriptors before INI overrides
+        };
+
+        void FreeTrackBuild(TrackBuild& b)
+        {
+            Platform::FreePages(b.block, b.size);
+
+            b = TrackBuild{};
+        }
+
+        // Inputs shared by every track; race is [RaceSettings] or a profile
+        // on top of it, and [Rules] is compiled against it.
+        PrepareContext MakeContext(const std::string& folder, const IniText::Document& globalIni,
+            const RaceConfig& race)
+        {
+            PrepareContext ctx;
+            ctx.folder = folder;
+            ctx.race = race;
+            if (GetGeneralInt(globalIni, "RaceRules", 1) != 0)
+                ctx.rules = RaceRules::Build(ctx.race, GlobalSection(globalIni, "Rules"));
+            ctx.hasGlobal = globalIni.present;
+            ctx.lastDescEnd = LAST_DESC_END;
+            return ctx;
+        }
+
+        // Reads only the original GP4 block, the track's .dat (or the open
+        // pack) and INIs; writes only into b. The block starts as a copy of the
+        // GP4 default; the .dat or pack, track INI and RaceSettings layers are
+        // staged in that order in one transaction and stored directly (one
+        // write per changed field), as the block is ours and unprotected.
+        bool PrepareTrack(int t, const PrepareContext& ctx, TrackBuild& b)
+        {
+            const std::size_t lastDescEnd = ctx.lastDescEnd;
+            TrackTiming*      timing = ctx.timing ? &ctx.timing[t] : nullptr;
+            const double      startMs = Platform::NowMs();
+
+            // A pack entry replaces the .dat: its laps and block are final
+            // up to the Track INI
+            PackTrack  packed;
+            const bool fromPack = Pack::Get(t, packed);
+
+            // Laps: prefer .dat, fall back to GP4 lap table
+            std::uint8_t baseLap = fromPack ? packed.laps : g_LapDefaults[t];
+
+            DatView   dat;
+            const bool hasDat = !fromPack && DatCache::Get(t, dat);
+
+            Layer lapsLayer = fromPack ? Layer::Pack : Layer::Default;
+            int   datLaps = 0;
+            if (hasDat && ExtractLapsFromDat(dat, datLaps))
+            {
+                int tmp = datLaps;
+                if (tmp < 1)   tmp = 1;
+                if (tmp > 255) tmp = 255;
+                baseLap = static_cast<std::uint8_t>(tmp);
+                lapsLayer = Layer::Dat;
+
+                GP4MD_LOG_DEBUG(MagicData, "Track %02d laps from .dat = %d\n", t + 1, datLaps);
+            }
+
+            b.laps = baseLap;
+
+            // .dat magicdata (descriptor + bump region) when present
+            std::size_t         datMdSize = fromPack ? packed.size : 0;
+            const std::uint8_t* datMd = fromPack ? packed.block
+                : hasDat ? FindMagicDataInDat(dat, datMdSize) : nullptr;
+            const Layer         blockLayer = fromPack ? Layer::Pack : Layer::Dat;
+
+            const MagicBlockLayout& orig = g_OrigLayout[t];
+            const std::size_t bumpBytesOrig =
+                static_cast<std::size_t>(orig.bumpEnd - orig.bumpStart);
+
+            const bool useDatBump = datMd && datMdSize > lastDescEnd;
+            const std::size_t bumpBytes = useDatBump ? datMdSize - lastDescEnd : bumpBytesOrig;
+
+            b.size = lastDescEnd + bumpBytes;
+            b.block = static_cast<std::uint8_t*>(Platform::AllocPages(b.size));
+            if (!b.block)
+            {
+                GP4MD_LOG_ERROR(MagicData, "Track %02d: scratch allocation failed (%zu bytes)\n",
+                    t + 1, b.size);
+                return false;
+            }
+
+            // Default layer: the original descriptor region, copied once
+            std::memcpy(b.block, orig.origBase, lastDescEnd);
+
+            // Bump region: .dat layout is descriptor [0..lastDescEnd), bump [lastDescEnd..terminator]
+            if (useDatBump)
+                std::memcpy(b.block + lastDescEnd, datMd + lastDescEnd, bumpBytes);
+            else
+                std::memcpy(b.block + lastDescEnd, orig.bumpStart, bumpBytes);
+
+            Patch::Transaction txn(b.block, lastDescEnd);
+
+            // .dat or pack layer: descriptors that differ from the default
+            // (clamped to the descriptor region)
+            std::size_t payload = 0;
+            if (datMd)
+            {
+                GP4MD_LOG_DEBUG(MagicData, "Track %2d: using %s magicdata (size=%zu)\n",
+                    t + 1, Overlay::LayerName(blockLayer), datMdSize);
+
+                payload = datMdSize < lastDescEnd ? datMdSize : lastDescEnd;
+                Overlay::StageBlock(txn, datMd, payload, blockLayer);
+            }
+
+            if (g_LogDefaults)
+            {
+                // defaults.ini shows default + .dat (or pack), before any INI layer
+                b.defaults.assign(b.block, b.block + lastDescEnd);
+
+                if (datMd)
+                {
+                    Patch::Transaction view(b.defaults.data(), lastDescEnd);
+                    Overlay::StageBlock(view, datMd, payload, blockLayer);
+                    view.Commit(Patch::CommitMode::Plain);
+                }
+            }
+
+            // Track INI + RaceSettings: the file is read and its section scanned once
+            IniText::Section sec;
+            if (ctx.inputs)
+            {
+                b.hasTrackIni = ctx.inputs[t].hasIni;
+                sec = ctx.inputs[t].sec;
+            }
+            else
+                b.hasTrackIni = ReadTrackIni(ctx.folder, t, sec);
+
+            if (b.hasTrackIni)
+            {
+                const std::uint8_t laps = b.laps;
+                const double       iniMs = Platform::NowMs();
+
+                txn.SetSource(static_cast<std::uint8_t>(Layer::TrackIni));
+                MagicDataInternal::PatchTrack(txn, &b.laps, sec, ctx.race.sprint, t);
+
+                if (timing)
+                    timing->trackIniMs = Platform::NowMs() - iniMs;
+
+                if (b.laps != laps)
+                    lapsLayer = Layer::TrackIni;
+            }
+
+            // The pack stands in for the Track INI it was compiled from: its
+            // SprintLaps, and whether RaceSettings applies at all
+            if (fromPack && packed.hasTrackIni)
+            {
+                b.hasTrackIni = true;
+                if (packed.sprintLaps && !sec.Find("SprintLaps"))
+                    sec.entries.push_back({ "SprintLaps", std::to_string(packed.sprintLaps) });
+            }
+
+            if (const IniText::Entry* e = sec.Find("SprintLaps"))
+            {
+                int sprintLaps = 0;
+                if (IniText::ParseInt(e->value, sprintLaps) && sprintLaps > 0)
+                    b.sprintLaps = static_cast<std::uint8_t>(sprintLaps > 255 ? 255 : sprintLaps);
+            }
+
+            // [RaceSettings] for tracks with a Track INI, then [Rules] for
+            // every track
+            const bool applyRace = b.hasTrackIni && ctx.hasGlobal && ctx.raceSettings;
+            const bool applyRules = ctx.raceSettings && ctx.rules.RuleCount() > 0;
+
+            if (applyRace || applyRules)
+            {
+                const std::uint8_t laps = b.laps;
+                const double       raceMs = Platform::NowMs();
+
+                txn.SetSource(static_cast<std::uint8_t>(Layer::RaceSettings));
+                if (applyRace)
+                    ApplyRaceSettings(ctx.race, sec, t, txn, &b.laps);
+
+                if (applyRules)
+                {
+                    RaceRules::RuleInputs in;
+                    in.sprintLaps = b.sprintLaps;
+                    in.trackIndex = t;
+
+                    ctx.rules.Run(in, txn, &b.laps);
+                }
+
+                if (timing)
+                    timing->raceMs = Platform::NowMs() - raceMs;
+
+                if (b.laps != laps)
+                    lapsLayer = Layer::RaceSettings;
+            }
+
+            std::size_t perLayer[LAYER_COUNT];
+            if (ctx.record)
+                Overlay::Record(t, txn, lapsLayer, perLayer);
+
+            const std::size_t fields = txn.Changes().size();
+            const std::size_t runs = txn.Commit(Patch::CommitMode::Plain);
+
+            if (fields && ctx.record)
+            {
+                GP4MD_LOG_DEBUG(MagicData,
+                    "Track %02d: %zu field(s) patched in %zu run(s) (.dat %zu, pack %zu, track ini %zu, race settings %zu)\n",
+                    t + 1, fields, runs, perLayer[static_cast<int>(Layer::Dat)],
+                    perLayer[static_cast<int>(Layer::Pack)],
+                    perLayer[static_cast<int>(Layer::TrackIni)],
+                    perLayer[static_cast<int>(Layer::RaceSettings)]);
+            }
+
+            if (ctx.record)
+                Overlay::LogTrack(t, b.block);
+
+            if (timing)
+            {
+                timing->prepareMs = Platform::NowMs() - startMs;
+                timing->patchFields = fields;
+                timing->patchBytes = txn.BytesWritten();
+            }
+
+            return true;
+        }
+
+        // fn(t) for every track slot on threads workers (the caller is one);
+        // false when any call returned false.
+        template <typename Fn>
+        bool RunOnPool(int threads, Fn fn)
+        {
+            std::atomic<int>  next(0);
+            std::atomic<bool> ok(true);
+
+            auto worker = [&]()
+                {
+                    for (int t = next++; t < g_TrackCount; t = next++)
+                    {
+                        if (!fn(t))
+                            ok = false;
+                    }
+                };
+
+            std::vector<std::thread> pool;
+            for (int i = 1; i < threads; ++i)
+                pool.emplace_back(worker);
+
+            worker();
+
+            for (std::thread& th : pool)
+                th.join();
+
+            return ok;
+        }
+
+        bool RunPrepare(const PrepareContext& ctx, TrackBuild* builds, int threads)
+        {
+            return RunOnPool(threads, [&](int t) { return PrepareTrack(t, ctx, builds[t]); });
+        }
+
+        // Log sinks from [General]; the queue itself is always asynchronous
+        // unless LogAsync=0.
+        void ConfigureLogging(const IniText::Document& globalIni, const std::string& folder)
+        {
+            Logging::Config cfg;
+            cfg.async = GetGeneralInt(globalIni, "LogAsync", 1) != 0;
+            cfg.debugOutput = GetGeneralInt(globalIni, "LogDebug", 1) != 0;
+            cfg.stdoutSink = GetGeneralInt(globalIni, "LogStdout", 0) != 0;
+
+            if (GetGeneralInt(globalIni, "LogFile", 0) != 0)
+                cfg.filePath = folder + "GP4MD.log";
+
+            const int maxKB = GetGeneralInt(globalIni, "LogFileMaxKB", 1024);
+            if (maxKB > 0)
+                cfg.fileMaxBytes = static_cast<std::size_t>(maxKB) * 1024;
+
+            Logging::Configure(cfg);
+        }
+
+        // Per-category levels from [General]: LogLevel sets all of them,
+        // LogLevel<Category> overrides one, Log=0 silences everything.
+        void ConfigureLogLevels(const IniText::Document& globalIni)
+        {
+            Logging::Level all = Logging::Level::Debug;
+            Logging::Level levels[Logging::CATEGORY_COUNT];
+
+            const IniText::Section& sec = GlobalSection(globalIni, "General");
+
+            if (const IniText::Entry* e = sec.Find("LogLevel"))
+                Logging::ParseLevel(e->value, all);
+
+            for (int c = 0; c < Logging::CATEGORY_COUNT; ++c)
+            {
+                levels[c] = all;
+
+                const std::string key = std::string("LogLevel") + Logging::CategoryName(static_cast<Logging::Category>(c));
+                if (const IniText::Entry* e = sec.Find(key.c_str()))
+                    Logging::ParseLevel(e->value, levels[c]);
+            }
+
+            if (GetGeneralInt(globalIni, "Log", 1) == 0)
+            {
+                Logging::SetAllLevels(Logging::Level::Off);
+                return;
+            }
+
+            for (int c = 0; c < Logging::CATEGORY_COUNT; ++c)
+                Logging::SetLevel(static_cast<Logging::Category>(c), levels[c]);
+        }
+
+        void LogStartupCost(double startMs)
+        {
+            const Logging::Stats s = Logging::GetStats();
+
+            GP4MD_LOG_INFO(MagicData, "PatchAllTracks: %.3f ms (log: %llu queued, %llu dropped, %llu oversized)\n",
+                Platform::NowMs() - startMs,
+                static_cast<unsigned long long>(s.queued),
+                static_cast<unsigned long long>(s.dropped),
+                static_cast<unsigned long long>(s.oversized));
+        }
+
+        int ResolveThreadCount(const IniText::Document& globalIni)
+        {
+            int threads = GetGeneralInt(globalIni, "Threads", 0);
+
+            // 0 = auto: a small pool is plenty for a few dozen tracks
+            if (threads <= 0)
+            {
+                threads = static_cast<int>(std::thread::hardware_concurrency());
+                if (threads > 4) threads = 4;
+                if (threads < 1) threads = 1;
+            }
+
+            if (threads > g_TrackCount)
+                threads = g_TrackCount;
+
+            return threads;
+        }
+
+        // Re-runs the prepare phase serially and compares it with the parallel result.
+        void VerifyPrepare(const PrepareContext& ctx, const TrackBuild* builds)
+        {
+            std::vector<TrackBuild> serial(g_TrackCount);
+            int                     mismatches = 0;
+
+            PrepareContext serialCtx = ctx;
+            serialCtx.timing = nullptr;
+
+            RunPrepare(serialCtx, serial.data(), 1);
+
+            for (int t = 0; t < g_TrackCount; ++t)
+            {
+                const bool same =
+                    serial[t].size == builds[t].size &&
+                    serial[t].laps == builds[t].laps &&
+                    serial[t].block && builds[t].block &&
+                    std::memcmp(serial[t].block, builds[t].block, serial[t].size) == 0;
+
+                if (!same)
+                {
+                    GP4MD_LOG_ERROR(MagicData, "VerifyPrepare: Track %02d differs from serial path\n", t + 1);
+                    ++mismatches;
+                }
+
+                FreeTrackBuild(serial[t]);
+            }
+
+            GP4MD_LOG_INFO(MagicData, "VerifyPrepare: %d mismatching track(s)\n", mismatches);
+        }
+
+        // [General] Pack=<file>, next to GP4MD.ini; empty when unset
+        std::string PackPath(const std::string& folder, const IniText::Document& globalIni)
+        {
+            const std::string name = GetGeneralText(globalIni, "Pack");
+            return name.empty() ? std::string() : folder + name;
+        }
+
+        // PackCompile=1: prepares the pack layers (.dat + Track INI, without
+        // RaceSettings), writes them to path, then prepares again through the
+        // pack and compares with builds, the result of the INI path.
+        bool CompilePack(const PrepareContext& ctx, const TrackBuild* builds, int threads,
+            const std::string& path)
+        {
+            PrepareContext packCtx = ctx;
+            packCtx.raceSettings = false;
+            packCtx.record = false;
+            packCtx.timing = nullptr;
+
+            std::vector<TrackBuild> packed(g_TrackCount);
+            bool ok = RunPrepare(packCtx, packed.data(), threads);
+
+            if (ok)
+            {
+                std::vector<PackTrack> tracks(g_TrackCount);
+                for (int t = 0; t < g_TrackCount; ++t)
+                {
+                    tracks[t].block = packed[t].block;
+                    tracks[t].size = packed[t].size;
+                    tracks[t].laps = packed[t].laps;
+                    tracks[t].sprintLaps = packed[t].sprintLaps;
+                    tracks[t].hasTrackIni = packed[t].hasTrackIni;
+                }
+
+                ok = Pack::Write(path, tracks.data(), g_TrackCount);
+            }
+
+            for (TrackBuild& b : packed)
+                FreeTrackBuild(b);
+
+            if (!ok || !Pack::Open(path))
+                return false;
+
+            PrepareContext checkCtx = ctx;
+            checkCtx.record = false;
+
+            std::vector<TrackBuild> check(g_TrackCount);
+            ok = RunPrepare(checkCtx, check.data(), threads);
+
+            int mismatches = 0;
+            for (int t = 0; t < g_TrackCount; ++t)
+            {
+                const bool same =
+                    check[t].size == builds[t].size &&
+                    check[t].laps == builds[t].laps &&
+                    check[t].block && builds[t].block &&
+                    std::memcmp(check[t].block, builds[t].block, check[t].size) == 0;
+
+                if (!same)
+                {
+                    GP4MD_LOG_ERROR(IO, "Pack: Track %02d differs from the INI path\n", t + 1);
+                    ++mismatches;
+                }
+
+                FreeTrackBuild(check[t]);
+            }
+
+            Pack::Close();
+
+            GP4MD_LOG_INFO(IO, "Pack: verified against the INI path, %d mismatching track(s)\n", mismatches);
+            return ok && mismatches == 0;
+        }
+
+        // [General] ArenaAlign (block alignment, power of two) and
+        // ArenaGuard (guard bytes after each block, 0 = off)
+        Memory::ArenaOptions ReadArenaOptions(const IniText::Document& globalIni)
+        {
+            Memory::ArenaOptions options;
+
+            const int align = GetGeneralInt(globalIni, "ArenaAlign", 16);
+            const int guard = GetGeneralInt(globalIni, "ArenaGuard", 0);
+
+            if (align > 0)
+                options.alignment = static_cast<std::size_t>(align);
+            if (guard > 0)
+                options.guardBytes = static_cast<std::size_t>(guard);
+
+            return options;
+        }
+
+        void NoteArenaPeak()
+        {
+            const std::size_t live = g_Arena.PlannedBytes() + Publish::GenerationBytes();
+            if (live > g_ArenaPeak)
+                g_ArenaPeak = live;
+        }
+
+        // Bytes per block and the slack around them (alignment + tail)
+        void LogArenaUsage(const Memory::Arena& arena, const char* what)
+        {
+            std::size_t data = 0;
+            std::size_t slack = 0;
+
+            for (const Memory::ArenaBlock& b : arena.Blocks())
+            {
+                const bool        track = b.tag < MagicDataInternal::LAP_TABLE_TAG;
+                const std::size_t tail = track ? MagicDataInternal::SLOT_TAIL : 0;
+
+                data += b.size - tail;
+                slack += b.padding + tail;
+
+                if (track)
+                {
+                    GP4MD_LOG_DEBUG(MagicData, "%s: Track %02d %zu bytes at +0x%zx, slack %zu\n",
+                        what, b.tag + 1, b.size - tail, b.offset, b.padding + tail);
+                }
+            }
+
+            GP4MD_LOG_INFO(MagicData, "%s: %zu bytes (%zu data, %zu slack, %zu guard), peak %zu\n",
+                what, arena.PlannedBytes(), data, slack,
+                arena.Blocks().size() * arena.Options().guardBytes, g_ArenaPeak);
+        }
+
+        int CheckGuards(const Memory::Arena& arena, const char* what)
+        {
+            std::vector<int> damaged;
+            const int bad = arena.CheckGuards(&damaged);
+
+            for (int id : damaged)
+            {
+                const int tag = arena.Blocks()[id].tag;
+                if (tag < MagicDataInternal::LAP_TABLE_TAG)
+                    GP4MD_LOG_ERROR(MagicData, "%s: Track %02d overran its block\n", what, tag + 1);
+                else
+                    GP4MD_LOG_ERROR(MagicData, "%s: lap table overran its block\n", what);
+            }
+
+            return bad;
+        }
+
+        // Copies a finished build to dstBase (at most capacity bytes) and
+        // describes it in L and laps (the track's g_Layout and lap entry, or
+        // a profile's). Hooks only see it once Publish::Reset /
+        // Publish::Commit stores the new base.
+        void PlaceTrack(int t, const TrackBuild& b, std::uint8_t* dstBase,
+            std::size_t capacity, std::size_t lastDescEnd, MagicBlockLayout& L, std::uint8_t& laps)
+        {
+            std::size_t bytes = b.size;
+            if (bytes > capacity)
+            {
+                GP4MD_LOG_INFO(MagicData, "Track %02d: bump region truncated to arena slot (%zu > %zu)\n",
+                    t + 1, bytes, capacity);
+                bytes = capacity;
+            }
+
+            std::memcpy(dstBase, b.block, bytes);
+
+            const std::size_t bumpBytes = bytes - lastDescEnd;
+            L.base = dstBase;
+            L.bumpStart = dstBase + lastDescEnd;
+            L.bumpEnd = dstBase + lastDescEnd + bumpBytes;
+            L.bumpSize = bumpBytes;
+
+            laps = b.laps;
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Startup inputs (PrepareInputs -> PatchAllTracks)
+    // -------------------------------------------------------------------------
+    namespace
+    {
+        // Everything PatchAllTracks reads from disk, gathered before GP4's
+        // memory is needed; the .dat views live in DatCache, the pack in Pack.
+        struct StartupInputs
+        {
+            bool                    ready = false;
+            IniText::Document       globalIni;
+            RaceConfig              race;
+            PrepareContext          ctx;           // inputs points into tracks
+            std::vector<TrackInput> tracks;
+            std::string             packPath;
+            bool                    compilePack = false;
+            bool                    snapshot = false;  // Snapshot=1, restore and save
+            bool                    deferred = false;  // .dat / Track INI reads wait for the restore
+            std::uint64_t           inputsKey = 0;     // ComputeInputsKey
+            double                  inputsMs = 0.0; // PrepareInputs wall time
+        };
+
+        StartupInputs g_Startup;
+
+        // Unmaps the .dat files and the pack and drops the Track INIs
+        void ReleaseStartupInputs()
+        {
+            DatCache::Release();
+            Pack::Close();
+
+            g_Startup.ctx.inputs = nullptr;
+            g_Startup.tracks.clear();
+            g_Startup.ready = false;
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Race profiles
+    // -------------------------------------------------------------------------
+    namespace
+    {
+        // One configuration of the whole season: entry 0 is [RaceSettings]
+        // itself, the others are [Profile.<Name>] on top of it. A built
+        // profile holds every track's block in a pinned generation (entry 0
+        // starts out as the startup arena), so activating it only swaps the
+        // published pointers and rewrites the lap table.
+        struct Profile
+        {
+            std::string                   name;
+            RaceConfig                    race;
+            bool                          built = false;
+            std::uint8_t*                 gen = nullptr; // nullptr: the static arena
+            std::vector<MagicBlockLayout> layout;        // base and bump region per track
+            std::vector<std::uint8_t>     laps;
+        };
+
+        const char* const    k_BaseProfile = "RaceSettings";
+        std::vector<Profile> g_Profiles;
+        int                  g_ActiveProfile = 0;
+
+        int FindProfile(const std::string& name)
+        {
+            if (name.empty())
+                return 0;
+
+            for (std::size_t i = 0; i < g_Profiles.size(); ++i)
+            {
+                if (IniText::EqualsNoCase(g_Profiles[i].name.c_str(), name.c_str()))
+                    return static_cast<int>(i);
+            }
+            return -1;
+        }
+
+        // Releases every profile's blocks; a published generation stays
+        // until a reload or switch replaces its tracks.
+        void DropProfiles()
+        {
+            for (Profile& p : g_Profiles)
+            {
+                if (p.gen)
+                    Publish::Pin(p.gen, false);
+
+                p.built = false;
+                p.gen = nullptr;
+            }
+        }
+
+        // Lists [RaceSettings] and the [Profile.<Name>] sections of GP4MD.ini,
+        // none of them built. Keeps the active profile by name.
+        void LoadProfiles(const IniText::Document& globalIni, const RaceConfig& race)
+        {
+            const std::string active = g_Profiles.empty() ? std::string() : g_Profiles[g_ActiveProfile].name;
+
+            DropProfiles();
+            g_Profiles.assign(1, Profile{});
+            g_Profiles[0].name = k_BaseProfile;
+            g_Profiles[0].race = race;
+
+            std::vector<std::string> names;
+            globalIni.ListSections("Profile.", names);
+
+            for (const std::string& name : names)
+            {
+                if (FindProfile(name) >= 0)
+                {
+                    GP4MD_LOG_INFO(MagicData, "Profile: ignored [Profile.%s] (name in use)\n", name.c_str());
+                    continue;
+                }
+
+                Profile p;
+                p.name = name;
+                p.race = ParseRaceProfile(race, GlobalSection(globalIni, ("Profile." + name).c_str()));
+                g_Profiles.push_back(std::move(p));
+            }
+
+            g_ActiveProfile = FindProfile(active);
+            if (g_ActiveProfile < 0)
+            {
+                GP4MD_LOG_INFO(MagicData, "Profile: %s no longer defined, using %s\n", active.c_str(), k_BaseProfile);
+                g_ActiveProfile = 0;
+            }
+        }
+
+        // The published season as profile p (right after PatchAllTracks: the
+        // static arena holds every track).
+        void CaptureArenaProfile(Profile& p)
+        {
+            p.layout.assign(g_Layout, g_Layout + g_TrackCount);
+            p.laps.assign(g_LapTable, g_LapTable + g_TrackCount);
+            p.gen = nullptr;
+            p.built = true;
+        }
+
+        // Prepares every track with the profile's race settings into one
+        // pinned generation. Maps the .dat files and the pack itself.
+        bool BuildProfile(Profile& p, const std::string& folder, const IniText::Document& globalIni, int threads)
+        {
+            const double start = Platform::NowMs();
+
+            PrepareContext ctx = MakeContext(folder, globalIni, p.race);
+            ctx.record = false;
+
+            const std::string packPath = PackPath(folder, globalIni);
+            if (!packPath.empty())
+                Pack::Open(packPath);
+
+            // defaults.* describe the startup state only
+            const bool logDefaults = g_LogDefaults;
+            g_LogDefaults = false;
+
+            std::vector<TrackBuild> builds(g_TrackCount);
+            bool ok = RunPrepare(ctx, builds.data(), threads);
+
+            g_LogDefaults = logDefaults;
+
+            DatCache::Release();
+            Pack::Close();
+
+            Memory::Arena genArena(g_Arena.Options());
+            for (int t = 0; ok && t < g_TrackCount; ++t)
+                genArena.Reserve(builds[t].size + MagicDataInternal::SLOT_TAIL, t);
+
+            std::uint8_t* gen = ok ? Publish::NewGeneration(genArena.PlannedBytes()) : nullptr;
+            if (ok && !gen)
+            {
+                GP4MD_LOG_ERROR(MagicData, "Profile %s: allocation failed (%zu bytes)\n",
+                    p.name.c_str(), genArena.PlannedBytes());
+                ok = false;
+            }
+
+            if (ok)
+            {
+                Publish::Pin(gen, true);
+                genArena.Attach(gen);
+
+                p.layout.assign(g_Layout, g_Layout + g_TrackCount);
+                p.laps.assign(g_TrackCount, 0);
+
+                for (int t = 0; t < g_TrackCount; ++t)
+                {
+                    PlaceTrack(t, builds[t], genArena.BlockData(t), genArena.Blocks()[t].size,
+                        ctx.lastDescEnd, p.layout[t], p.laps[t]);
+                }
+
+                CheckGuards(genArena, "Profile");
+                NoteArenaPeak();
+
+                p.gen = gen;
+                p.built = true;
+            }
+
+            for (TrackBuild& b : builds)
+                FreeTrackBuild(b);
+
+            GP4MD_LOG_INFO(MagicData, "Profile %s: %s in %.3f ms (%zu bytes)\n", p.name.c_str(),
+                ok ? "built" : "build failed", Platform::NowMs() - start, ok ? genArena.PlannedBytes() : 0);
+            return ok;
+        }
+
+        // [General] ProfilePrebuild=1 (default): every profile not built yet
+        // is built now rather than on its first switch.
+        void PrebuildProfiles(const std::string& folder, const IniText::Document& globalIni)
+        {
+            if (g_Profiles.size() < 2 || GetGeneralInt(globalIni, "ProfilePrebuild", 1) == 0)
+                return;
+
+            const int threads = ResolveThreadCount(globalIni);
+            for (std::size_t i = 0; i < g_Profiles.size(); ++i)
+            {
+                if (!g_Profiles[i].built)
+                    BuildProfile(g_Profiles[i], folder, globalIni, threads);
+            }
+        }
+
+        // After the startup publish: the arena is the [RaceSettings] profile
+        void StartProfiles(const std::string& folder, const IniText::Document& globalIni,
+            const RaceConfig& race)
+        {
+            LoadProfiles(globalIni, race);
+            CaptureArenaProfile(g_Profiles[0]);
+            PrebuildProfiles(folder, globalIni);
+
+            if (g_Profiles.size() > 1)
+                GP4MD_LOG_INFO(MagicData, "Profile: %zu defined, %s active\n", g_Profiles.size() - 1, k_BaseProfile);
+        }
+    }
 
     // -------------------------------------------------------------------------
-    // Internal helpers
+    // Startup publish (end of PatchAllTracks)
+    // -------------------------------------------------------------------------
+    namespace
+    {
+        // End of PatchAllTracks: its cost and the startup profile, written
+        // next to GP4MD.ini as well with [General] StartupReport=json,csv
+        void ReportStartup(double startMs, int threads, bool fromSnapshot)
+        {
+            LogStartupCost(startMs);
+
+            const std::string& folder = g_Startup.ctx.folder;
+            const unsigned formats = Timing::ParseReportFormats(
+                GetGeneralText(g_Startup.globalIni, "StartupReport"));
+
+            Timing::Report(folder, formats, g_Startup.inputsMs, Platform::NowMs() - startMs,
+                threads, fromSnapshot);
+        }
+
+        // The arena holds every track: GP4's lap table, the hooks' generation
+        // and the race profiles follow it
+        void PublishStartup(double startMs, int threads, bool fromSnapshot)
+        {
+            {
+                Timing::Scope scope(Phase::LapTable);
+                Timing::AddBytes(Phase::LapTable, WriteLapTableToGP4());
+            }
+
+            Publish::Reset();
+            g_Published = true;
+
+            {
+                Timing::Scope scope(Phase::Profiles);
+                StartProfiles(g_Startup.ctx.folder, g_Startup.globalIni, g_Startup.race);
+            }
+
+            ReportStartup(startMs, threads, fromSnapshot);
+        }
+    }
+
     // -------------------------------------------------------------------------
-    static void WriteLapTableToGP4()
+    // SetTrackCount
+    // -------------------------------------------------------------------------
+    bool SetTrackCount(int count)
     {
-        // Original GP4 lap table location
-        auto* dst = MemUtils::addressToPtr<std::uint8_t>(GP4Addresses::LAP_TABLE_ADDR);
+        if (count < 1 || count > MAX_TRACK_COUNT)
+        {
+            GP4MD_LOG_ERROR(MagicData, "TrackCount %d out of range (1..%d)\n", count, MAX_TRACK_COUNT);
+            return false;
+        }
+
+        if (g_Published && count != g_TrackCount)
+        {
+            GP4MD_LOG_ERROR(MagicData, "TrackCount cannot change after tracks were published\n");
+            return false;
+        }
+
+        g_LayoutTable.assign(count, MagicBlockLayout{});
+        g_OrigLayout.assign(count, MagicBlockLayout{});
+        g_Layout = g_LayoutTable.data();
+        g_TrackCount = count;
+
+        Publish::Resize(count);
+        DatCache::Resize(count);
+        Overlay::Resize(count);
+        return true;
+    }
 
-        for (int t = 0; t < TRACK_COUNT; ++t)
+    namespace
+    {
+        // Maps and scans every .dat (unless the pack has it) and reads every
+        // Track INI, on the worker pool
+        void ReadTrackInputs(const std::string& folder, int threads)
         {
-            const std::uint8_t val = g_LapTable[t];
-            dst[t] = val;
+            Timing::Scope scope(Phase::ReadInputs);
+            TrackTiming*  timing = Timing::Tracks();
+
+            g_Startup.tracks.assign(g_TrackCount, TrackInput{});
+
+            RunOnPool(threads, [&](int t)
+                {
+                    // A pack entry replaces the .dat
+                    PackTrack packed;
+                    if (!Pack::Get(t, packed))
+                        DatCache::Preload(t);
+
+                    const double iniMs = Platform::NowMs();
+
+                    TrackInput& in = g_Startup.tracks[t];
+                    in.hasIni = ReadTrackIni(folder, t, in.sec, &timing[t].iniBytes);
 
-            Logging::LogMD("WriteLapTable GP4[%02d] = %u (addr=%p)\n",
-                t + 1, val, dst + t);
+                    timing[t].iniMs = Platform::NowMs() - iniMs;
+                    return true;
+                });
+
+            Timing::CaptureDatStats();
+            for (int t = 0; t < g_TrackCount; ++t)
+                Timing::AddBytes(Phase::ReadInputs, timing[t].datBytes + timing[t].iniBytes);
+
+            g_Startup.ctx.inputs = g_Startup.tracks.data();
+            g_Startup.deferred = false;
         }
     }
 
     // -------------------------------------------------------------------------
-    // Descriptor table initialization
+    // PrepareInputs
     // -------------------------------------------------------------------------
-    void InitDescTable()
+    bool PrepareInputs()
     {
-        std::size_t off = 0;
-        auto add = [&](int idx, DescType t, std::size_t size, const char* comment)
-            {
-                g_Desc[idx - 1] = { t, off, comment };
-                off += size;
-            };
-
-        // 1–24: setup bytes
-        add(1, DescType::SETUP_BYTE, 1, "Front wing [CC dry setup]");
-        add(2, DescType::SETUP_BYTE, 1, "Rear wing");
-        add(3, DescType::SETUP_BYTE, 1, "1st gear");
-        add(4, DescType::SETUP_BYTE, 1, "2nd");
-        add(5, DescType::SETUP_BYTE, 1, "3rd");
-        add(6, DescType::SETUP_BYTE, 1, "4th");
-        add(7, DescType::SETUP_BYTE, 1, "5th");
-        add(8, DescType::SETUP_BYTE, 1, "6th");
-
-        add(9, DescType::SETUP_BYTE, 1, "Front wing [CC wet setup]");
-        add(10, DescType::SETUP_BYTE, 1, "Rear wing");
-        add(11, DescType::SETUP_BYTE, 1, "1st gear");
-        add(12, DescType::SETUP_BYTE, 1, "2nd");
-        add(13, DescType::SETUP_BYTE, 1, "3rd");
-        add(14, DescType::SETUP_BYTE, 1, "4th");
-        add(15, DescType::SETUP_BYTE, 1, "5th");
-        add(16, DescType::SETUP_BYTE, 1, "6th");
-
-        add(17, DescType::SETUP_BYTE, 1, "Front wing [Player dry setup]");
-        add(18, DescType::SETUP_BYTE, 1, "Rear wing");
-        add(19, DescType::SETUP_BYTE, 1, "1st gear");
-        add(20, DescType::SETUP_BYTE, 1, "2nd");
-        add(21, DescType::SETUP_BYTE, 1, "3rd");
-        add(22, DescType::SETUP_BYTE, 1, "4th");
-        add(23, DescType::SETUP_BYTE, 1, "5th");
-        add(24, DescType::SETUP_BYTE, 1, "6th");
-
-        // 25: U32
-        add(25, DescType::U32, 4, "Dry brake balance");
-
-        // 26–33: setup bytes
-        add(26, DescType::SETUP_BYTE, 1, "Front wing [Player wet setup]");
-        add(27, DescType::SETUP_BYTE, 1, "Rear wing");
-        add(28, DescType::SETUP_BYTE, 1, "1st gear");
-        add(29, DescType::SETUP_BYTE, 1, "2nd");
-        add(30, DescType::SETUP_BYTE, 1, "3rd");
-        add(31, DescType::SETUP_BYTE, 1, "4th");
-        add(32, DescType::SETUP_BYTE, 1, "5th");
-        add(33, DescType::SETUP_BYTE, 1, "6th");
-
-        // 34: U32
-        add(34, DescType::U32, 4, "Wet brake balance");
-
-        // 35–36: U8
-        add(35, DescType::U8, 1, "Softer tyre [52 Hard, 53 Medium, 54 Soft, 55 Supersoft]");
-        add(36, DescType::U8, 1, "Harder tyre [52 Hard, 53 Medium, 54 Soft, 55 Supersoft]");
-
-        // 37: U16
-        add(37, DescType::U16, 2, ">= 50 AI chooses softer tyre, otherwise harder");
-
-        // 38–41: U16
-        add(38, DescType::U16, 2, "");
-        add(39, DescType::U16, 2, "");
-        add(40, DescType::U16, 2, "");
-        add(41, DescType::U16, 2, "");
-
-        // 42–46: U16
-        add(42, DescType::U16, 2, "Track grip");
-        add(43, DescType::U16, 2, "");
-        add(44, DescType::U16, 2, "");
-        add(45, DescType::U16, 2, "Temperature (deg C) - warmer = higher top speed, less grip (17–31)");
-        add(46, DescType::U16, 2, "Air Pressure (hPa) – affects PLAYER downforce & drag");
-
-        // 47–73: U16
-        add(47, DescType::U16, 2, "Engine power output (altitude simulation)");
-        add(48, DescType::U16, 2, "Fuel per lap (2979 = 1 kg/lap)");
-        add(49, DescType::U16, 2, "CC yield (higher = faster start)");
-        add(50, DescType::U16, 2, "Player tyre wear factor");
-        add(51, DescType::U16, 2, "CC aggressiveness min (Braking Range)");
-        add(52, DescType::U16, 2, "CC aggressiveness max (Braking Range)");
-
-        add(53, DescType::U16, 2, "[Ace] CC power factor");
-        add(54, DescType::U16, 2, "[Ace] CC grip factor");
-        add(55, DescType::U16, 2, "[Pro] CC power factor");
-        add(56, DescType::U16, 2, "[Pro] CC grip factor");
-        add(57, DescType::U16, 2, "[Semi-Pro] CC power factor");
-        add(58, DescType::U16, 2, "[Semi-Pro] CC grip factor");
-        add(59, DescType::U16, 2, "[Amateur] CC power factor");
-        add(60, DescType::U16, 2, "[Amateur] CC grip factor");
-        add(61, DescType::U16, 2, "[Rookie] CC power factor");
-        add(62, DescType::U16, 2, "[Rookie] CC grip factor");
-
-        add(63, DescType::U16, 2, "CC random performance range min");
-        add(64, DescType::U16, 2, "CC random performance range max");
-        add(65, DescType::U16, 2, "CC error chance");
-        add(66, DescType::U16, 2, "CC recovery sectors");
-
-        add(67, DescType::U16, 2, "Sectors to pit-in begin");
-        add(68, DescType::U16, 2, "Sectors to pit-out end");
-        add(69, DescType::U16, 2, "Pre-pit speed limit");
-
-        add(70, DescType::U16, 2, "Fuel consumption Player");
-        add(71, DescType::U16, 2, "Fuel consumption CC");
-        add(72, DescType::U16, 2, "Tyre wear");
-        add(73, DescType::U16, 2, "Sector where AI stop being cautious on lap 1");
-
-        // 74–77: U32
-        add(74, DescType::U32, 4, "Hotseat turn duration (70800 = 1:10.800)");
-        add(75, DescType::U32, 4, "Real-time factor (+/-1000 = +/-1.0)");
-        add(76, DescType::U32, 4, "Tyre change decision factor (dry↔wet)");
-        add(77, DescType::U32, 4, "Same as above?");
-        add(78, DescType::U16, 2, "Rain chance");
-
-        // 79–81: U16
-        add(79, DescType::U16, 2, "Segment start for pit in/out surface detection");
-        add(80, DescType::U16, 2, "Segment end for pit in/out surface detection");
-        add(81, DescType::U16, 2, "CC race grip (always 256)");
-
-        // 82–101: U32
-        add(82, DescType::U32, 4, "Time duration (ms) related to pits");
-        add(83, DescType::U32, 4, "Segment where player starts in quicklaps");
-        add(84, DescType::U32, 4, "Black Flag penalty (ms) (10000–30000)");
-        add(85, DescType::U32, 4, "Black Flag severity (1024 = 80 kph)");
-        add(86, DescType::U32, 4, "Wet CC engine mapping");
-        add(87, DescType::U32, 4, "Wet CC tyre wear & grip factor (higher = more)");
-        add(88, DescType::U32, 4, "Wet CC tyre wear factor (lower = more)");
-        add(89, DescType::U32, 4, "Wet CC grip factor (lower = more)");
-        add(90, DescType::U32, 4, "\"Handbrake\" – stop car moving in garage");
-        add(91, DescType::U32, 4, "Car depth in garage (Player)");
-        add(92, DescType::U32, 4, "Car depth in garage (AI)");
-        add(93, DescType::U32, 4, "Car orientation in garage");
-        add(94, DescType::U32, 4, "Pitstop stall depth from pitlane");
-        add(95, DescType::U32, 4, "Pitstop stall depth finetune");
-        add(96, DescType::U32, 4, "Tyre wear multiplier dry-soft (16384 = 100%)");
-        add(97, DescType::U32, 4, "Tyre wear multiplier dry-hard (16384 = 100%)");
-        add(98, DescType::U32, 4, "Tyre wear multiplier intermediate (16384 = 100%)");
-        add(99, DescType::U32, 4, "Tyre wear multiplier wet-soft (16384 = 100%)");
-        add(100, DescType::U32, 4, "Tyre wear multiplier wet-hard (16384 = 100%)");
-        add(101, DescType::U32, 4, "Tyre wear multiplier monsoon (16384 = 100%)");
-
-        // 102–139: U16
-        add(102, DescType::U16, 2, "Pitstop group 1 %");
-        add(103, DescType::U16, 2, "Stop 1");
-        add(104, DescType::U16, 2, "Pit window 1");
-        add(105, DescType::U16, 2, "");
-        add(106, DescType::U16, 2, "");
-        add(107, DescType::U16, 2, "");
-        add(108, DescType::U16, 2, "");
-        add(109, DescType::U16, 2, "");
-
-        add(110, DescType::U16, 2, "Pitstop group 2 %");
-        add(111, DescType::U16, 2, "Stop 1");
-        add(112, DescType::U16, 2, "Pit window 1");
-        add(113, DescType::U16, 2, "Stop 2");
-        add(114, DescType::U16, 2, "Pit window 2");
-        add(115, DescType::U16, 2, "");
-        add(116, DescType::U16, 2, "");
-        add(117, DescType::U16, 2, "");
-
-        add(118, DescType::U16, 2, "Pitstop group 3 %");
-        add(119, DescType::U16, 2, "Stop 1");
-        add(120, DescType::U16, 2, "Pit window 1");
-        add(121, DescType::U16, 2, "Stop 2");
-        add(122, DescType::U16, 2, "Pit window 2");
-        add(123, DescType::U16, 2, "Stop 3");
-        add(124, DescType::U16, 2, "Pit window 3");
-        add(125, DescType::U16, 2, "");
-
-        add(126, DescType::U16, 2, "Failure chance: suspension");
-        add(127, DescType::U16, 2, "Failure chance: loose wheel");
-        add(128, DescType::U16, 2, "Failure chance: puncture");
-        add(129, DescType::U16, 2, "Failure chance: engine");
-        add(130, DescType::U16, 2, "Failure chance: transmission");
-        add(131, DescType::U16, 2, "Failure chance: oil/water leak");
-        add(132, DescType::U16, 2, "Failure chance: throttle/brake");
-        add(133, DescType::U16, 2, "Failure chance: electrics");
-
-        add(134, DescType::U16, 2, "");
-        add(135, DescType::U16, 2, "");
-        add(136, DescType::U16, 2, "");
-        add(137, DescType::U16, 2, "");
-
-        add(138, DescType::U16, 2, "Bump factor");
-        add(139, DescType::U16, 2, "Bump shift");
+        const double startMs = Platform::NowMs();
+
+        g_Published = false;
+        ReleaseStartupInputs();
+        g_Startup = StartupInputs();
+        Timing::Begin();
+
+        // Profile generations go with the per-track tables SetTrackCount resets
+        g_Profiles.clear();
+        g_ActiveProfile = 0;
+
+        // 1) Resolve folder and global INI; the track count comes first since
+        //    it sizes every per-track table
+        const std::string folder = Platform::ModuleFolder();
+
+        IniText::Document& globalIni = g_Startup.globalIni;
+        IniText::LoadDocument(folder + "GP4MD.ini", globalIni);
+
+        ConfigureLogLevels(globalIni);
+        g_LogDefaults = GetGeneralInt(globalIni, "LogDefaults", g_LogDefaults) != 0;
+
+        ConfigureLogging(globalIni, folder);
+
+        if (!SetTrackCount(GetGeneralInt(globalIni, "TrackCount", DEFAULT_TRACK_COUNT)))
+            return false;
+
+        std::uint64_t globalBytes = 0, mtime = 0;
+        if (globalIni.present)
+            Platform::StatFile(folder + "GP4MD.ini", globalBytes, mtime);
+
+        Timing::AddPhase(Phase::GlobalIni, Platform::NowMs() - startMs, static_cast<std::size_t>(globalBytes));
+
+        // 2) [RaceSettings] and [Rules], compiled once
+        {
+            Timing::Scope scope(Phase::RaceSettings);
+
+            g_Startup.race = ParseRaceSettings(GlobalSection(globalIni, "RaceSettings"));
+            g_Startup.ctx = MakeContext(folder, globalIni, g_Startup.race);
+            g_Startup.ctx.timing = Timing::Tracks();
+        }
+
+        // 3) Pack: precompiled .dat + Track INI layers, mapped until the
+        //    prepare phase is done. PackCompile=1 rebuilds it from those
+        //    inputs instead.
+        g_Startup.packPath = PackPath(folder, globalIni);
+        g_Startup.compilePack = !g_Startup.packPath.empty() &&
+            GetGeneralInt(globalIni, "PackCompile", 0) != 0;
+
+        if (!g_Startup.packPath.empty() && !g_Startup.compilePack)
+        {
+            const double packMs = Platform::NowMs();
+            std::uint64_t packBytes = 0;
+
+            if (Pack::Open(g_Startup.packPath))
+                Platform::StatFile(g_Startup.packPath, packBytes, mtime);
+
+            Timing::AddPhase(Phase::PackOpen, Platform::NowMs() - packMs, static_cast<std::size_t>(packBytes));
+        }
+
+        // 4) Snapshot: with the stored inputs key still matching, the .dat and
+        //    Track INI reads are left to PatchAllTracks, which only needs them
+        //    if the restore fails. defaults.ini and VerifyPrepare need the
+        //    full path.
+        const int threads = ResolveThreadCount(globalIni);
+
+        g_Startup.snapshot = GetGeneralInt(globalIni, "Snapshot", 0) != 0 &&
+            !g_LogDefaults && GetGeneralInt(globalIni, "VerifyPrepare", 0) == 0;
+
+        if (g_Startup.snapshot)
+        {
+            Timing::Scope scope(Phase::Snapshot);
+
+            g_Startup.inputsKey = ComputeInputsKey(folder);
+            g_Startup.deferred = GetGeneralInt(globalIni, "SnapshotRebuild", 0) == 0 &&
+                SnapshotInputsMatch(folder, g_Startup.inputsKey);
+        }
+
+        // 5) Every .dat mapped and scanned, every Track INI read, on the
+        //    worker pool
+        if (!g_Startup.deferred)
+            ReadTrackInputs(folder, threads);
+
+        g_Startup.ready = true;
+        g_Startup.inputsMs = Platform::NowMs() - startMs;
+
+        GP4MD_LOG_INFO(MagicData, "PrepareInputs: %d tracks on %d thread(s) in %.3f ms%s\n",
+            g_TrackCount, threads, g_Startup.inputsMs, g_Startup.deferred ? " (reads deferred)" : "");
+        return true;
     }
 
     // -------------------------------------------------------------------------
@@ -245,212 +1130,444 @@ namespace MagicData
     // -------------------------------------------------------------------------
     bool PatchAllTracks()
     {
-        InitDescTable();
+        // 1) Inputs: already read when PrepareInputs ran ahead
+        if (!g_Startup.ready && !PrepareInputs())
+            return false;
+
+        const double startMs = Platform::NowMs();
+
+        const std::string&       folder = g_Startup.ctx.folder;
+        const IniText::Document& globalIni = g_Startup.globalIni;
+        const int                threads = ResolveThreadCount(globalIni);
+
+        // 2) Scan original GP4 layout to discover structure only: one pass
+        //    over all blocks
+        auto* base = Platform::AddressToPtr(BASE_TRACK1_ADDR);
 
-        // 1) Scan original GP4 layout to discover structure only
-        auto* base = MemUtils::addressToPtr<std::uint8_t>(BASE_TRACK1_ADDR);
+        std::vector<MagicBlockLayout> scanned(g_TrackCount);
+        const int found = MagicDataInternal::ScanAll(base, scanned.data());
 
-        for (int t = 0; t < TRACK_COUNT; ++t)
+        Timing::AddPhase(Phase::Scan, Platform::NowMs() - startMs,
+            found > 0 ? static_cast<std::size_t>(scanned[found - 1].bumpEnd - base) : 0);
+
+#ifdef _DEBUG
         {
-            g_Layout[t].origBase = base;
+            std::vector<MagicBlockLayout> reference(g_TrackCount);
+            const int refFound = MagicDataInternal::ScanAllScalar(base, reference.data());
 
-            MagicBlockLayout L = MagicDataInternal::Scan(base, t);
-            if (!L.valid)
+            for (int t = 0; t < g_TrackCount; ++t)
             {
-                Logging::LogMD("Track %02d scan failed\n", t + 1);
-                return false;
+                if (refFound != found || (t < found && reference[t].bumpEnd != scanned[t].bumpEnd))
+                {
+                    GP4MD_LOG_ERROR(MagicData, "Track %02d: vector scan differs from scalar scan\n", t + 1);
+                    break;
+                }
             }
+        }
+#endif
+
+        if (found < g_TrackCount)
+        {
+            GP4MD_LOG_ERROR(MagicData, "Track %02d scan failed (TrackCount=%d)\n", found + 1, g_TrackCount);
+            ReleaseStartupInputs();
+            return false;
+        }
+
+        // The lap table never starts with two zero lap counts, so FF FF 00 00
+        // after the last block means GP4.exe holds more blocks than configured
+        const std::uint8_t* lapStart = scanned[g_TrackCount - 1].bumpEnd;
+        if (lapStart[0] == 0x00 && lapStart[1] == 0x00)
+        {
+            GP4MD_LOG_ERROR(MagicData, "TrackCount=%d is lower than the blocks found in GP4.exe\n", g_TrackCount);
+            ReleaseStartupInputs();
+            return false;
+        }
+
+        for (int t = 0; t < g_TrackCount; ++t)
+        {
+            MagicBlockLayout& L = scanned[t];
+
+            L.origBase = L.base;
+            g_OrigLayout[t] = L;
 
+            g_Layout[t].origBase = L.base;
             g_Layout[t].bumpStart = L.bumpStart;
             g_Layout[t].bumpEnd = L.bumpEnd;
             g_Layout[t].bumpSize = L.bumpSize;
             g_Layout[t].valid = true;
-
-            base = L.bumpEnd;
         }
 
         // After last track, GP4's original lap table starts here
-        g_LapTableOrig = base;
+        g_LapTableOrig = scanned[g_TrackCount - 1].bumpEnd;
+        if (g_LapDefaults.size() != static_cast<std::size_t>(g_TrackCount))
+            g_LapDefaults.assign(g_LapTableOrig, g_LapTableOrig + g_TrackCount);
+
+        Hooks::BuildLookup();
+
+        const std::size_t lastDescEnd = LAST_DESC_END;
+
+        g_Arena.Reset(ReadArenaOptions(globalIni));
+        g_ArenaPeak = 0;
 
-        // 2) Compute relocated sizes inside static arena
-        const std::size_t lastDescEnd = g_Desc[DESC_COUNT - 1].offset + 2;
-        std::size_t       trackSize[TRACK_COUNT] = {};
-        std::size_t       totalSize = 0;
+        const bool verifyPrepare = GetGeneralInt(globalIni, "VerifyPrepare", 0) != 0;
+        const bool rebuildSnapshot = GetGeneralInt(globalIni, "SnapshotRebuild", 0) != 0;
 
-        for (int t = 0; t < TRACK_COUNT; ++t)
+        // 3) Snapshot: when no input changed, restore the finished arena and
+        //    skip all parsing
+        const bool saveSnapshot = g_Startup.snapshot;
+        std::uint64_t snapshotKey = 0;
+
+        if (saveSnapshot)
         {
-            const std::size_t bumpBytes =
-                static_cast<std::size_t>(g_Layout[t].bumpEnd - g_Layout[t].bumpStart);
+            const double snapshotMs = Platform::NowMs();
+            bool         restored = false;
+
+            snapshotKey = ComputeSnapshotKey(g_Startup.inputsKey);
+
+            if (rebuildSnapshot)
+            {
+                ++g_SnapshotStats.rebuilds;
+                GP4MD_LOG_INFO(IO, "Snapshot: rebuild forced by SnapshotRebuild=1\n");
+            }
+            else
+                restored = LoadSnapshot(folder, snapshotKey, g_Arena);
 
-            trackSize[t] = lastDescEnd + bumpBytes + 0x20;
-            totalSize += trackSize[t];
+            Timing::AddPhase(Phase::Snapshot, Platform::NowMs() - snapshotMs,
+                restored ? g_Arena.PlannedBytes() : 0);
+
+            if (restored)
+            {
+                ReleaseStartupInputs();
+                LogSnapshotStats();
+                NoteArenaPeak();
+                LogArenaUsage(g_Arena, "Arena");
+                PublishStartup(startMs, threads, true);
+                return true;
+            }
         }
 
-        totalSize += TRACK_COUNT; // relocated lap table
+        // The inputs key matched but the restore did not (GP4.exe bytes,
+        // layout, checksum): read what PrepareInputs skipped
+        if (g_Startup.deferred)
+            ReadTrackInputs(folder, threads);
+
+        // 4) Prepare: build every track's block and laps in private scratch
+        //    memory on a small worker pool from the inputs read ahead.
+        //    Nothing shared is written here.
+        const PrepareContext& ctx = g_Startup.ctx;
+
+        GP4MD_LOG_INFO(MagicData, "Preparing %d tracks on %d thread(s)\n", g_TrackCount, threads);
+
+        const double prepareMs = Platform::NowMs();
+
+        std::vector<TrackBuild> builds(g_TrackCount);
+        const bool prepared = RunPrepare(ctx, builds.data(), threads);
+
+        std::size_t patched = 0;
+        for (int t = 0; t < g_TrackCount; ++t)
+            patched += Timing::Tracks()[t].patchBytes;
+
+        Timing::AddPhase(Phase::Prepare, Platform::NowMs() - prepareMs, patched);
+
+        if (prepared && verifyPrepare && threads > 1)
+            VerifyPrepare(ctx, builds.data());
 
-        if (totalSize > g_StaticArena.size())
+        if (prepared && g_Startup.compilePack)
+            CompilePack(ctx, builds.data(), threads, g_Startup.packPath);
+
+        // All .dat and pack views have been consumed; unmap them
+        DatCache::LogStats();
+        ReleaseStartupInputs();
+
+        if (!prepared)
         {
-            Logging::LogMD("Static arena too small (needed=%zu, have=%zu)\n",
-                totalSize, g_StaticArena.size());
+            for (int t = 0; t < g_TrackCount; ++t)
+                FreeTrackBuild(builds[t]);
             return false;
         }
 
-        // 3) Assign relocated bases and relocated lap table
-        std::uint8_t* arena = g_StaticArena.data();
-        std::uint8_t* p = arena;
+        // 5) Arena: one allocation sized from the prepared blocks, so large
+        //    .dat bump regions fit without a fixed reservation
+        const double arenaMs = Platform::NowMs();
+
+        std::vector<std::size_t> blockBytes(g_TrackCount);
+        for (int t = 0; t < g_TrackCount; ++t)
+            blockBytes[t] = builds[t].size + MagicDataInternal::SLOT_TAIL;
+
+        const int  lapBlock = MagicDataInternal::PlanArena(g_Arena, blockBytes.data());
+        const bool allocated = g_Arena.Allocate();
 
-        for (int t = 0; t < TRACK_COUNT; ++t)
+        Timing::AddPhase(Phase::Arena, Platform::NowMs() - arenaMs, g_Arena.PlannedBytes());
+
+        if (!allocated)
         {
-            g_Layout[t].base = p;
-            p += trackSize[t];
+            GP4MD_LOG_ERROR(MagicData, "Arena allocation failed (%zu bytes)\n", g_Arena.PlannedBytes());
+            for (int t = 0; t < g_TrackCount; ++t)
+                FreeTrackBuild(builds[t]);
+            return false;
         }
 
-        g_LapTable = p;
+        NoteArenaPeak();
+
+        // 6) Commit: publish blocks into the arena in track order
+        const double placeMs = Platform::NowMs();
+
+        for (int t = 0; t < g_TrackCount; ++t)
+            g_Layout[t].base = g_Arena.BlockData(t);
 
-        // 4) Initialize relocated lap table, preferring laps from .dat when present
-        for (int t = 0; t < TRACK_COUNT; ++t)
+        g_LapTable = g_Arena.BlockData(lapBlock);
+
+        // Defaults of every track (if enabled) outlive the builds until the
+        // exporter has formatted them
+        std::vector<std::vector<std::uint8_t>> defaults(g_TrackCount);
+        std::vector<const std::uint8_t*>       defaultsBase(g_TrackCount, nullptr);
+
+        for (int t = 0; t < g_TrackCount; ++t)
         {
-            std::uint8_t baseLap = *(g_LapTableOrig + t);
+            TrackBuild& b = builds[t];
 
-            std::vector<std::uint8_t> dat;
-            int datLaps = 0;
-            if (LoadDatFile(t, dat) && ExtractLapsFromDat(dat, datLaps))
-            {
-                int tmp = datLaps;
-                if (tmp < 1)   tmp = 1;
-                if (tmp > 255) tmp = 255;
-                baseLap = static_cast<std::uint8_t>(tmp);
+            PlaceTrack(t, b, g_Layout[t].base, blockBytes[t], lastDescEnd, g_Layout[t], g_LapTable[t]);
 
-                Logging::LogMD("Track %02d laps from .dat = %d\n", t + 1, datLaps);
+            if (!b.defaults.empty())
+            {
+                defaults[t] = std::move(b.defaults);
+                defaultsBase[t] = defaults[t].data();
             }
 
-            *(g_LapTable + t) = baseLap;
+            FreeTrackBuild(b);
         }
 
-        // 5) Resolve folder and global INI
-        std::string folder;
+        std::size_t placed = 0;
+        for (int t = 0; t < g_TrackCount; ++t)
+            placed += blockBytes[t];
+
+        Timing::AddPhase(Phase::Place, Platform::NowMs() - placeMs, placed);
+
+        if (g_LogDefaults)
         {
-            char path[MAX_PATH]{};
-            HMODULE hMod = nullptr;
-            GetModuleHandleExA(
-                GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS |
-                GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
-                reinterpret_cast<LPCSTR>(&PatchAllTracks),
-                &hMod
-            );
-            GetModuleFileNameA(hMod, path, MAX_PATH);
-            std::string full(path);
-            const std::size_t pos = full.find_last_of("\\/");
-            folder = full.substr(0, pos + 1);
+            Timing::Scope scope(Phase::Defaults);
+
+            const unsigned formats = ParseDefaultsFormats(GetGeneralText(globalIni, "DefaultsFormat"));
+            WriteDefaults(folder, defaultsBase.data(), formats, threads);
         }
 
-        IniFile globalIni;
-        const bool hasGlobal = globalIni.load(folder + "GP4MD.ini");
+        CheckGuards(g_Arena, "Arena");
+        LogArenaUsage(g_Arena, "Arena");
 
-        if (hasGlobal && globalIni.hasSection("General") &&
-            globalIni.hasKey("General", "Log"))
+        if (saveSnapshot)
         {
-            g_EnableLogging = globalIni.get("General", "Log").getAs<int>() != 0;
+            Timing::Scope scope(Phase::SnapshotSave);
+
+            if (SaveSnapshot(folder, g_Startup.inputsKey, snapshotKey, g_Arena))
+                Timing::AddBytes(Phase::SnapshotSave, g_Arena.PlannedBytes());
+            LogSnapshotStats();
         }
 
-        if (hasGlobal && globalIni.hasSection("General") &&
-            globalIni.hasKey("General", "LogDefaults"))
+        // 7) Log relocated lap table
+        for (int i = 0; i < g_TrackCount; ++i)
         {
-            g_LogDefaults = globalIni.get("General", "LogDefaults").getAs<int>() != 0;
+            std::uint8_t* addr = g_LapTable + i;
+            const std::uint8_t val = *addr;
+
+            GP4MD_LOG_DEBUG(MagicData, "Track %02d relocLaps=%u addr=%p\n",
+                i + 1, val, addr);
         }
 
-        BeginDefaultsFile(folder);
+        PublishStartup(startMs, threads, false);
+        return true;
+    }
 
-        // 6) Build relocated magicdata blocks per track
-        for (int t = 0; t < TRACK_COUNT; ++t)
-        {
-            std::uint8_t* dstBase = g_Layout[t].base;
-            std::uint8_t* origBase = g_Layout[t].origBase;
+    // -------------------------------------------------------------------------
+    // CheckArena
+    // -------------------------------------------------------------------------
+    int CheckArena()
+    {
+        return CheckGuards(g_Arena, "Arena");
+    }
 
-            // 6a) Start with original descriptor region as fallback
-            std::memcpy(dstBase, origBase, lastDescEnd);
+    // -------------------------------------------------------------------------
+    // ReloadTracks
+    // -------------------------------------------------------------------------
+    bool ReloadTracks(TrackMask trackMask)
+    {
+        if (!g_Published)
+            return false;
 
-            // 6b) Try to load .dat magicdata and overwrite descriptor + bump region
-            std::vector<std::uint8_t> dat;
-            std::uint8_t* datMd = nullptr;
-            std::size_t   datMdSize = 0;
-            bool          hasDatMagic = false;
+        const double start = Platform::NowMs();
+        const std::string folder = Platform::ModuleFolder();
 
-            if (LoadDatFile(t, dat))
-            {
-                datMd = FindMagicDataInDat(dat, datMdSize);
-                if (datMd)
-                {
-                    Logging::LogMD("Track %2d: using .dat magicdata (size=%zu)\n",
-                        t + 1, datMdSize);
+        IniText::Document globalIni;
+        IniText::LoadDocument(folder + "GP4MD.ini", globalIni);
 
-                    // Copy descriptor region from .dat (clamped to descriptor size)
-                    std::size_t payload = datMdSize;
-                    if (payload > lastDescEnd)
-                        payload = lastDescEnd;
+        ConfigureLogLevels(globalIni);
 
-                    std::memcpy(dstBase, datMd, payload);
-                    hasDatMagic = true;
-                }
-            }
+        // Tracks are rebuilt with the active profile as GP4MD.ini now defines
+        // it; the built profiles are dropped and rebuilt after the commit
+        LoadProfiles(globalIni, ParseRaceSettings(GlobalSection(globalIni, "RaceSettings")));
+        const PrepareContext ctx = MakeContext(folder, globalIni, g_Profiles[g_ActiveProfile].race);
 
-            // 6c) Copy bump region: prefer .dat bump region when .dat magicdata is present
-            const std::size_t bumpBytesOrig =
-                static_cast<std::size_t>(g_Layout[t].bumpEnd - g_Layout[t].bumpStart);
+        // The pack as it is now (a rewritten pack applies from this reload on)
+        const std::string packPath = PackPath(folder, globalIni);
+        if (!packPath.empty())
+            Pack::Open(packPath);
 
-            std::uint8_t* dstBumpStart = dstBase + lastDescEnd;
+        // defaults.ini describes startup state only
+        const bool logDefaults = g_LogDefaults;
+        g_LogDefaults = false;
 
-            if (hasDatMagic && datMdSize > lastDescEnd)
-            {
-                // .dat layout: descriptor [0..lastDescEnd), bump [lastDescEnd..terminator]
-                const std::size_t datBumpBytes = datMdSize - lastDescEnd;
+        // Generations the hooks have moved past since the last reload
+        Publish::Reclaim();
+        CheckArena();
 
-                std::memcpy(dstBumpStart, datMd + lastDescEnd, datBumpBytes);
+        std::vector<TrackBuild> builds(g_TrackCount);
+        Memory::Arena           genArena(g_Arena.Options());
+        std::vector<int>        blockOf(g_TrackCount, 0);
+        TrackMask               rebuiltMask = 0;
+        int                     rebuilt = 0;
+        bool                    ok = true;
 
-                g_Layout[t].bumpStart = dstBumpStart;
-                g_Layout[t].bumpEnd = dstBumpStart + datBumpBytes;
-                g_Layout[t].bumpSize = datBumpBytes;
-            }
-            else
-            {
-                // Fallback: original GP4 bump region
-                std::memcpy(dstBumpStart, g_Layout[t].bumpStart, bumpBytesOrig);
+        for (int t = 0; t < g_TrackCount; ++t)
+        {
+            if (!(trackMask & (TrackMask(1) << t)))
+                continue;
+
+            const double t0 = Platform::NowMs();
 
-                g_Layout[t].bumpStart = dstBumpStart;
-                g_Layout[t].bumpEnd = dstBumpStart + bumpBytesOrig;
-                g_Layout[t].bumpSize = bumpBytesOrig;
+            if (!PrepareTrack(t, ctx, builds[t]))
+            {
+                GP4MD_LOG_ERROR(MagicData, "Reload: Track %02d rebuild failed, keeping previous block\n", t + 1);
+                FreeTrackBuild(builds[t]);
+                ok = false;
+                continue;
             }
 
-            // 6d) Dump defaults for this track (if enabled)
-            WriteDefaultTrack(t, dstBase);
+            rebuiltMask |= TrackMask(1) << t;
+            blockOf[t] = genArena.Reserve(builds[t].size + MagicDataInternal::SLOT_TAIL, t);
+            ++rebuilt;
 
-            // 6e) Track INI + RaceSettings on relocated block
-            char file[64];
-            std::snprintf(file, sizeof(file), "Track%02d.ini", t + 1);
-            IniFile ini;
+            GP4MD_LOG_INFO(MagicData, "Reload: Track %02d rebuilt in %.3f ms\n",
+                t + 1, Platform::NowMs() - t0);
+        }
 
-            if (ini.load(folder + file))
-            {
-                MagicDataInternal::PatchTrack(dstBase, ini, globalIni, t);
+        g_LogDefaults = logDefaults;
+
+        DatCache::Release();
+        Pack::Close();
+
+        // New generation: the blocks GP4 may be using stay untouched until
+        // Publish::Reclaim sees that no hook can still hand them out.
+        std::uint8_t* gen = rebuiltMask ? Publish::NewGeneration(genArena.PlannedBytes()) : nullptr;
+        if (rebuiltMask && !gen)
+        {
+            GP4MD_LOG_ERROR(MagicData, "Reload: generation allocation failed (%zu bytes)\n",
+                genArena.PlannedBytes());
+            rebuiltMask = 0;
+            rebuilt = 0;
+            ok = false;
+        }
+
+        if (gen)
+        {
+            genArena.Attach(gen);
+            NoteArenaPeak();
+        }
 
-                if (hasGlobal)
-                    ApplyRaceSettings(globalIni, ini, t);
+        for (int t = 0; t < g_TrackCount; ++t)
+        {
+            if (rebuiltMask & (TrackMask(1) << t))
+            {
+                const int id = blockOf[t];
+                PlaceTrack(t, builds[t], genArena.BlockData(id), genArena.Blocks()[id].size,
+                    ctx.lastDescEnd, g_Layout[t], g_LapTable[t]);
             }
+
+            FreeTrackBuild(builds[t]);
+        }
+
+        if (rebuiltMask)
+        {
+            CheckGuards(genArena, "Reload");
+            LogArenaUsage(genArena, "Reload");
+
+            Publish::Commit(gen, rebuiltMask);
+            WriteLapTableToGP4();
         }
 
-        EndDefaultsFile();
+        PrebuildProfiles(folder, globalIni);
 
-        // 7) Log relocated lap table
-        for (int i = 0; i < TRACK_COUNT; ++i)
+        Publish::LogStats();
+        Hooks::LogStats();
+
+        GP4MD_LOG_INFO(MagicData, "Reload: %d track(s) republished in %.3f ms\n",
+            rebuilt, Platform::NowMs() - start);
+        return ok;
+    }
+
+    // -------------------------------------------------------------------------
+    // Race profiles
+    // -------------------------------------------------------------------------
+    int ProfileCount()
+    {
+        return g_Profiles.empty() ? 0 : static_cast<int>(g_Profiles.size()) - 1;
+    }
+
+    bool ActivateProfile(const std::string& name)
+    {
+        if (!g_Published || g_Profiles.empty())
+            return false;
+
+        const int index = FindProfile(name);
+        if (index < 0)
         {
-            std::uint8_t* addr = g_LapTable + i;
-            const std::uint8_t val = *addr;
+            GP4MD_LOG_INFO(MagicData, "Profile: %s is not defined\n", name.c_str());
+            return false;
+        }
 
-            Logging::LogMD("Track %02d relocLaps=%u addr=%p\n",
-                i + 1, val, addr);
+        Profile& p = g_Profiles[index];
+
+        if (!p.built)
+        {
+            const std::string folder = Platform::ModuleFolder();
+
+            IniText::Document globalIni;
+            IniText::LoadDocument(folder + "GP4MD.ini", globalIni);
+
+            Publish::Reclaim();
+            if (!BuildProfile(p, folder, globalIni, ResolveThreadCount(globalIni)))
+                return false;
+        }
+
+        // The switch: pointers, one epoch bump, then GP4's lap table
+        const double start = Platform::NowMs();
+
+        for (int t = 0; t < g_TrackCount; ++t)
+        {
+            const MagicBlockLayout& L = p.layout[t];
+            g_Layout[t].base = L.base;
+            g_Layout[t].bumpStart = L.bumpStart;
+            g_Layout[t].bumpEnd = L.bumpEnd;
+            g_Layout[t].bumpSize = L.bumpSize;
         }
 
+        std::memcpy(g_LapTable, p.laps.data(), g_TrackCount);
+        Publish::Commit(p.gen, ~TrackMask(0) >> (MAX_TRACK_COUNT - g_TrackCount));
+
+        const double swapped = Platform::NowMs();
         WriteLapTableToGP4();
+        const double done = Platform::NowMs();
+
+        g_ActiveProfile = index;
+
+        GP4MD_LOG_INFO(MagicData, "Profile: %s active in %.1f us (blocks %.1f us, lap table %.1f us)\n",
+            p.name.c_str(), (done - start) * 1000.0, (swapped - start) * 1000.0, (done - swapped) * 1000.0);
         return true;
     }
 }
+
+namespace MagicDataInternal
+{
+    const IniText::Document& StartupIni()
+    {
+        return MagicData::g_Startup.globalIni;
+    }
+}
@@ -1,24 +1,18 @@
 #pragma once
-#include <Windows.h>
 #include <cstdint>
 #include <cstddef>
 #include <string>
 #include "../Core/GP4Addresses.h"
+#include "MagicData_Schema.h"
 
 namespace MagicData
 {
-    constexpr int   TRACK_COUNT = 17;
-    constexpr int   DESC_COUNT = 139;
-    constexpr DWORD BASE_TRACK1_ADDR = GP4Addresses::BASE_TRACK1_ADDR;
+    constexpr int           DEFAULT_TRACK_COUNT = 17; // GP4's own season
+    constexpr int           MAX_TRACK_COUNT = 64;     // one bit per track in TrackMask
+    constexpr std::uint32_t BASE_TRACK1_ADDR = GP4Addresses::BASE_TRACK1_ADDR;
 
-    enum class DescType { SETUP_BYTE, U8, U16, U32 };
-
-    struct DescInfo
-    {
-        DescType    type{};
-        std::size_t offset{};
-        const char* comment{};
-    };
+    // Bit t = track slot t (bit 0 = Track01)
+    using TrackMask = std::uint64_t;
 
     struct MagicBlockLayout
     {
@@ -32,17 +26,62 @@ namespace MagicData
 
     extern std::uint8_t* g_LapTable;      // relocated lap table (used everywhere)
     extern std::uint8_t* g_LapTableOrig;  // original GP4 lap table (for reference)
-    extern bool          g_EnableLogging;
     extern bool          g_LogDefaults;
 
-    extern MagicBlockLayout g_Layout[TRACK_COUNT];
-    extern DescInfo         g_Desc[DESC_COUNT];
+    // Track slots of this session ([General] TrackCount). Every per-track
+    // table is a contiguous array of this many entries.
+    extern int              g_TrackCount;
+    extern MagicBlockLayout* g_Layout;
     extern int              g_CurrentTrackIndex;
 
-    void BeginDefaultsFile(const std::string& folder);
-    void EndDefaultsFile();
-    void WriteDefaultTrack(int trackIndex, std::uint8_t* descBase);
+    // Sizes all per-track tables for count slots (1..MAX_TRACK_COUNT) and
+    // clears them. Only before the hooks are installed.
+    bool SetTrackCount(int count);
+
+    // defaults.* dump formats ([General] DefaultsFormat, comma-separated)
+    constexpr unsigned DEFAULTS_INI = 1u << 0;  // defaults.ini, TrackNN.ini layout
+    constexpr unsigned DEFAULTS_CSV = 1u << 1;  // defaults.csv, track,key,value rows
+    constexpr unsigned DEFAULTS_JSON = 1u << 2; // defaults.json, "TrackNN": { "descN": value }
+    constexpr unsigned DEFAULTS_BIN = 1u << 3;  // defaults.bin, "GP4MDDF1", u32 tracks,
+                                                // u32 bytes per track, raw descriptor regions
+
+    // Format names ("ini,csv,json,bin") to DEFAULTS_* flags; DEFAULTS_INI
+    // when none is recognised.
+    unsigned ParseDefaultsFormats(const std::string& text);
+
+    // When g_LogDefaults is set, writes each requested format from every
+    // track's descriptor region before INI overrides (descBase[t], one per
+    // track slot), formatting tracks on up to threads workers.
+    bool WriteDefaults(const std::string& folder, const std::uint8_t* const* descBase,
+        unsigned formats, int threads);
 
-    void InitDescTable();
+    // Everything of the startup that does not need GP4's memory: GP4MD.ini,
+    // logging, TrackCount, [RaceSettings] and [Rules], the pack, every .dat
+    // mapped and scanned and every Track INI read. Safe before gpxtrack.gxm
+    // is loaded; PatchAllTracks consumes the result (or calls it first).
+    bool PrepareInputs();
+
+    // Scans GP4's blocks, builds and publishes every track from the inputs
+    // of PrepareInputs and releases them.
     bool PatchAllTracks();
+
+    // Guard bytes (ArenaGuard in [General]) of the relocated blocks; logs and
+    // returns the number of blocks written past their end.
+    int CheckArena();
+
+    // Rebuilds the tracks whose bit is set (bit 0 = Track01) from their
+    // current inputs and publishes them as a new generation (see
+    // MagicData_Publish.h). Only valid after a successful PatchAllTracks.
+    bool ReloadTracks(TrackMask trackMask);
+
+    // Race profiles: [RaceSettings] (profile "RaceSettings") and each
+    // [Profile.<Name>] of GP4MD.ini as a whole season, built at startup
+    // ([General] ProfilePrebuild=0: on first use) and after every reload.
+    // Activating a built profile swaps the published blocks and rewrites
+    // GP4's lap table. Same writer as ReloadTracks; false when the name is
+    // unknown or the build failed. An empty name is "RaceSettings".
+    bool ActivateProfile(const std::string& name);
+
+    // [Profile.<Name>] sections found by the last PatchAllTracks or reload.
+    int ProfileCount();
 }
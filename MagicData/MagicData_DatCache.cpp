@@ -0,0 +1,128 @@
+#include "MagicData_DatCache.h"
+#include "../Core/Logging.h"
+#include "../Core/Platform.h"
+#include <string>
+#include <vector>
+
+namespace MagicData
+{
+    namespace
+    {
+        struct DatEntry
+        {
+            Platform::MappedFile file{};
+            DatView              dat{};
+            DatLoadStats         stats{};
+            bool                 attempted = false;
+        };
+
+        std::vector<DatEntry> g_Dat;
+
+        void Unmap(DatEntry& e)
+        {
+            Platform::UnmapFile(e.file);
+            e = DatEntry{};
+        }
+
+        void Map(int trackIndex, DatEntry& e)
+        {
+            e.attempted = true;
+
+            const std::string path = GetDatPath(trackIndex);
+            if (path.empty())
+                return;
+
+            const double t0 = Platform::NowMs();
+
+            if (!Platform::MapFileRead(path, e.file))
+                return;
+
+            const double t1 = Platform::NowMs();
+
+            e.dat.data = e.file.data;
+            e.dat.size = e.file.size;
+
+            ScanDatMarkers(e.dat.data, e.dat.size, e.dat.markers);
+            e.dat.hasMarkers = true;
+
+            const double t2 = Platform::NowMs();
+
+            e.stats.bytesRead = e.dat.size;
+            e.stats.loadMs = t1 - t0;
+            e.stats.scanMs = t2 - t1;
+            e.stats.present = true;
+        }
+    }
+
+    namespace DatCache
+    {
+        void Resize(int trackCount)
+        {
+            Release();
+            g_Dat.assign(trackCount, DatEntry{});
+        }
+
+        bool Get(int trackIndex, DatView& out)
+        {
+            out = DatView{};
+            if (trackIndex < 0 || trackIndex >= static_cast<int>(g_Dat.size()))
+                return false;
+
+            DatEntry& e = g_Dat[trackIndex];
+            if (!e.attempted)
+                Map(trackIndex, e);
+
+            ++e.stats.requests;
+            if (!e.stats.present)
+                return false;
+
+            out = e.dat;
+            return true;
+        }
+
+        void Preload(int trackIndex)
+        {
+            if (trackIndex < 0 || trackIndex >= static_cast<int>(g_Dat.size()))
+                return;
+
+            DatEntry& e = g_Dat[trackIndex];
+            if (!e.attempted)
+                Map(trackIndex, e);
+        }
+
+        const DatLoadStats& Stats(int trackIndex)
+        {
+            return g_Dat[trackIndex].stats;
+        }
+
+        void LogStats()
+        {
+            std::size_t totalBytes = 0;
+            double      totalMs = 0.0;
+            double      totalScanMs = 0.0;
+
+            for (int t = 0; t < static_cast<int>(g_Dat.size()); ++t)
+            {
+                const DatLoadStats& s = g_Dat[t].stats;
+                if (!s.present)
+                    continue;
+
+                GP4MD_LOG_DEBUG(IO, "Track %02d .dat: %zu bytes, load %.3f ms, scan %.3f ms, %d request(s)\n",
+                    t + 1, s.bytesRead, s.loadMs, s.scanMs, s.requests);
+
+                totalBytes += s.bytesRead;
+                totalMs += s.loadMs;
+                totalScanMs += s.scanMs;
+            }
+
+            GP4MD_LOG_INFO(IO, "DatCache total: %zu bytes, load %.3f ms, scan %.3f ms (%s)\n",
+                totalBytes, totalMs, totalScanMs, DatScanPathName());
+        }
+
+        void Release()
+        {
+            for (DatEntry& e : g_Dat)
+                Unmap(e);
+        }
+    }
+}
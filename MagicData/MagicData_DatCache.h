@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "MagicData.h"
+#include "MagicData_IO.h"
+
+namespace MagicData
+{
+    struct DatLoadStats
+    {
+        std::size_t bytesRead = 0;   // bytes mapped for this track's .dat
+        double      loadMs = 0.0;    // open + map time
+        double      scanMs = 0.0;    // marker scan time
+        int         requests = 0;    // number of Get() calls served
+        bool        present = false; // .dat exists and is non-empty
+    };
+
+    // Maps each Circuits\S1CTnn.DAT read-only at most once per PatchAllTracks
+    // run and hands out zero-copy views to the lap and magicdata extractors.
+    // The MA03 / terminator / laps| markers are scanned once at map time.
+    // Views stay valid until Release().
+    namespace DatCache
+    {
+        // One entry per track slot (from SetTrackCount); releases all views.
+        void Resize(int trackCount);
+
+        bool Get(int trackIndex, DatView& out);
+
+        // Maps and scans the track's .dat ahead of its first Get (not counted
+        // as a request). One track per thread at a time, as Get.
+        void Preload(int trackIndex);
+
+        const DatLoadStats& Stats(int trackIndex);
+        void LogStats();
+
+        void Release();
+    }
+}
@@ -1,73 +1,333 @@
 #include <cstdio>
+#include <cstring>
 #include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
 #include "MagicData.h"
+#include "MagicData_Timing.h"
 #include "../Core/Logging.h"
+#include "../Core/FileIO.h"
+#include "../Core/IniText.h"
+#include "../Core/Platform.h"
 
 namespace MagicData
 {
-    // This module is only used to extract baseline magicdata into defaults.ini
+    // This module is only used to extract baseline magicdata into defaults.*
     // for analysis / template generation. It is fully controlled by g_LogDefaults.
+    //
+    // Every track is formatted into its own buffer on a small worker pool;
+    // each file is then written with a single fwrite.
 
-    static std::FILE* g_DefaultsFile = nullptr;
-
-    void BeginDefaultsFile(const std::string& folder)
+    namespace
     {
-        if (!g_LogDefaults)
-            return;
+        constexpr char        k_BinMagic[8] = { 'G', 'P', '4', 'M', 'D', 'D', 'F', '1' };
+        constexpr std::size_t k_TrackReserve = DESC_COUNT * 48;
+
+        struct FormatInfo
+        {
+            unsigned    flag;
+            const char* name; // DefaultsFormat value and file extension
+        };
 
-        const std::string path = folder + "defaults.ini";
+        const FormatInfo k_Formats[] = {
+            { DEFAULTS_INI,  "ini"  },
+            { DEFAULTS_CSV,  "csv"  },
+            { DEFAULTS_JSON, "json" },
+            { DEFAULTS_BIN,  "bin"  },
+        };
 
-        std::FILE* f = nullptr;
-        if (fopen_s(&f, path.c_str(), "w") != 0 || !f)
+        // Decimal digits without printf (std::to_chars is C++17)
+        void AppendInt(std::string& out, int value)
         {
-            Logging::LogMD("Could not open defaults.ini for writing\n");
-            return;
+            char buf[12];
+            char* p = buf + sizeof(buf);
+
+            std::uint32_t u = value < 0 ? 0u - static_cast<std::uint32_t>(value)
+                                        : static_cast<std::uint32_t>(value);
+            do
+            {
+                *--p = static_cast<char>('0' + u % 10);
+                u /= 10;
+            } while (u);
+
+            if (value < 0)
+                *--p = '-';
+
+            out.append(p, buf + sizeof(buf) - p);
+        }
+
+        void AppendTrackName(std::string& out, int trackIndex)
+        {
+            const int n = trackIndex + 1;
+            out += "Track";
+            out += static_cast<char>('0' + n / 10 % 10);
+            out += static_cast<char>('0' + n % 10);
         }
 
-        g_DefaultsFile = f;
+        int DescValue(const std::uint8_t* descBase, const DescInfo& D)
+        {
+            const std::uint8_t* addr = descBase + D.offset;
+
+            switch (D.type)
+            {
+            case DescType::SETUP_BYTE:
+                return static_cast<int>(*addr) - 151;
+            case DescType::U8:
+                return *addr;
+            case DescType::U16:
+            {
+                std::uint16_t v;
+                std::memcpy(&v, addr, sizeof(v));
+                return v;
+            }
+            case DescType::U32:
+            {
+                std::uint32_t v;
+                std::memcpy(&v, addr, sizeof(v));
+                return static_cast<int>(v);
+            }
+            }
+
+            return 0;
+        }
+
+        // [TrackNN] then "descN = value    ; comment" per descriptor
+        void FormatIni(std::string& out, int t, const std::uint8_t* descBase)
+        {
+            out += '[';
+            AppendTrackName(out, t);
+            out += "]\n";
+
+            for (int d = 1; d <= DESC_COUNT; ++d)
+            {
+                const DescInfo& D = g_Desc[d - 1];
+
+                out += DescKey(d);
+                out += " = ";
+                AppendInt(out, DescValue(descBase, D));
+                out += "    ; ";
+                if (D.comment)
+                    out += D.comment;
+                out += '\n';
+            }
+
+            out += '\n';
+        }
+
+        // One row per descriptor: track,key,value
+        void FormatCsv(std::string& out, int t, const std::uint8_t* descBase)
+        {
+            for (int d = 1; d <= DESC_COUNT; ++d)
+            {
+                AppendInt(out, t + 1);
+                out += ',';
+                out += DescKey(d);
+                out += ',';
+                AppendInt(out, DescValue(descBase, g_Desc[d - 1]));
+                out += '\n';
+            }
+        }
+
+        // One member of the top-level object: "TrackNN": { "descN": value, ... }
+        void FormatJson(std::string& out, int t, const std::uint8_t* descBase)
+        {
+            out += t ? ",\n  \"" : "  \"";
+            AppendTrackName(out, t);
+            out += "\": {";
+
+            for (int d = 1; d <= DESC_COUNT; ++d)
+            {
+                out += d > 1 ? ", \"" : "\"";
+                out += DescKey(d);
+                out += "\": ";
+                AppendInt(out, DescValue(descBase, g_Desc[d - 1]));
+            }
+
+            out += '}';
+        }
+
+        // Raw descriptor region, as stored in GP4
+        void FormatBin(std::string& out, int, const std::uint8_t* descBase)
+        {
+            out.append(reinterpret_cast<const char*>(descBase), LAST_DESC_END);
+        }
+
+        void FormatTrack(unsigned format, std::string& out, int t, const std::uint8_t* descBase)
+        {
+            switch (format)
+            {
+            case DEFAULTS_INI:  FormatIni(out, t, descBase);  break;
+            case DEFAULTS_CSV:  FormatCsv(out, t, descBase);  break;
+            case DEFAULTS_JSON: FormatJson(out, t, descBase); break;
+            case DEFAULTS_BIN:  FormatBin(out, t, descBase);  break;
+            }
+        }
+
+        void AppendU32(std::string& out, std::uint32_t v)
+        {
+            for (int i = 0; i < 4; ++i)
+                out += static_cast<char>(v >> (i * 8));
+        }
+
+        // Text formats keep the platform's line endings, as defaults.ini did
+        bool WriteFile(const std::string& path, const std::vector<std::string>& parts, bool binary)
+        {
+            std::size_t total = 0;
+            for (const std::string& p : parts)
+                total += p.size();
+
+            std::string all;
+            all.reserve(total);
+            for (const std::string& p : parts)
+                all += p;
+
+            std::FILE* f = OpenFile(path.c_str(), binary ? "wb" : "w");
+            if (!f)
+                return false;
+
+            const bool ok = std::fwrite(all.data(), 1, all.size(), f) == all.size();
+            return std::fclose(f) == 0 && ok;
+        }
     }
 
-    void EndDefaultsFile()
+    unsigned ParseDefaultsFormats(const std::string& text)
     {
-        if (g_DefaultsFile)
-            std::fclose(g_DefaultsFile);
+        unsigned formats = 0;
+        std::size_t pos = 0;
 
-        g_DefaultsFile = nullptr;
+        while (pos <= text.size())
+        {
+            std::size_t comma = text.find(',', pos);
+            if (comma == std::string::npos)
+                comma = text.size();
+
+            std::string name = text.substr(pos, comma - pos);
+            name.erase(0, name.find_first_not_of(" \t"));
+            name.erase(name.find_last_not_of(" \t") + 1);
+
+            bool known = name.empty();
+            for (const FormatInfo& fi : k_Formats)
+            {
+                if (IniText::EqualsNoCase(name.c_str(), fi.name))
+                {
+                    formats |= fi.flag;
+                    known = true;
+                }
+            }
+
+            if (!known)
+                GP4MD_LOG_INFO(IO, "DefaultsFormat: ignored unknown format \"%s\"\n", name.c_str());
+
+            pos = comma + 1;
+        }
+
+        return formats ? formats : DEFAULTS_INI;
     }
 
-    void WriteDefaultTrack(int trackIndex, std::uint8_t* descBase)
+    bool WriteDefaults(const std::string& folder, const std::uint8_t* const* descBase,
+        unsigned formats, int threads)
     {
-        if (!g_LogDefaults || !g_DefaultsFile)
-            return;
+        if (!g_LogDefaults)
+            return true;
 
-        std::fprintf(g_DefaultsFile, "[Track%02d]\n", trackIndex + 1);
+        const double t0 = Platform::NowMs();
 
-        for (int d = 1; d <= DESC_COUNT; ++d)
+        const int count = g_TrackCount;
+
+        // parts[f * count + t]: track t in the f-th requested format
+        std::vector<const FormatInfo*> selected;
+        for (const FormatInfo& fi : k_Formats)
         {
-            const DescInfo& D = g_Desc[d - 1];
-            std::uint8_t* addr = descBase + D.offset;
+            if (formats & fi.flag)
+                selected.push_back(&fi);
+        }
 
-            int value = 0;
-            switch (D.type)
+        std::vector<std::string> parts(selected.size() * count);
+        std::vector<double>      partMs(parts.size(), 0.0);
+        std::atomic<int>         next(0);
+        const int                jobs = static_cast<int>(parts.size());
+
+        auto worker = [&]()
             {
-            case DescType::SETUP_BYTE:
-                value = static_cast<int>(*addr) - 151;
-                break;
-            case DescType::U8:
-                value = *addr;
-                break;
-            case DescType::U16:
-                value = *reinterpret_cast<std::uint16_t*>(addr);
-                break;
-            case DescType::U32:
-                value = *reinterpret_cast<std::uint32_t*>(addr);
-                break;
+                for (int j = next++; j < jobs; j = next++)
+                {
+                    const int t = j % count;
+                    if (!descBase[t])
+                        continue;
+
+                    const double start = Platform::NowMs();
+
+                    std::string& out = parts[j];
+                    out.reserve(k_TrackReserve);
+                    FormatTrack(selected[j / count]->flag, out, t, descBase[t]);
+
+                    partMs[j] = Platform::NowMs() - start;
+                }
+            };
+
+        if (threads < 1)
+            threads = 1;
+        if (threads > jobs)
+            threads = jobs;
+
+        std::vector<std::thread> pool;
+        for (int i = 1; i < threads; ++i)
+            pool.emplace_back(worker);
+
+        worker();
+
+        for (std::thread& th : pool)
+            th.join();
+
+        TrackTiming* timing = Timing::Tracks();
+        for (int j = 0; j < jobs; ++j)
+            timing[j % count].defaultsMs += partMs[j];
+
+        bool        ok = true;
+        std::size_t bytes = 0;
+
+        for (std::size_t f = 0; f < selected.size(); ++f)
+        {
+            std::vector<std::string> file;
+            file.reserve(count + 2);
+
+            // Format framing around the per-track parts
+            if (selected[f]->flag == DEFAULTS_CSV)
+                file.emplace_back("track,key,value\n");
+            else if (selected[f]->flag == DEFAULTS_JSON)
+                file.emplace_back("{\n");
+            else if (selected[f]->flag == DEFAULTS_BIN)
+            {
+                std::string hdr(k_BinMagic, sizeof(k_BinMagic));
+                AppendU32(hdr, static_cast<std::uint32_t>(count));
+                AppendU32(hdr, static_cast<std::uint32_t>(LAST_DESC_END));
+                file.push_back(hdr);
+            }
+
+            for (int t = 0; t < count; ++t)
+                file.push_back(std::move(parts[f * count + t]));
+
+            if (selected[f]->flag == DEFAULTS_JSON)
+                file.emplace_back("\n}\n");
+
+            const std::string path = folder + "defaults." + selected[f]->name;
+            if (!WriteFile(path, file, selected[f]->flag == DEFAULTS_BIN))
+            {
+                GP4MD_LOG_ERROR(IO, "Could not write %s\n", path.c_str());
+                ok = false;
+                continue;
             }
 
-            std::fprintf(g_DefaultsFile, "desc%d = %d    ; %s\n",
-                d, value, D.comment ? D.comment : "");
+            for (const std::string& p : file)
+                bytes += p.size();
         }
 
-        std::fprintf(g_DefaultsFile, "\n");
+        Timing::AddBytes(Phase::Defaults, bytes);
+
+        GP4MD_LOG_INFO(IO, "Defaults: %d format(s), %zu bytes in %.3f ms\n",
+            static_cast<int>(selected.size()), bytes, Platform::NowMs() - t0);
+
+        return ok;
     }
 }
@@ -0,0 +1,157 @@
+#include "MagicData_Hooks.h"
+#include "MagicData_Publish.h"
+#include "../Core/Logging.h"
+
+namespace MagicData
+{
+    namespace Hooks
+    {
+        HookCounters g_Counters;
+
+        namespace
+        {
+            // At least 64 slots and twice the track count (64 for GP4's 17
+            // tracks over ~6 KB of blocks); BuildLookup picks the smallest
+            // shift that gives every base its own slot.
+            constexpr int MIN_LOOKUP_SIZE = 64;
+
+            struct LookupEntry
+            {
+                std::uintptr_t key = 0; // original base; 0 = empty
+                int            track = -1;
+            };
+
+            std::vector<LookupEntry> g_Lookup;
+            std::size_t              g_LookupMask = 0;
+            unsigned                 g_Shift = 0;
+            bool                     g_Direct = false; // false: fall back to a linear scan
+
+            std::size_t Slot(std::uintptr_t addr)
+            {
+                return static_cast<std::size_t>(addr >> g_Shift) & g_LookupMask;
+            }
+
+            inline void Bump(std::atomic<std::uint32_t>& c)
+            {
+                c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        }
+
+        void BuildLookup()
+        {
+            std::size_t size = MIN_LOOKUP_SIZE;
+            while (size < static_cast<std::size_t>(g_TrackCount) * 2)
+                size *= 2;
+
+            g_Lookup.assign(size, LookupEntry{});
+            g_LookupMask = size - 1;
+            g_Counters.trackHits = std::vector<std::atomic<std::uint32_t>>(g_TrackCount);
+
+            g_Direct = false;
+
+            for (unsigned shift = 0; shift < 24 && !g_Direct; ++shift)
+            {
+                for (LookupEntry& e : g_Lookup)
+                    e = LookupEntry{};
+
+                g_Shift = shift;
+                g_Direct = true;
+
+                for (int t = 0; t < g_TrackCount; ++t)
+                {
+                    const std::uintptr_t key = reinterpret_cast<std::uintptr_t>(g_Layout[t].origBase);
+                    LookupEntry& e = g_Lookup[Slot(key)];
+                    if (!key || e.key)
+                    {
+                        g_Direct = false;
+                        break;
+                    }
+
+                    e.key = key;
+                    e.track = t;
+                }
+            }
+
+            if (g_Direct)
+                GP4MD_LOG_DEBUG(GPxTrack, "Hooks: direct base lookup, %zu slots, shift %u\n", g_Lookup.size(), g_Shift);
+            else
+                GP4MD_LOG_INFO(GPxTrack, "Hooks: no collision-free base lookup, using linear scan\n");
+        }
+
+        int FindTrack(const std::uint8_t* origBase)
+        {
+            const std::uintptr_t key = reinterpret_cast<std::uintptr_t>(origBase);
+
+            if (g_Direct)
+            {
+                const LookupEntry& e = g_Lookup[Slot(key)];
+                return e.key == key ? e.track : -1;
+            }
+
+            for (int t = 0; t < g_TrackCount; ++t)
+            {
+                if (g_Layout[t].origBase == origBase)
+                    return t;
+            }
+            return -1;
+        }
+
+        std::uintptr_t ResolveMem(std::uint8_t* orig)
+        {
+            Bump(g_Counters.memCalls);
+
+            const int t = FindTrack(orig);
+            g_CurrentTrackIndex = t;
+
+            if (t < 0)
+            {
+                Bump(g_Counters.memMisses);
+                return reinterpret_cast<std::uintptr_t>(orig);
+            }
+
+            Bump(g_Counters.trackHits[t]);
+
+            std::uint8_t* base = Publish::Acquire(t, Publish::HOOK_READER);
+            return reinterpret_cast<std::uintptr_t>(base ? base : orig);
+        }
+
+        std::uintptr_t ResolveDat(std::uintptr_t fallback)
+        {
+            Bump(g_Counters.datCalls);
+
+            const int t = g_CurrentTrackIndex;
+            if (t < 0 || t >= g_TrackCount)
+            {
+                Bump(g_Counters.datMisses);
+                return fallback;
+            }
+
+            // A slot never published (PatchAllTracks failed after the
+            // lookup was built) leaves GP4 its own block
+            std::uint8_t* base = Publish::Acquire(t, Publish::HOOK_READER);
+            if (!base)
+            {
+                Bump(g_Counters.datMisses);
+                return fallback;
+            }
+
+            Bump(g_Counters.trackHits[t]);
+            return reinterpret_cast<std::uintptr_t>(base);
+        }
+
+        void LogStats()
+        {
+            const HookCounters& c = g_Counters;
+
+            GP4MD_LOG_INFO(GPxTrack, "Hooks: mem %u (miss %u), dat %u (miss %u)\n",
+                c.memCalls.load(), c.memMisses.load(), c.datCalls.load(), c.datMisses.load());
+
+            for (int t = 0; t < static_cast<int>(c.trackHits.size()); ++t)
+            {
+                const std::uint32_t hits = c.trackHits[t].load();
+                if (hits)
+                    GP4MD_LOG_DEBUG(GPxTrack, "Hooks: Track %02d resolved %u time(s)\n", t + 1, hits);
+            }
+        }
+    }
+}
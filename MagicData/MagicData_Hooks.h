@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "MagicData.h"
+
+// Portable part of the GPxTrack hooks: maps the original magicdata base GP4
+// passes in to the track and its published block, and counts how often each
+// path runs. The naked hooks in GPxTrack.cpp only marshal registers.
+namespace MagicData
+{
+    namespace Hooks
+    {
+        // Single writer (GP4's loader thread), so counters are bumped with a
+        // relaxed load + store rather than a locked increment.
+        struct HookCounters
+        {
+            std::atomic<std::uint32_t> memCalls{ 0 };
+            std::atomic<std::uint32_t> memMisses{ 0 }; // base was not a track block
+            std::atomic<std::uint32_t> datCalls{ 0 };
+            std::atomic<std::uint32_t> datMisses{ 0 }; // no current track, or it is unpublished
+            std::vector<std::atomic<std::uint32_t>> trackHits; // g_TrackCount entries
+        };
+
+        extern HookCounters g_Counters;
+
+        // Direct-mapped origBase -> track table sized for g_TrackCount; also
+        // sizes the per-track counters. Call after the layout scan.
+        void BuildLookup();
+
+        // Track index for an original base, or -1. One table probe.
+        int FindTrack(const std::uint8_t* origBase);
+
+        // Memory path: sets g_CurrentTrackIndex and returns the relocated
+        // block, or orig for anything that is not a track base.
+        std::uintptr_t ResolveMem(std::uint8_t* orig);
+
+        // .dat path: relocated block of g_CurrentTrackIndex, else fallback
+        // (also when that track has no published block).
+        std::uintptr_t ResolveDat(std::uintptr_t fallback);
+
+        void LogStats();
+    }
+}
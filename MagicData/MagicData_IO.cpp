@@ -1,91 +1,230 @@
 #include "MagicData_IO.h"
 #include "MagicData.h"
+#include "../Core/Platform.h"
+#include "../Core/Simd.h"
 #include <cstring>
-#include <windows.h>
 #include <cstdio>
 
-namespace MagicData
+namespace
 {
-    std::string GetGP4RootFolder()
+    using MagicData::DatMarkers;
+    using MagicData::DAT_NO_MARKER;
+    using Simd::LowestBit;
+
+    // Verifies a candidate offset against all three markers.
+    // Candidates must be visited in increasing order.
+    inline void CheckMarker(const std::uint8_t* base, std::size_t size,
+        std::size_t i, DatMarkers& m)
     {
-        char path[MAX_PATH]{};
-        HMODULE hExe = GetModuleHandleA(nullptr);
-        if (!hExe)
-            return {};
+        switch (base[i])
+        {
+        case 'l':
+            if (i + 5 <= size && std::memcmp(base + i, "laps|", 5) == 0)
+                m.lapsMarker = i;
+            break;
+        case 'M':
+            if (m.magicStart == DAT_NO_MARKER && i + 4 <= size &&
+                base[i + 1] == 'A' && base[i + 2] == '0' && base[i + 3] == '3')
+                m.magicStart = i + 4;
+            break;
+        case 0x00:
+            if (m.magicStart != DAT_NO_MARKER && m.magicEnd == DAT_NO_MARKER &&
+                i >= m.magicStart && i + 3 <= size &&
+                base[i + 1] == 0xFF && base[i + 2] == 0xFF)
+                m.magicEnd = i + 3;
+            break;
+        default:
+            break;
+        }
+    }
 
-        GetModuleFileNameA(hExe, path, MAX_PATH);
-        std::string full(path);
-        const std::size_t pos = full.find_last_of("\\/");
-        if (pos == std::string::npos)
-            return {};
+    void ScanTail(const std::uint8_t* base, std::size_t size, std::size_t i, DatMarkers& m)
+    {
+        for (; i < size; ++i)
+            CheckMarker(base, size, i, m);
+    }
 
-        return full.substr(0, pos + 1);
+#ifdef GP4MD_HAS_SSE2
+    // Each lane flags a candidate when the first two bytes of a marker match
+    // ("la", "MA", 00 FF); CheckMarker confirms the rest.
+    std::size_t ScanSSE2(const std::uint8_t* base, std::size_t size, DatMarkers& m)
+    {
+        const __m128i vL = _mm_set1_epi8('l');
+        const __m128i vA = _mm_set1_epi8('a');
+        const __m128i vM = _mm_set1_epi8('M');
+        const __m128i vMA = _mm_set1_epi8('A');
+        const __m128i vZ = _mm_setzero_si128();
+        const __m128i vF = _mm_set1_epi8(static_cast<char>(0xFF));
+
+        std::size_t i = 0;
+        for (; i + 17 <= size; i += 16)
+        {
+            const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + i));
+            const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + i + 1));
+
+            __m128i hit = _mm_and_si128(_mm_cmpeq_epi8(b0, vL), _mm_cmpeq_epi8(b1, vA));
+            if (m.magicStart == DAT_NO_MARKER)
+                hit = _mm_or_si128(hit, _mm_and_si128(_mm_cmpeq_epi8(b0, vM), _mm_cmpeq_epi8(b1, vMA)));
+            if (m.magicEnd == DAT_NO_MARKER)
+                hit = _mm_or_si128(hit, _mm_and_si128(_mm_cmpeq_epi8(b0, vZ), _mm_cmpeq_epi8(b1, vF)));
+
+            std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(hit));
+            while (mask)
+            {
+                CheckMarker(base, size, i + LowestBit(mask), m);
+                mask &= mask - 1;
+            }
+        }
+        return i;
     }
 
-    bool LoadDatFile(int trackIndex, std::vector<std::uint8_t>& out)
+    GP4MD_TARGET_AVX2
+    std::size_t ScanAVX2(const std::uint8_t* base, std::size_t size, DatMarkers& m)
     {
-        const std::string root = GetGP4RootFolder();
-        if (root.empty())
-            return false;
+        const __m256i vL = _mm256_set1_epi8('l');
+        const __m256i vA = _mm256_set1_epi8('a');
+        const __m256i vM = _mm256_set1_epi8('M');
+        const __m256i vMA = _mm256_set1_epi8('A');
+        const __m256i vZ = _mm256_setzero_si256();
+        const __m256i vF = _mm256_set1_epi8(static_cast<char>(0xFF));
 
-        char name[32];
-        std::snprintf(name, sizeof(name), "Circuits\\S1CT%02d.DAT", trackIndex + 1);
-        const std::string fullPath = root + name;
+        std::size_t i = 0;
+        for (; i + 33 <= size; i += 32)
+        {
+            const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base + i));
+            const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base + i + 1));
+
+            __m256i hit = _mm256_and_si256(_mm256_cmpeq_epi8(b0, vL), _mm256_cmpeq_epi8(b1, vA));
+            if (m.magicStart == DAT_NO_MARKER)
+                hit = _mm256_or_si256(hit, _mm256_and_si256(_mm256_cmpeq_epi8(b0, vM), _mm256_cmpeq_epi8(b1, vMA)));
+            if (m.magicEnd == DAT_NO_MARKER)
+                hit = _mm256_or_si256(hit, _mm256_and_si256(_mm256_cmpeq_epi8(b0, vZ), _mm256_cmpeq_epi8(b1, vF)));
+
+            std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hit));
+            while (mask)
+            {
+                CheckMarker(base, size, i + LowestBit(mask), m);
+                mask &= mask - 1;
+            }
+        }
+        return i;
+    }
 
-        std::FILE* f = nullptr;
-        if (fopen_s(&f, fullPath.c_str(), "rb") != 0 || !f)
+    bool CpuHasAVX2()
+    {
+#ifdef _MSC_VER
+        int info[4]{};
+        __cpuid(info, 0);
+        if (info[0] < 7)
             return false;
 
-        std::fseek(f, 0, SEEK_END);
-        const long size = std::ftell(f);
-        std::fseek(f, 0, SEEK_SET);
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx)
+            return false;
 
-        if (size <= 0)
-        {
-            std::fclose(f);
+        // OS must save YMM state
+        if ((_xgetbv(0) & 0x6) != 0x6)
             return false;
-        }
 
-        out.resize(static_cast<std::size_t>(size));
-        std::fread(out.data(), 1, static_cast<std::size_t>(size), f);
-        std::fclose(f);
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }
+#endif
 
-        return true;
+    enum class ScanPath { Scalar, SSE2, AVX2 };
+
+    ScanPath SelectScanPath()
+    {
+#ifdef GP4MD_HAS_SSE2
+        static const ScanPath path = CpuHasAVX2() ? ScanPath::AVX2 : ScanPath::SSE2;
+        return path;
+#else
+        return ScanPath::Scalar;
+#endif
     }
+}
 
-    std::uint8_t* FindMagicDataInDat(std::vector<std::uint8_t>& dat,
-        std::size_t& outSize)
+namespace MagicData
+{
+    std::string GetGP4RootFolder()
+    {
+        return Platform::GameFolder();
+    }
+
+    std::string GetDatPath(int trackIndex)
+    {
+        const std::string root = GetGP4RootFolder();
+        if (root.empty())
+            return {};
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "Circuits/S1CT%02d.DAT", trackIndex + 1);
+        return root + name;
+    }
+
+    void ScanDatMarkers(const std::uint8_t* data, std::size_t size, DatMarkers& out)
     {
-        auto* base = dat.data();
-        const std::size_t size = dat.size();
+        out = DatMarkers{};
+        if (!data || size == 0)
+            return;
 
-        std::size_t start = static_cast<std::size_t>(-1);
-        for (std::size_t i = 0; i + 4 <= size; ++i)
+        std::size_t i = 0;
+#ifdef GP4MD_HAS_SSE2
+        switch (SelectScanPath())
         {
-            if (base[i] == 'M' && base[i + 1] == 'A' &&
-                base[i + 2] == '0' && base[i + 3] == '3')
-            {
-                start = i + 4;
-                break;
-            }
+        case ScanPath::AVX2:
+            i = ScanAVX2(data, size, out);
+            break;
+        case ScanPath::SSE2:
+            i = ScanSSE2(data, size, out);
+            break;
+        default:
+            break;
         }
-        if (start == static_cast<std::size_t>(-1))
-            return nullptr;
+#endif
+        ScanTail(data, size, i, out);
+    }
+
+    void ScanDatMarkersScalar(const std::uint8_t* data, std::size_t size, DatMarkers& out)
+    {
+        out = DatMarkers{};
+        if (!data || size == 0)
+            return;
+
+        ScanTail(data, size, 0, out);
+    }
 
-        std::size_t end = static_cast<std::size_t>(-1);
-        for (std::size_t i = start; i + 3 <= size; ++i)
+    const char* DatScanPathName()
+    {
+        switch (SelectScanPath())
         {
-            if (base[i] == 0x00 && base[i + 1] == 0xFF && base[i + 2] == 0xFF)
-            {
-                end = i + 3;
-                break;
-            }
+        case ScanPath::AVX2: return "avx2";
+        case ScanPath::SSE2: return "sse2";
+        default:             return "scalar";
         }
-        if (end == static_cast<std::size_t>(-1) || end <= start)
+    }
+
+    const std::uint8_t* FindMagicDataInDat(const DatView& dat,
+        std::size_t& outSize)
+    {
+        if (dat.empty())
+            return nullptr;
+
+        DatMarkers m = dat.markers;
+        if (!dat.hasMarkers)
+            ScanDatMarkers(dat.data, dat.size, m);
+
+        if (m.magicStart == DAT_NO_MARKER || m.magicEnd == DAT_NO_MARKER)
             return nullptr;
 
-        outSize = end - start;
-        return base + start;
+        outSize = m.magicEnd - m.magicStart;
+        return dat.data + m.magicStart;
     }
 
     void CopyDatMagicDataToGP4(std::uint8_t* src,
@@ -113,33 +252,25 @@ namespace MagicData
         }
     }
 
-    bool ExtractLapsFromDat(const std::vector<std::uint8_t>& dat,
+    bool ExtractLapsFromDat(const DatView& dat,
         int& outLaps)
     {
         outLaps = 0;
         if (dat.empty())
             return false;
 
-        static constexpr std::uint8_t marker[] = {
-            0x6C, 0x61, 0x70, 0x73, 0x7C // "laps|"
-        };
-        static constexpr std::size_t markerLen = sizeof(marker);
+        static constexpr std::size_t markerLen = 5; // "laps|"
 
-        const std::uint8_t* base = dat.data();
-        const std::size_t size = dat.size();
+        const std::uint8_t* base = dat.data;
+        const std::size_t size = dat.size;
 
-        // search from the end for the marker
-        std::size_t pos = static_cast<std::size_t>(-1);
-        for (std::size_t i = size; i-- > markerLen - 1; )
-        {
-            if (std::memcmp(base + i - (markerLen - 1), marker, markerLen) == 0)
-            {
-                pos = i - (markerLen - 1);
-                break;
-            }
-        }
+        // last "laps|" in the file
+        DatMarkers m = dat.markers;
+        if (!dat.hasMarkers)
+            ScanDatMarkers(base, size, m);
 
-        if (pos == static_cast<std::size_t>(-1))
+        const std::size_t pos = m.lapsMarker;
+        if (pos == DAT_NO_MARKER)
             return false;
 
         std::size_t p = pos + markerLen;
@@ -1,15 +1,45 @@
 #pragma once
-#include <vector>
 #include <string>
 #include <cstdint>
+#include <cstddef>
 
 namespace MagicData
 {
+    constexpr std::size_t DAT_NO_MARKER = static_cast<std::size_t>(-1);
+
+    // Marker offsets inside a circuit .dat, found in a single forward pass.
+    struct DatMarkers
+    {
+        std::size_t magicStart = DAT_NO_MARKER; // first byte after the first "MA03"
+        std::size_t magicEnd = DAT_NO_MARKER;   // first byte after the first 00 FF FF following it
+        std::size_t lapsMarker = DAT_NO_MARKER; // offset of the last "laps|"
+    };
+
+    // Read-only, non-owning view of a circuit .dat (see DatCache).
+    struct DatView
+    {
+        const std::uint8_t* data = nullptr;
+        std::size_t         size = 0;
+        DatMarkers          markers{};          // valid when hasMarkers is set
+        bool                hasMarkers = false;
+
+        bool empty() const { return !data || size == 0; }
+    };
+
     std::string GetGP4RootFolder();
 
-    bool LoadDatFile(int trackIndex, std::vector<std::uint8_t>& out);
+    std::string GetDatPath(int trackIndex);
+
+    // Vectorized multi-pattern scan (AVX2 when available, SSE2 baseline).
+    void ScanDatMarkers(const std::uint8_t* data, std::size_t size, DatMarkers& out);
+
+    // Byte-at-a-time reference implementation of ScanDatMarkers.
+    void ScanDatMarkersScalar(const std::uint8_t* data, std::size_t size, DatMarkers& out);
+
+    // Name of the code path ScanDatMarkers dispatches to ("avx2", "sse2", "scalar").
+    const char* DatScanPathName();
 
-    std::uint8_t* FindMagicDataInDat(std::vector<std::uint8_t>& dat,
+    const std::uint8_t* FindMagicDataInDat(const DatView& dat,
         std::size_t& outSize);
 
     void CopyDatMagicDataToGP4(std::uint8_t* src,
@@ -17,6 +47,6 @@ namespace MagicData
         std::uint8_t* dst,
         int trackIndex);
 
-    bool ExtractLapsFromDat(const std::vector<std::uint8_t>& dat,
+    bool ExtractLapsFromDat(const DatView& dat,
         int& outLaps);
 }
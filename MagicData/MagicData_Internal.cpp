@@ -2,14 +2,127 @@
 #include "MagicData.h"
 #include "../Core/Encoding.h"
 #include "../Core/Logging.h"
-#include "../GP4MemLib/GP4MemLib.h"
-#include "../IniLib/IniLib.h"
+#include "../Core/Simd.h"
 
 namespace MagicDataInternal
 {
     using namespace MagicData;
-    using namespace GP4MemLib;
-    using namespace IniLib;
+
+    namespace
+    {
+        constexpr std::size_t SCAN_LIMIT = 0x20000; // safety bound per block
+
+        // First p in [from, end), at an even distance from from, where the
+        // terminator starts (FF FF 00 00, or FF FF when shortTerminator).
+        const std::uint8_t* FindTerminatorScalar(const std::uint8_t* from,
+            const std::uint8_t* end, bool shortTerminator)
+        {
+            const std::size_t len = shortTerminator ? 2 : 4;
+
+            for (const std::uint8_t* p = from; p + len <= end; p += 2)
+            {
+                if (p[0] == 0xFF && p[1] == 0xFF &&
+                    (shortTerminator || (p[2] == 0x00 && p[3] == 0x00)))
+                    return p;
+            }
+            return nullptr;
+        }
+
+#ifdef GP4MD_HAS_SSE2
+        // Aligned loads only, so nothing past the 64-byte line holding the
+        // terminator is read (never another page). Lines without any FF are
+        // skipped whole. Otherwise the byte masks of the previous and
+        // current 16 bytes form a 32-bit window; each step tests starts
+        // 13..28 of it: the previous block's last three (which need the
+        // current bytes) and the current block's first thirteen.
+        const std::uint8_t* FindTerminatorSSE2(const std::uint8_t* from,
+            const std::uint8_t* end, bool shortTerminator)
+        {
+            const __m128i vF = _mm_set1_epi8(static_cast<char>(0xFF));
+            const __m128i vZ = _mm_setzero_si128();
+
+            const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(from);
+            const std::uint32_t  parity = (start & 1) ? 0xAAAAAAAAu : 0x55555555u;
+            const std::uint32_t  window = 0x1FFFE000u; // bits 13..28
+
+            const std::uint8_t* blk =
+                reinterpret_cast<const std::uint8_t*>(start & ~static_cast<std::uintptr_t>(15));
+
+            std::uint32_t prevF = 0;
+            std::uint32_t prevZ = 0;
+
+            for (; blk + 16 <= end; blk += 16)
+            {
+                if (prevF == 0 && (reinterpret_cast<std::uintptr_t>(blk) & 63) == 0 && blk + 64 <= end)
+                {
+                    const __m128i* line = reinterpret_cast<const __m128i*>(blk);
+                    const __m128i  any = _mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(_mm_load_si128(line), vF),
+                            _mm_cmpeq_epi8(_mm_load_si128(line + 1), vF)),
+                        _mm_or_si128(_mm_cmpeq_epi8(_mm_load_si128(line + 2), vF),
+                            _mm_cmpeq_epi8(_mm_load_si128(line + 3), vF)));
+
+                    if (_mm_movemask_epi8(any) == 0)
+                    {
+                        blk += 48;
+                        continue;
+                    }
+                }
+
+                const __m128i v = _mm_load_si128(reinterpret_cast<const __m128i*>(blk));
+
+                const std::uint32_t f = prevF |
+                    (static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, vF))) << 16);
+                const std::uint32_t z = prevZ |
+                    (static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, vZ))) << 16);
+
+                std::uint32_t hit = f & (f >> 1);
+                if (!shortTerminator)
+                    hit &= (z >> 2) & (z >> 3);
+
+                hit &= parity & window;
+
+                while (hit)
+                {
+                    const std::uint8_t* p = blk - 16 + Simd::LowestBit(hit);
+                    if (p >= from)
+                        return p;
+                    hit &= hit - 1;
+                }
+
+                prevF = f >> 16;
+                prevZ = z >> 16;
+            }
+
+            // Starts not tested yet, from the last block's position 13 on
+            const std::uint8_t* tail = blk - 3;
+            if (tail < from)
+                tail = from;
+            else if ((tail - from) & 1)
+                ++tail;
+
+            return FindTerminatorScalar(tail, end, shortTerminator);
+        }
+#endif
+
+        const std::uint8_t* FindTerminator(const std::uint8_t* from,
+            const std::uint8_t* end, bool shortTerminator)
+        {
+#ifdef GP4MD_HAS_SSE2
+            return FindTerminatorSSE2(from, end, shortTerminator);
+#else
+            return FindTerminatorScalar(from, end, shortTerminator);
+#endif
+        }
+    }
+
+    int PlanArena(Memory::Arena& arena, const std::size_t* blockBytes)
+    {
+        for (int t = 0; t < g_TrackCount; ++t)
+            arena.Reserve(blockBytes[t], t);
+
+        return arena.Reserve(g_TrackCount, LAP_TABLE_TAG, 1);
+    }
 
     // Scan a track's magicdata block to find the bump region boundaries.
     // For tracks 1–16, the bump region ends at 0xFF 0xFF 0x00 0x00.
@@ -19,15 +132,14 @@ namespace MagicDataInternal
         MagicBlockLayout L{};
         L.base = base;
 
-        const std::size_t lastDescEnd = g_Desc[DESC_COUNT - 1].offset + 2;
-        L.bumpStart = base + lastDescEnd;
+        L.bumpStart = base + LAST_DESC_END;
 
         std::uint8_t* p = L.bumpStart;
-        std::uint8_t* end = base + 0x20000; // safety upper bound
+        std::uint8_t* end = base + SCAN_LIMIT;
 
-        if (trackIndex < TRACK_COUNT - 1)
+        if (trackIndex < g_TrackCount - 1)
         {
-            // Tracks 1–16: look for FF FF 00 00
+            // Every track but the last: look for FF FF 00 00
             while (p + 3 < end)
             {
                 if (p[0] == 0xFF && p[1] == 0xFF &&
@@ -43,7 +155,7 @@ namespace MagicDataInternal
         }
         else
         {
-            // Track 17: look for FF FF
+            // Last track: look for FF FF
             while (p + 1 < end)
             {
                 if (p[0] == 0xFF && p[1] == 0xFF)
@@ -61,88 +173,144 @@ namespace MagicDataInternal
         return L;
     }
 
-    void PatchDesc(std::uint8_t* base, int descIndex, int value)
+    int ScanAll(std::uint8_t* base, MagicBlockLayout* out)
+    {
+        for (int t = 0; t < g_TrackCount; ++t)
+        {
+            MagicBlockLayout L{};
+            L.base = base;
+            L.bumpStart = base + LAST_DESC_END;
+
+            const bool shortTerminator = t == g_TrackCount - 1;
+            const std::uint8_t* p = FindTerminator(L.bumpStart, base + SCAN_LIMIT, shortTerminator);
+
+            if (!p)
+            {
+                out[t] = L;
+                return t;
+            }
+
+            L.bumpEnd = const_cast<std::uint8_t*>(p) + (shortTerminator ? 2 : 4);
+            L.bumpSize = static_cast<std::size_t>(p - L.bumpStart);
+            L.valid = true;
+            out[t] = L;
+
+            base = L.bumpEnd;
+        }
+
+        return g_TrackCount;
+    }
+
+    int ScanAllScalar(std::uint8_t* base, MagicBlockLayout* out)
+    {
+        for (int t = 0; t < g_TrackCount; ++t)
+        {
+            out[t] = Scan(base, t);
+            if (!out[t].valid)
+                return t;
+
+            base = out[t].bumpEnd;
+        }
+
+        return g_TrackCount;
+    }
+
+    void PatchDesc(Patch::Transaction& txn, int descIndex, int value)
     {
         const DescInfo& D = g_Desc[descIndex - 1];
-        std::uint8_t* addr = base + D.offset;
 
         switch (D.type)
         {
         case DescType::SETUP_BYTE:
-        {
-            const std::uint8_t b = EncodeSetupByte(value);
-            MemUtils::patchAddress(addr, MemUtils::toBytes(b), 1, false);
+            txn.Stage(D.offset, 1, EncodeSetupByte(value));
             break;
-        }
         case DescType::U8:
-        {
-            const std::uint8_t b = static_cast<std::uint8_t>(value);
-            MemUtils::patchAddress(addr, MemUtils::toBytes(b), 1, false);
+            txn.Stage(D.offset, 1, static_cast<std::uint8_t>(value));
             break;
-        }
         case DescType::U16:
-        {
-            const std::uint16_t v = static_cast<std::uint16_t>(value);
-            MemUtils::patchAddress(addr, MemUtils::toBytes(v), 2, false);
+            txn.Stage(D.offset, 2, static_cast<std::uint16_t>(value));
             break;
-        }
         case DescType::U32:
-        {
-            const std::uint32_t v = static_cast<std::uint32_t>(value);
-            MemUtils::patchAddress(addr, MemUtils::toBytes(v), 4, false);
+            txn.Stage(D.offset, 4, static_cast<std::uint32_t>(value));
             break;
         }
-        }
     }
 
-    void PatchTrack(std::uint8_t* base,
-        const IniLib::IniFile& trackIni,
-        const IniLib::IniFile& globalIni,
+    // Applies the overrides a [TrackNN] section actually contains: one pass
+    // over its keys, each resolved to a descriptor (or laps) and dispatched.
+    void PatchTrack(Patch::Transaction& txn,
+        std::uint8_t* lapAddr,
+        const IniText::Section& trackSec,
+        bool sprintRace,
         int trackIndex)
     {
-        char section[32];
-        std::snprintf(section, sizeof(section), "Track%02d", trackIndex + 1);
-
-        if (!trackIni.hasSection(section))
+        if (!trackSec.present)
             return;
 
-        // Descriptor overrides: desc1..desc139
-        for (int d = 1; d <= DESC_COUNT; ++d)
+        const IniText::Entry* lapsEntry = nullptr;
+        std::string           ignored;
+
+        auto ignore = [&](const IniText::Entry& e, const char* why)
+            {
+                if (!ignored.empty())
+                    ignored += ", ";
+                ignored += e.key;
+                ignored += " (";
+                ignored += why;
+                ignored += ")";
+            };
+
+        for (const IniText::Entry& e : trackSec.entries)
         {
-            char key[16];
-            std::snprintf(key, sizeof(key), "desc%d", d);
+            const int d = FindDescKey(e.key.c_str());
+            if (d > 0)
+            {
+                if (e.value.empty())
+                    continue;
 
-            if (!trackIni.hasKey(section, key))
-                continue;
+                int value = 0;
+                if (!IniText::ParseInt(e.value, value))
+                {
+                    ignore(e, "bad value");
+                    continue;
+                }
 
-            IniLib::IniValue v = trackIni.get(section, key);
-            if (v.length() == 0)
-                continue;
+                GP4MD_LOG_TRACE(MagicData, "Track%02d.ini: %s = %d\n",
+                    trackIndex + 1, e.key.c_str(), value);
 
-            PatchDesc(base, d, v.getAs<int>());
+                PatchDesc(txn, d, value);
+            }
+            else if (IniText::EqualsNoCase(e.key.c_str(), "laps"))
+                lapsEntry = &e;
+            else if (IniText::EqualsNoCase(e.key.c_str(), "SprintLaps"))
+                continue; // handled by RaceSettings
+            else if (e.key.size() > 4 && IniText::EqualsNoCase(e.key.substr(0, 4).c_str(), "desc"))
+                ignore(e, "out of range");
+            else
+                ignore(e, "unknown");
         }
 
-        // Lap overrides (with SprintRace awareness)
-        bool sprintRace = false;
-        if (globalIni.hasSection("RaceSettings") &&
-            globalIni.hasKey("RaceSettings", "SprintRace"))
+        if (!ignored.empty())
         {
-            sprintRace = globalIni.get("RaceSettings", "SprintRace").getAs<int>() == 1;
+            GP4MD_LOG_INFO(MagicData, "Track%02d.ini: ignored %s\n",
+                trackIndex + 1, ignored.c_str());
         }
 
-        if (trackIni.hasKey(section, "laps"))
+        // Lap overrides (with SprintRace awareness)
+        if (lapsEntry)
         {
-            IniLib::IniValue v = trackIni.get(section, "laps");
-
             // When SprintRace=1 and laps is empty, we leave laps to RaceSettings logic.
-            if (sprintRace && v.length() == 0)
+            if (sprintRace && lapsEntry->value.empty())
                 return;
 
-            if (v.length() > 0)
+            int laps = 0;
+            if (IniText::ParseInt(lapsEntry->value, laps))
+            {
+                *lapAddr = static_cast<std::uint8_t>(laps);
+            }
+            else if (!lapsEntry->value.empty())
             {
-                const std::uint8_t b = static_cast<std::uint8_t>(v.getAs<int>());
-                std::uint8_t* addr = g_LapTable + trackIndex;
-                MemUtils::patchAddress(addr, MemUtils::toBytes(b), 1, false);
+                GP4MD_LOG_INFO(MagicData, "Track%02d.ini: ignored laps (bad value)\n", trackIndex + 1);
             }
         }
     }
@@ -1,16 +1,47 @@
 #pragma once
 #include <cstdint>
 #include "MagicData.h"
-#include "../IniLib/IniLib.h"
+#include "../Core/IniText.h"
+#include "../Core/Patch.h"
+#include "../Core/Arena.h"
 
 namespace MagicDataInternal
 {
+    // Zeroed bytes kept after each relocated block, as GP4 reads slightly
+    // past the bump terminator.
+    constexpr std::size_t SLOT_TAIL = 0x20;
+
+    // Arena tag of the relocated lap table; tracks use their index.
+    constexpr int LAP_TABLE_TAG = MagicData::MAX_TRACK_COUNT;
+
+    // Plans one block per track (blockBytes[t], tail included; block id =
+    // track index) and then the lap table, whose block id it returns. The
+    // startup arena and its snapshot share this layout.
+    int PlanArena(Memory::Arena& arena, const std::size_t* blockBytes);
+
+    // Scalar scan of one original block: bump region from LAST_DESC_END to
+    // FF FF 00 00 (FF FF for the last track) at an even offset.
     MagicData::MagicBlockLayout Scan(std::uint8_t* base, int trackIndex);
 
-    void PatchDesc(std::uint8_t* base, int descIndex, int value);
+    // All g_TrackCount blocks from base in one forward pass, each starting at
+    // the previous bumpEnd. Vectorized (SSE2) where available. Returns the
+    // number of blocks found before the first one without a terminator.
+    int ScanAll(std::uint8_t* base, MagicData::MagicBlockLayout* out);
 
-    void PatchTrack(std::uint8_t* base,
-        const IniLib::IniFile& trackIni,
-        const IniLib::IniFile& globalIni,
+    // Same result as ScanAll through Scan; the reference for verification.
+    int ScanAllScalar(std::uint8_t* base, MagicData::MagicBlockLayout* out);
+
+    // Stages a descriptor write; txn is based at the track's block.
+    void PatchDesc(Patch::Transaction& txn, int descIndex, int value);
+
+    // sprintRace: [RaceSettings] SprintRace=1, which leaves a blank laps
+    // key to RaceSettings.
+    void PatchTrack(Patch::Transaction& txn,
+        std::uint8_t* lapAddr,
+        const IniText::Section& trackSec,
+        bool sprintRace,
         int trackIndex);
+
+    // GP4MD.ini as the last PrepareInputs read it; not present before.
+    const IniText::Document& StartupIni();
 }
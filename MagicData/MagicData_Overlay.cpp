@@ -0,0 +1,170 @@
+#include "MagicData_Overlay.h"
+#include "../Core/Logging.h"
+#include <vector>
+
+namespace MagicData
+{
+    namespace
+    {
+        struct TrackSources
+        {
+            Layer desc[DESC_COUNT] = {};
+            Layer laps = Layer::Default;
+        };
+
+        std::vector<TrackSources> g_Sources;
+
+        const char* const k_LayerNames[LAYER_COUNT] = {
+            "default", ".dat", "pack", "track ini", "race settings"
+        };
+
+        // Descriptor (1-based) whose bytes include offset; the schema covers
+        // the descriptor region without gaps, in offset order.
+        int DescAt(std::uint32_t offset)
+        {
+            int lo = 0;
+            int hi = DESC_COUNT - 1;
+
+            while (lo < hi)
+            {
+                const int mid = (lo + hi + 1) / 2;
+                if (g_Desc[mid].offset <= offset)
+                    lo = mid;
+                else
+                    hi = mid - 1;
+            }
+
+            return lo + 1;
+        }
+
+        std::uint32_t ReadLE(const std::uint8_t* p, std::size_t width)
+        {
+            std::uint32_t v = 0;
+            for (std::size_t i = 0; i < width; ++i)
+                v |= static_cast<std::uint32_t>(p[i]) << (i * 8);
+            return v;
+        }
+    }
+
+    namespace Overlay
+    {
+        void Resize(int trackCount)
+        {
+            g_Sources.assign(trackCount, TrackSources{});
+        }
+
+        const char* LayerName(Layer layer)
+        {
+            const int i = static_cast<int>(layer);
+            return i >= 0 && i < LAYER_COUNT ? k_LayerNames[i] : "?";
+        }
+
+        std::size_t StageBlock(Patch::Transaction& txn, const std::uint8_t* src,
+            std::size_t payload, Layer layer)
+        {
+            txn.SetSource(static_cast<std::uint8_t>(layer));
+
+            std::size_t staged = 0;
+            for (int d = 0; d < DESC_COUNT; ++d)
+            {
+                const DescInfo&   D = g_Desc[d];
+                const std::size_t width = DescSize(D.type);
+
+                if (D.offset >= payload)
+                    break;
+
+                // A short source ends inside this descriptor: its tail bytes
+                // stay at the value below
+                std::uint8_t bytes[4] = {};
+                const std::uint32_t below = txn.Read(static_cast<std::uint32_t>(D.offset),
+                    static_cast<std::uint8_t>(width));
+
+                for (std::size_t i = 0; i < width; ++i)
+                {
+                    bytes[i] = D.offset + i < payload
+                        ? src[D.offset + i]
+                        : static_cast<std::uint8_t>(below >> (i * 8));
+                }
+
+                if (txn.Stage(static_cast<std::uint32_t>(D.offset), static_cast<std::uint8_t>(width),
+                    ReadLE(bytes, width)))
+                    ++staged;
+            }
+
+            return staged;
+        }
+
+        void Record(int trackIndex, const Patch::Transaction& txn, Layer laps,
+            std::size_t* perLayer)
+        {
+            if (trackIndex < 0 || trackIndex >= static_cast<int>(g_Sources.size()))
+                return;
+
+            TrackSources& s = g_Sources[trackIndex];
+            s = TrackSources{};
+            s.laps = laps;
+
+            if (perLayer)
+            {
+                for (int i = 0; i < LAYER_COUNT; ++i)
+                    perLayer[i] = 0;
+            }
+
+            for (const Patch::Change& c : txn.Changes())
+            {
+                const Layer layer = static_cast<Layer>(c.source);
+                s.desc[DescAt(c.offset) - 1] = layer;
+
+                if (perLayer && c.source < LAYER_COUNT)
+                    ++perLayer[c.source];
+            }
+        }
+
+        Layer DescSource(int trackIndex, int descIndex)
+        {
+            if (trackIndex < 0 || trackIndex >= static_cast<int>(g_Sources.size()) ||
+                descIndex < 1 || descIndex > DESC_COUNT)
+                return Layer::Default;
+
+            return g_Sources[trackIndex].desc[descIndex - 1];
+        }
+
+        Layer LapsSource(int trackIndex)
+        {
+            if (trackIndex < 0 || trackIndex >= static_cast<int>(g_Sources.size()))
+                return Layer::Default;
+
+            return g_Sources[trackIndex].laps;
+        }
+
+        void LogTrack(int trackIndex, const std::uint8_t* descBase)
+        {
+#if GP4MD_LOG_MAX_LEVEL >= GP4MD_LOG_LEVEL_TRACE
+            if (!Logging::Enabled(Logging::Category::MagicData, Logging::Level::Trace))
+                return;
+
+            for (int d = 1; d <= DESC_COUNT; ++d)
+            {
+                const Layer layer = DescSource(trackIndex, d);
+                if (layer == Layer::Default)
+                    continue;
+
+                const DescInfo& D = g_Desc[d - 1];
+                const std::uint32_t raw = ReadLE(descBase + D.offset, DescSize(D.type));
+                const int value = D.type == DescType::SETUP_BYTE
+                    ? static_cast<int>(raw) - 151
+                    : static_cast<int>(raw);
+
+                GP4MD_LOG_TRACE(MagicData, "Track%02d %s = %d from %s\n",
+                    trackIndex + 1, DescKey(d), value, LayerName(layer));
+            }
+
+            GP4MD_LOG_TRACE(MagicData, "Track%02d laps from %s\n",
+                trackIndex + 1, LayerName(LapsSource(trackIndex)));
+#else
+            (void)trackIndex;
+            (void)descBase;
+#endif
+        }
+    }
+}
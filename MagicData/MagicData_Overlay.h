@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "MagicData.h"
+#include "../Core/Patch.h"
+
+namespace MagicData
+{
+    // Precedence of a track's descriptor values, lowest first. Each layer
+    // above Default is a sparse set of field edits staged in one transaction
+    // over the scratch block (tagged with Transaction::SetSource), so the
+    // block is resolved with one copy of the GP4 default and one write per
+    // changed field.
+    enum class Layer : std::uint8_t
+    {
+        Default,      // original GP4 block / lap table
+        Dat,          // Circuits\S1CTnn.DAT
+        Pack,         // precompiled .gp4mdpack (instead of Default + Dat)
+        TrackIni,     // TrackNN.ini
+        RaceSettings  // [RaceSettings] in GP4MD.ini
+    };
+
+    constexpr int LAYER_COUNT = 5;
+
+    // Which layer last changed each descriptor and the lap count of every
+    // track slot, kept from the most recent prepare of that track (a
+    // snapshot restore prepares nothing and leaves everything Default).
+    namespace Overlay
+    {
+        // One entry per track slot (from SetTrackCount), all Default.
+        void Resize(int trackCount);
+
+        const char* LayerName(Layer layer);
+
+        // Stages the descriptor bytes src[0, payload) (.dat or pack) that
+        // differ from the block txn is based on, one edit per descriptor,
+        // tagged layer. Returns the number of descriptors staged.
+        std::size_t StageBlock(Patch::Transaction& txn, const std::uint8_t* src,
+            std::size_t payload, Layer layer);
+
+        // Stores the provenance of txn's staged edits (before Commit) for
+        // trackIndex; descriptors without an edit are Default. Fills
+        // perLayer[LAYER_COUNT] with edit counts when given.
+        void Record(int trackIndex, const Patch::Transaction& txn, Layer laps,
+            std::size_t* perLayer = nullptr);
+
+        // descIndex is 1-based (desc1..desc139).
+        Layer DescSource(int trackIndex, int descIndex);
+        Layer LapsSource(int trackIndex);
+
+        // Trace log of every descriptor not taken from the GP4 default.
+        void LogTrack(int trackIndex, const std::uint8_t* descBase);
+    }
+}
@@ -0,0 +1,209 @@
+#include "MagicData_Pack.h"
+#include "../Core/Hash.h"
+#include "../Core/FileIO.h"
+#include "../Core/Logging.h"
+#include "../Core/Platform.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace MagicData
+{
+    namespace
+    {
+        constexpr char          kPackMagic[8] = { 'G', 'P', '4', 'M', 'D', 'P', 'A', 'K' };
+        constexpr std::uint32_t kPackVersion = 1;
+        constexpr std::size_t   kBlockAlign = 16;
+        constexpr std::uint8_t  PACK_TRACK_INI = 0x01; // compiled with a Track INI
+
+        struct PackHeader
+        {
+            char          magic[8];
+            std::uint32_t version;
+            std::uint32_t trackCount;
+            std::uint32_t directoryOffset;
+            std::uint32_t fileBytes;
+            std::uint64_t directoryHash; // FNV-1a of the directory entries
+        };
+
+        struct PackEntry
+        {
+            std::uint64_t blockHash; // FNV-1a of the block bytes
+            std::uint32_t offset;    // from the file start
+            std::uint32_t size;      // descriptors + bump region + terminator
+            std::uint8_t  laps;
+            std::uint8_t  sprintLaps;
+            std::uint8_t  flags;     // PACK_TRACK_INI
+            std::uint8_t  reserved[5];
+        };
+
+        static_assert(sizeof(PackHeader) == 32, "pack header layout");
+        static_assert(sizeof(PackEntry) == 24, "pack entry layout");
+
+        Platform::MappedFile   g_File;
+        std::vector<PackEntry> g_Entries;
+        std::uint64_t          g_Checksum = 0;
+
+        std::size_t AlignUp(std::size_t v)
+        {
+            return (v + kBlockAlign - 1) & ~(kBlockAlign - 1);
+        }
+
+        const char* Validate(const Platform::MappedFile& file, PackHeader& hdr,
+            std::vector<PackEntry>& entries)
+        {
+            if (file.size < sizeof(hdr))
+                return "truncated";
+
+            std::memcpy(&hdr, file.data, sizeof(hdr));
+
+            if (std::memcmp(hdr.magic, kPackMagic, sizeof(kPackMagic)) != 0)
+                return "not a pack";
+            if (hdr.version != kPackVersion)
+                return "version";
+            if (hdr.trackCount != static_cast<std::uint32_t>(g_TrackCount))
+                return "track count";
+            if (hdr.fileBytes != file.size ||
+                hdr.directoryOffset > file.size ||
+                (file.size - hdr.directoryOffset) / sizeof(PackEntry) < hdr.trackCount)
+                return "size";
+
+            const std::uint8_t* dir = file.data + hdr.directoryOffset;
+            const std::size_t   dirBytes = hdr.trackCount * sizeof(PackEntry);
+
+            if (HashBytes(dir, dirBytes) != hdr.directoryHash)
+                return "directory checksum";
+
+            entries.resize(hdr.trackCount);
+            std::memcpy(entries.data(), dir, dirBytes);
+
+            for (const PackEntry& e : entries)
+            {
+                if (e.size <= LAST_DESC_END || e.offset > file.size || e.size > file.size - e.offset)
+                    return "directory";
+                if (HashBytes(file.data + e.offset, e.size) != e.blockHash)
+                    return "block checksum";
+            }
+
+            return nullptr;
+        }
+    }
+
+    namespace Pack
+    {
+        bool Open(const std::string& path)
+        {
+            Close();
+
+            if (!Platform::MapFileRead(path, g_File))
+            {
+                GP4MD_LOG_ERROR(IO, "Pack: could not open %s\n", path.c_str());
+                return false;
+            }
+
+            PackHeader  hdr{};
+            const char* reason = Validate(g_File, hdr, g_Entries);
+            if (reason)
+            {
+                GP4MD_LOG_ERROR(IO, "Pack: %s rejected (%s)\n", path.c_str(), reason);
+                Close();
+                return false;
+            }
+
+            g_Checksum = hdr.directoryHash;
+
+            GP4MD_LOG_INFO(IO, "Pack: %s, %u track(s), %zu bytes\n",
+                path.c_str(), hdr.trackCount, g_File.size);
+            return true;
+        }
+
+        void Close()
+        {
+            Platform::UnmapFile(g_File);
+            g_Entries.clear();
+            g_Checksum = 0;
+        }
+
+        bool IsOpen()
+        {
+            return !g_Entries.empty();
+        }
+
+        std::uint64_t Checksum()
+        {
+            return g_Checksum;
+        }
+
+        bool Get(int trackIndex, PackTrack& out)
+        {
+            if (trackIndex < 0 || trackIndex >= static_cast<int>(g_Entries.size()))
+                return false;
+
+            const PackEntry& e = g_Entries[trackIndex];
+            out.block = g_File.data + e.offset;
+            out.size = e.size;
+            out.laps = e.laps;
+            out.sprintLaps = e.sprintLaps;
+            out.hasTrackIni = (e.flags & PACK_TRACK_INI) != 0;
+            return true;
+        }
+
+        bool Write(const std::string& path, const PackTrack* tracks, int count)
+        {
+            PackHeader hdr{};
+            std::memcpy(hdr.magic, kPackMagic, sizeof(kPackMagic));
+            hdr.version = kPackVersion;
+            hdr.trackCount = static_cast<std::uint32_t>(count);
+            hdr.directoryOffset = sizeof(PackHeader);
+
+            std::vector<PackEntry> entries(count);
+            std::size_t            at = AlignUp(sizeof(PackHeader) + count * sizeof(PackEntry));
+
+            for (int t = 0; t < count; ++t)
+            {
+                PackEntry& e = entries[t];
+                e.blockHash = HashBytes(tracks[t].block, tracks[t].size);
+                e.offset = static_cast<std::uint32_t>(at);
+                e.size = static_cast<std::uint32_t>(tracks[t].size);
+                e.laps = tracks[t].laps;
+                e.sprintLaps = tracks[t].sprintLaps;
+                e.flags = tracks[t].hasTrackIni ? PACK_TRACK_INI : 0;
+
+                at = AlignUp(at + tracks[t].size);
+            }
+
+            hdr.fileBytes = static_cast<std::uint32_t>(at);
+            hdr.directoryHash = HashBytes(entries.data(), entries.size() * sizeof(PackEntry));
+
+            // Assembled in memory and written at once
+            std::vector<std::uint8_t> image(at, 0);
+            std::memcpy(image.data(), &hdr, sizeof(hdr));
+            std::memcpy(image.data() + hdr.directoryOffset, entries.data(),
+                entries.size() * sizeof(PackEntry));
+
+            for (int t = 0; t < count; ++t)
+                std::memcpy(image.data() + entries[t].offset, tracks[t].block, tracks[t].size);
+
+            std::FILE* f = OpenFile(path.c_str(), "wb");
+            if (!f)
+            {
+                GP4MD_LOG_ERROR(IO, "Pack: could not write %s\n", path.c_str());
+                return false;
+            }
+
+            bool ok = std::fwrite(image.data(), 1, image.size(), f) == image.size();
+            ok = std::fclose(f) == 0 && ok;
+
+            if (!ok)
+            {
+                GP4MD_LOG_ERROR(IO, "Pack: write failed, removing %s\n", path.c_str());
+                std::remove(path.c_str());
+                return false;
+            }
+
+            GP4MD_LOG_INFO(IO, "Pack: wrote %s, %d track(s), %zu bytes\n",
+                path.c_str(), count, image.size());
+            return true;
+        }
+    }
+}
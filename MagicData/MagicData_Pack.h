@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "MagicData.h"
+
+namespace MagicData
+{
+    // One track of a pack: its block after the .dat and Track INI layers
+    // (descriptors, bump region and terminator), its laps and what
+    // RaceSettings needs from the Track INI.
+    struct PackTrack
+    {
+        const std::uint8_t* block = nullptr;
+        std::size_t         size = 0;
+        std::uint8_t        laps = 0;
+        std::uint8_t        sprintLaps = 0;     // 0 = none
+        bool                hasTrackIni = false; // RaceSettings applies
+    };
+
+    // Precompiled season (.gp4mdpack): header, a directory with one entry
+    // per track slot (offset, size, laps, FNV-1a of the block) and the
+    // blocks, 16-byte aligned. Written with [General] PackCompile=1 and read
+    // with Pack=<file>; the pack stands in for the .dat and Track INI layers,
+    // so a Track INI that is present still overrides it, and RaceSettings is
+    // applied on top as usual.
+    //
+    // The open pack is mapped read-only and handed out as zero-copy views;
+    // the only copy of a block is the one into its arena slot.
+    namespace Pack
+    {
+        // Maps path and checks header, directory and every block checksum.
+        // The pack must hold g_TrackCount slots. Views stay valid until Close.
+        bool Open(const std::string& path);
+        void Close();
+
+        bool IsOpen();
+
+        // Directory checksum of the open pack, 0 without one (snapshot key).
+        std::uint64_t Checksum();
+
+        bool Get(int trackIndex, PackTrack& out);
+
+        // Writes tracks[0..count) to path.
+        bool Write(const std::string& path, const PackTrack* tracks, int count);
+    }
+}
@@ -0,0 +1,201 @@
+#include "MagicData_Publish.h"
+#include "../Core/Logging.h"
+#include "../Core/Platform.h"
+#include <vector>
+
+namespace MagicData
+{
+    namespace Publish
+    {
+        std::atomic<std::uint8_t*>* g_TrackBase = nullptr;
+        std::atomic<std::uint32_t> g_Epoch(1);
+        std::atomic<std::uint32_t> g_ReaderEpoch[MAX_READERS] = {};
+
+        namespace
+        {
+            struct Generation
+            {
+                std::uint8_t* mem = nullptr;
+                std::size_t   size = 0;
+                int           live = 0;        // tracks still published from here
+                std::uint32_t retireEpoch = 0; // epoch that superseded the last one
+                bool          committed = false;
+                bool          pinned = false;    // kept while not live
+            };
+
+            std::vector<std::atomic<std::uint8_t*>> g_TrackBaseTable;
+
+            // Writer-side bookkeeping; the startup arena is owner nullptr.
+            std::vector<Generation>    g_Generations;
+            std::vector<std::uint8_t*> g_Owner;
+            int                        g_Reclaimed = 0;
+
+            Generation* FindGeneration(const std::uint8_t* mem)
+            {
+                for (Generation& g : g_Generations)
+                {
+                    if (g.mem == mem)
+                        return &g;
+                }
+                return nullptr;
+            }
+
+            void FreeAll()
+            {
+                for (Generation& g : g_Generations)
+                    Platform::FreePages(g.mem, g.size);
+
+                g_Generations.clear();
+            }
+        }
+
+        void Resize(int trackCount)
+        {
+            FreeAll();
+
+            g_TrackBaseTable = std::vector<std::atomic<std::uint8_t*>>(trackCount);
+            g_TrackBase = g_TrackBaseTable.data();
+            g_Owner.assign(trackCount, nullptr);
+        }
+
+        void Reset()
+        {
+            FreeAll();
+
+            for (int t = 0; t < g_TrackCount; ++t)
+            {
+                g_Owner[t] = nullptr;
+                g_TrackBase[t].store(g_Layout[t].base);
+            }
+
+            g_Epoch.fetch_add(1);
+        }
+
+        std::uint8_t* NewGeneration(std::size_t size)
+        {
+            Generation g;
+            g.mem = static_cast<std::uint8_t*>(Platform::AllocPages(size));
+            g.size = size;
+            if (!g.mem)
+                return nullptr;
+
+            g_Generations.push_back(g);
+            return g.mem;
+        }
+
+        void Commit(std::uint8_t* gen, TrackMask trackMask)
+        {
+            Generation* fresh = gen ? FindGeneration(gen) : nullptr;
+            if (gen && !fresh)
+                return;
+
+            // A pinned generation may come back after it was retired
+            if (fresh)
+            {
+                fresh->committed = true;
+                fresh->retireEpoch = 0;
+            }
+
+            // Pointers first, then the epoch: a reader that sees the new
+            // epoch is guaranteed to load the new pointers.
+            std::vector<std::uint8_t*> replaced(g_TrackCount, nullptr);
+
+            for (int t = 0; t < g_TrackCount; ++t)
+            {
+                if (!(trackMask & (TrackMask(1) << t)))
+                    continue;
+
+                replaced[t] = g_Owner[t];
+                g_Owner[t] = gen;
+                if (fresh)
+                    ++fresh->live;
+
+                g_TrackBase[t].store(g_Layout[t].base);
+            }
+
+            const std::uint32_t epoch = g_Epoch.fetch_add(1) + 1;
+
+            for (int t = 0; t < g_TrackCount; ++t)
+            {
+                if (!replaced[t])
+                    continue;
+
+                Generation* old = FindGeneration(replaced[t]);
+                if (old && --old->live == 0)
+                    old->retireEpoch = epoch;
+            }
+
+            if (fresh && fresh->live == 0)
+                fresh->retireEpoch = epoch;
+        }
+
+        void Pin(std::uint8_t* gen, bool pinned)
+        {
+            Generation* g = FindGeneration(gen);
+            if (!g)
+                return;
+
+            g->pinned = pinned;
+            if (pinned || g->committed)
+                return;
+
+            // Never published: no reader can hold it
+            Platform::FreePages(g->mem, g->size);
+            g_Generations.erase(g_Generations.begin() + (g - g_Generations.data()));
+        }
+
+        int Reclaim()
+        {
+            // Oldest epoch any reader may still be using; readers that never
+            // ran hold nothing.
+            std::uint32_t oldest = 0xFFFFFFFFu;
+            for (int r = 0; r < MAX_READERS; ++r)
+            {
+                const std::uint32_t e = g_ReaderEpoch[r].load();
+                if (e != 0 && e < oldest)
+                    oldest = e;
+            }
+
+            int freed = 0;
+            for (std::size_t i = 0; i < g_Generations.size();)
+            {
+                const Generation& g = g_Generations[i];
+                if (g.committed && !g.pinned && g.live == 0 && g.retireEpoch != 0 &&
+                    oldest >= g.retireEpoch)
+                {
+                    Platform::FreePages(g.mem, g.size);
+                    g_Generations.erase(g_Generations.begin() + i);
+                    ++freed;
+                    continue;
+                }
+                ++i;
+            }
+
+            g_Reclaimed += freed;
+            return freed;
+        }
+
+        std::size_t GenerationBytes()
+        {
+            std::size_t bytes = 0;
+            for (const Generation& g : g_Generations)
+                bytes += g.size;
+
+            return bytes;
+        }
+
+        void LogStats()
+        {
+            int retired = 0;
+            for (const Generation& g : g_Generations)
+            {
+                if (g.live == 0)
+                    ++retired;
+            }
+
+            GP4MD_LOG_DEBUG(MagicData, "Publish: epoch=%u generations=%zu (retired %d), reclaimed %d, hook epoch=%u\n",
+                g_Epoch.load(), g_Generations.size(), retired, g_Reclaimed,
+                g_ReaderEpoch[HOOK_READER].load());
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include "MagicData.h"
+
+namespace MagicData
+{
+    // Lock-free publication of the relocated blocks the hooks hand to GP4.
+    //
+    // Each track has one atomic base pointer. A reload builds its tracks in a
+    // new generation (one allocation), stores the new pointers and then bumps
+    // the epoch. A reader announces the epoch it read before loading a
+    // pointer, and GP4 keeps using that block until the hook runs again, so
+    // the announcement stays in force until the reader's next call. A
+    // superseded generation is freed once every active reader has announced
+    // an epoch at or past its retirement.
+    namespace Publish
+    {
+        constexpr int MAX_READERS = 8;
+        constexpr int HOOK_READER = 0; // GP4 thread running the GPxTrack hooks
+
+        extern std::atomic<std::uint8_t*>* g_TrackBase;                 // g_TrackCount entries
+        extern std::atomic<std::uint32_t>  g_Epoch;                     // starts at 1
+        extern std::atomic<std::uint32_t>  g_ReaderEpoch[MAX_READERS];  // 0 = never read
+
+        // Hook hot path: two loads and one store, no locks.
+        inline std::uint8_t* Acquire(int trackIndex, int reader)
+        {
+            const std::uint32_t e = g_Epoch.load();
+            g_ReaderEpoch[reader].store(e);
+            return g_TrackBase[trackIndex].load();
+        }
+
+        // --- writer side (one writer at a time) -------------------------------
+
+        // Sizes the per-track tables (from SetTrackCount); frees all
+        // generations. Only before the hooks are installed.
+        void Resize(int trackCount);
+
+        // Publishes g_Layout[t].base (the static arena) for every track and
+        // frees all generations. Only before the hooks are installed.
+        void Reset();
+
+        // Memory for a new generation; published by Commit.
+        std::uint8_t* NewGeneration(std::size_t size);
+
+        // Swaps in g_Layout[t].base for every track in trackMask (all of them
+        // inside gen, or inside the static arena when gen is nullptr), bumps
+        // the epoch once and retires what they replaced.
+        void Commit(std::uint8_t* gen, TrackMask trackMask);
+
+        // A pinned generation is kept while none of its tracks is published,
+        // so it can be committed again (race profiles). Unpinning lets
+        // Reclaim free it; one that was never committed is freed at once.
+        void Pin(std::uint8_t* gen, bool pinned);
+
+        // Frees retired generations no reader can still hold; returns count.
+        int Reclaim();
+
+        // Bytes held by generations that are not reclaimed yet.
+        std::size_t GenerationBytes();
+
+        void LogStats();
+    }
+}
@@ -0,0 +1,214 @@
+#include "MagicData_Reload.h"
+#include "MagicData.h"
+#include "../Core/Logging.h"
+#include "../Core/Platform.h"
+#include "MagicData_Internal.h"
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MagicData
+{
+    namespace
+    {
+        // Last seen state of one input file
+        struct InputStamp
+        {
+            bool          exists = false;
+            std::uint64_t size = 0;
+            std::uint64_t mtime = 0;
+        };
+
+        // Slot 0 is GP4MD.ini, slot t + 1 is Track(t + 1).ini
+        using InputStamps = std::vector<InputStamp>;
+
+        // Never destroyed while running: a joinable std::thread left to a
+        // static destructor at DLL unload would call std::terminate.
+        std::thread*      g_Watcher = nullptr;
+        std::atomic<bool> g_Stop(false);
+
+        // Race profile control file: its first line names the profile to
+        // activate (empty = RaceSettings)
+        const char* const k_ControlFile = "GP4MD.profile";
+
+        std::string InputPath(const std::string& folder, int slot)
+        {
+            if (slot == 0)
+                return folder + "GP4MD.ini";
+
+            char file[32];
+            std::snprintf(file, sizeof(file), "Track%02d.ini", slot);
+            return folder + file;
+        }
+
+        void StampInputs(const std::string& folder, InputStamps& stamps)
+        {
+            stamps.resize(g_TrackCount + 1);
+
+            for (int i = 0; i <= g_TrackCount; ++i)
+            {
+                InputStamp& s = stamps[i];
+                s.exists = Platform::StatFile(InputPath(folder, i), s.size, s.mtime);
+            }
+        }
+
+        bool SameStamp(const InputStamp& a, const InputStamp& b)
+        {
+            return a.exists == b.exists && a.size == b.size && a.mtime == b.mtime;
+        }
+
+        // Re-stats the inputs; returns the mask of tracks to rebuild.
+        TrackMask CollectChanges(const std::string& folder, InputStamps& stamps)
+        {
+            InputStamps now;
+            StampInputs(folder, now);
+
+            TrackMask mask = 0;
+
+            if (!SameStamp(now[0], stamps[0]))
+            {
+                GP4MD_LOG_INFO(MagicData, "Reload: GP4MD.ini changed, rebuilding all tracks\n");
+                mask = ~TrackMask(0) >> (MAX_TRACK_COUNT - g_TrackCount);
+            }
+
+            for (int t = 0; t < g_TrackCount; ++t)
+            {
+                if (!SameStamp(now[t + 1], stamps[t + 1]))
+                {
+                    GP4MD_LOG_INFO(MagicData, "Reload: Track%02d.ini changed\n", t + 1);
+                    mask |= TrackMask(1) << t;
+                }
+            }
+
+            stamps.swap(now);
+            return mask;
+        }
+
+        // Activates the profile the control file names when it changed
+        // since control was taken.
+        void CheckControlFile(const std::string& folder, InputStamp& control)
+        {
+            InputStamp now;
+            now.exists = Platform::StatFile(folder + k_ControlFile, now.size, now.mtime);
+
+            if (SameStamp(now, control))
+                return;
+
+            control = now;
+
+            std::string text;
+            if (!now.exists || !Platform::ReadWholeFile(folder + k_ControlFile, text))
+                return;
+
+            std::string name = text.substr(0, text.find_first_of("\r\n"));
+            name.erase(0, name.find_first_not_of(" \t"));
+            name.erase(name.find_last_not_of(" \t") + 1);
+
+            ActivateProfile(name);
+        }
+
+        // reloadInputs: HotReload=1; without it only the control file is
+        // watched.
+        void WatchLoop(std::string folder, unsigned settleMs, bool reloadInputs)
+        {
+            InputStamps stamps;
+            StampInputs(folder, stamps);
+
+            // A control file left from the last session selects the profile now
+            InputStamp control;
+            CheckControlFile(folder, control);
+
+            Platform::FolderWatch watch;
+            const bool watching = Platform::WatchFolder(folder, watch);
+            if (!watching)
+                GP4MD_LOG_INFO(MagicData, "Reload: folder notifications unavailable, polling\n");
+
+            while (!g_Stop)
+            {
+                // The timeout only bounds how long a stop request waits; with
+                // no notifications it doubles as the polling interval.
+                if (watching)
+                {
+                    if (!Platform::WaitFolderChange(watch, 500))
+                        continue;
+                }
+                else
+                {
+                    Platform::SleepMs(1000);
+                }
+
+                // A profile switch does not wait for the settle delay
+                CheckControlFile(folder, control);
+                if (!reloadInputs)
+                    continue;
+
+                // Editors often save in several writes; let them settle
+                // and fold any follow-up notifications into this reload.
+                Platform::SleepMs(settleMs);
+                while (watching && Platform::WaitFolderChange(watch, 0))
+                {
+                }
+
+                const TrackMask mask = CollectChanges(folder, stamps);
+                if (mask && !g_Stop)
+                    ReloadTracks(mask);
+            }
+
+            if (watching)
+                Platform::CloseFolderWatch(watch);
+        }
+    }
+
+    void StartHotReload()
+    {
+        if (g_Watcher)
+            return;
+
+        const std::string folder = Platform::ModuleFolder();
+
+        // The startup read of GP4MD.ini
+        const IniText::Document& ini = MagicDataInternal::StartupIni();
+        if (!ini.present)
+            return;
+
+        int value = 0;
+
+        const IniText::Entry* e = ini.Find("General", "HotReload");
+        const bool hotReload = e && IniText::ParseInt(e->value, value) && value != 0;
+
+        // Race profiles are switched through the control file, watched
+        // even without HotReload
+        if (!hotReload && ProfileCount() == 0)
+            return;
+
+        int settleMs = 200;
+        e = ini.Find("General", "HotReloadDelay");
+        if (e && IniText::ParseInt(e->value, value) && value >= 0)
+            settleMs = value;
+
+        GP4MD_LOG_INFO(MagicData, "Reload: watching %s%s\n", folder.c_str(),
+            hotReload ? "" : " (profile control file only)");
+
+        g_Stop = false;
+        g_Watcher = new std::thread(WatchLoop, folder, static_cast<unsigned>(settleMs), hotReload);
+    }
+
+    void StopHotReload()
+    {
+        if (!g_Watcher)
+            return;
+
+        g_Stop = true;
+        g_Watcher->join();
+
+        delete g_Watcher;
+        g_Watcher = nullptr;
+    }
+
+    void SignalHotReloadStop()
+    {
+        g_Stop = true;
+    }
+}
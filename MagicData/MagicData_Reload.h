@@ -0,0 +1,21 @@
+#pragma once
+
+namespace MagicData
+{
+    // Watches the DLL folder and, when GP4MD.ini or a TrackNN.ini changes,
+    // rebuilds only the affected tracks (GP4MD.ini affects all of them).
+    // With race profiles it also activates the one GP4MD.profile names,
+    // at start and whenever the file changes. Does nothing unless
+    // [General] HotReload=1 or a profile is defined. Call after
+    // PatchAllTracks.
+    void StartHotReload();
+
+    // Stops and joins the watcher thread. Not under the loader lock: the
+    // thread's exit needs it.
+    void StopHotReload();
+
+    // DLL detach: only asks the watcher to stop (within 500 ms, or never
+    // if the process is exiting). The thread object is left alive on
+    // purpose, so nothing is joined or destroyed under the loader lock.
+    void SignalHotReloadStop();
+}
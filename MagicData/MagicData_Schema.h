@@ -0,0 +1,317 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// Compile-time magicdata descriptor schema: desc1..desc139 in block order.
+// Offsets are spelled out so they can be read against a hex dump, and are
+// checked against the type sizes below.
+
+namespace MagicData
+{
+    constexpr int DESC_COUNT = 139;
+
+    enum class DescType { SETUP_BYTE, U8, U16, U32 };
+
+    struct DescInfo
+    {
+        DescType    type{};
+        std::size_t offset{};
+        const char* comment{};
+    };
+
+    constexpr std::size_t DescSize(DescType t)
+    {
+        return t == DescType::U32 ? 4 : t == DescType::U16 ? 2 : 1;
+    }
+
+    constexpr DescInfo g_Desc[DESC_COUNT] = {
+        // 1–24: setup bytes
+        /*   1 */ { DescType::SETUP_BYTE, 0x000, "Front wing [CC dry setup]" },
+        /*   2 */ { DescType::SETUP_BYTE, 0x001, "Rear wing" },
+        /*   3 */ { DescType::SETUP_BYTE, 0x002, "1st gear" },
+        /*   4 */ { DescType::SETUP_BYTE, 0x003, "2nd" },
+        /*   5 */ { DescType::SETUP_BYTE, 0x004, "3rd" },
+        /*   6 */ { DescType::SETUP_BYTE, 0x005, "4th" },
+        /*   7 */ { DescType::SETUP_BYTE, 0x006, "5th" },
+        /*   8 */ { DescType::SETUP_BYTE, 0x007, "6th" },
+
+        /*   9 */ { DescType::SETUP_BYTE, 0x008, "Front wing [CC wet setup]" },
+        /*  10 */ { DescType::SETUP_BYTE, 0x009, "Rear wing" },
+        /*  11 */ { DescType::SETUP_BYTE, 0x00A, "1st gear" },
+        /*  12 */ { DescType::SETUP_BYTE, 0x00B, "2nd" },
+        /*  13 */ { DescType::SETUP_BYTE, 0x00C, "3rd" },
+        /*  14 */ { DescType::SETUP_BYTE, 0x00D, "4th" },
+        /*  15 */ { DescType::SETUP_BYTE, 0x00E, "5th" },
+        /*  16 */ { DescType::SETUP_BYTE, 0x00F, "6th" },
+
+        /*  17 */ { DescType::SETUP_BYTE, 0x010, "Front wing [Player dry setup]" },
+        /*  18 */ { DescType::SETUP_BYTE, 0x011, "Rear wing" },
+        /*  19 */ { DescType::SETUP_BYTE, 0x012, "1st gear" },
+        /*  20 */ { DescType::SETUP_BYTE, 0x013, "2nd" },
+        /*  21 */ { DescType::SETUP_BYTE, 0x014, "3rd" },
+        /*  22 */ { DescType::SETUP_BYTE, 0x015, "4th" },
+        /*  23 */ { DescType::SETUP_BYTE, 0x016, "5th" },
+        /*  24 */ { DescType::SETUP_BYTE, 0x017, "6th" },
+
+        // 25: U32
+        /*  25 */ { DescType::U32, 0x018, "Dry brake balance" },
+
+        // 26–33: setup bytes
+        /*  26 */ { DescType::SETUP_BYTE, 0x01C, "Front wing [Player wet setup]" },
+        /*  27 */ { DescType::SETUP_BYTE, 0x01D, "Rear wing" },
+        /*  28 */ { DescType::SETUP_BYTE, 0x01E, "1st gear" },
+        /*  29 */ { DescType::SETUP_BYTE, 0x01F, "2nd" },
+        /*  30 */ { DescType::SETUP_BYTE, 0x020, "3rd" },
+        /*  31 */ { DescType::SETUP_BYTE, 0x021, "4th" },
+        /*  32 */ { DescType::SETUP_BYTE, 0x022, "5th" },
+        /*  33 */ { DescType::SETUP_BYTE, 0x023, "6th" },
+
+        // 34: U32
+        /*  34 */ { DescType::U32, 0x024, "Wet brake balance" },
+
+        // 35–36: U8
+        /*  35 */ { DescType::U8, 0x028, "Softer tyre [52 Hard, 53 Medium, 54 Soft, 55 Supersoft]" },
+        /*  36 */ { DescType::U8, 0x029, "Harder tyre [52 Hard, 53 Medium, 54 Soft, 55 Supersoft]" },
+
+        // 37: U16
+        /*  37 */ { DescType::U16, 0x02A, ">= 50 AI chooses softer tyre, otherwise harder" },
+
+        // 38–41: U16
+        /*  38 */ { DescType::U16, 0x02C, "" },
+        /*  39 */ { DescType::U16, 0x02E, "" },
+        /*  40 */ { DescType::U16, 0x030, "" },
+        /*  41 */ { DescType::U16, 0x032, "" },
+
+        // 42–46: U16
+        /*  42 */ { DescType::U16, 0x034, "Track grip" },
+        /*  43 */ { DescType::U16, 0x036, "" },
+        /*  44 */ { DescType::U16, 0x038, "" },
+        /*  45 */ { DescType::U16, 0x03A, "Temperature (deg C) - warmer = higher top speed, less grip (17–31)" },
+        /*  46 */ { DescType::U16, 0x03C, "Air Pressure (hPa) – affects PLAYER downforce & drag" },
+
+        // 47–73: U16
+        /*  47 */ { DescType::U16, 0x03E, "Engine power output (altitude simulation)" },
+        /*  48 */ { DescType::U16, 0x040, "Fuel per lap (2979 = 1 kg/lap)" },
+        /*  49 */ { DescType::U16, 0x042, "CC yield (higher = faster start)" },
+        /*  50 */ { DescType::U16, 0x044, "Player tyre wear factor" },
+        /*  51 */ { DescType::U16, 0x046, "CC aggressiveness min (Braking Range)" },
+        /*  52 */ { DescType::U16, 0x048, "CC aggressiveness max (Braking Range)" },
+
+        /*  53 */ { DescType::U16, 0x04A, "[Ace] CC power factor" },
+        /*  54 */ { DescType::U16, 0x04C, "[Ace] CC grip factor" },
+        /*  55 */ { DescType::U16, 0x04E, "[Pro] CC power factor" },
+        /*  56 */ { DescType::U16, 0x050, "[Pro] CC grip factor" },
+        /*  57 */ { DescType::U16, 0x052, "[Semi-Pro] CC power factor" },
+        /*  58 */ { DescType::U16, 0x054, "[Semi-Pro] CC grip factor" },
+        /*  59 */ { DescType::U16, 0x056, "[Amateur] CC power factor" },
+        /*  60 */ { DescType::U16, 0x058, "[Amateur] CC grip factor" },
+        /*  61 */ { DescType::U16, 0x05A, "[Rookie] CC power factor" },
+        /*  62 */ { DescType::U16, 0x05C, "[Rookie] CC grip factor" },
+
+        /*  63 */ { DescType::U16, 0x05E, "CC random performance range min" },
+        /*  64 */ { DescType::U16, 0x060, "CC random performance range max" },
+        /*  65 */ { DescType::U16, 0x062, "CC error chance" },
+        /*  66 */ { DescType::U16, 0x064, "CC recovery sectors" },
+
+        /*  67 */ { DescType::U16, 0x066, "Sectors to pit-in begin" },
+        /*  68 */ { DescType::U16, 0x068, "Sectors to pit-out end" },
+        /*  69 */ { DescType::U16, 0x06A, "Pre-pit speed limit" },
+
+        /*  70 */ { DescType::U16, 0x06C, "Fuel consumption Player" },
+        /*  71 */ { DescType::U16, 0x06E, "Fuel consumption CC" },
+        /*  72 */ { DescType::U16, 0x070, "Tyre wear" },
+        /*  73 */ { DescType::U16, 0x072, "Sector where AI stop being cautious on lap 1" },
+
+        // 74–77: U32
+        /*  74 */ { DescType::U32, 0x074, "Hotseat turn duration (70800 = 1:10.800)" },
+        /*  75 */ { DescType::U32, 0x078, "Real-time factor (+/-1000 = +/-1.0)" },
+        /*  76 */ { DescType::U32, 0x07C, "Tyre change decision factor (dry↔wet)" },
+        /*  77 */ { DescType::U32, 0x080, "Same as above?" },
+        /*  78 */ { DescType::U16, 0x084, "Rain chance" },
+
+        // 79–81: U16
+        /*  79 */ { DescType::U16, 0x086, "Segment start for pit in/out surface detection" },
+        /*  80 */ { DescType::U16, 0x088, "Segment end for pit in/out surface detection" },
+        /*  81 */ { DescType::U16, 0x08A, "CC race grip (always 256)" },
+
+        // 82–101: U32
+        /*  82 */ { DescType::U32, 0x08C, "Time duration (ms) related to pits" },
+        /*  83 */ { DescType::U32, 0x090, "Segment where player starts in quicklaps" },
+        /*  84 */ { DescType::U32, 0x094, "Black Flag penalty (ms) (10000–30000)" },
+        /*  85 */ { DescType::U32, 0x098, "Black Flag severity (1024 = 80 kph)" },
+        /*  86 */ { DescType::U32, 0x09C, "Wet CC engine mapping" },
+        /*  87 */ { DescType::U32, 0x0A0, "Wet CC tyre wear & grip factor (higher = more)" },
+        /*  88 */ { DescType::U32, 0x0A4, "Wet CC tyre wear factor (lower = more)" },
+        /*  89 */ { DescType::U32, 0x0A8, "Wet CC grip factor (lower = more)" },
+        /*  90 */ { DescType::U32, 0x0AC, "\"Handbrake\" – stop car moving in garage" },
+        /*  91 */ { DescType::U32, 0x0B0, "Car depth in garage (Player)" },
+        /*  92 */ { DescType::U32, 0x0B4, "Car depth in garage (AI)" },
+        /*  93 */ { DescType::U32, 0x0B8, "Car orientation in garage" },
+        /*  94 */ { DescType::U32, 0x0BC, "Pitstop stall depth from pitlane" },
+        /*  95 */ { DescType::U32, 0x0C0, "Pitstop stall depth finetune" },
+        /*  96 */ { DescType::U32, 0x0C4, "Tyre wear multiplier dry-soft (16384 = 100%)" },
+        /*  97 */ { DescType::U32, 0x0C8, "Tyre wear multiplier dry-hard (16384 = 100%)" },
+        /*  98 */ { DescType::U32, 0x0CC, "Tyre wear multiplier intermediate (16384 = 100%)" },
+        /*  99 */ { DescType::U32, 0x0D0, "Tyre wear multiplier wet-soft (16384 = 100%)" },
+        /* 100 */ { DescType::U32, 0x0D4, "Tyre wear multiplier wet-hard (16384 = 100%)" },
+        /* 101 */ { DescType::U32, 0x0D8, "Tyre wear multiplier monsoon (16384 = 100%)" },
+
+        // 102–139: U16
+        /* 102 */ { DescType::U16, 0x0DC, "Pitstop group 1 %" },
+        /* 103 */ { DescType::U16, 0x0DE, "Stop 1" },
+        /* 104 */ { DescType::U16, 0x0E0, "Pit window 1" },
+        /* 105 */ { DescType::U16, 0x0E2, "" },
+        /* 106 */ { DescType::U16, 0x0E4, "" },
+        /* 107 */ { DescType::U16, 0x0E6, "" },
+        /* 108 */ { DescType::U16, 0x0E8, "" },
+        /* 109 */ { DescType::U16, 0x0EA, "" },
+
+        /* 110 */ { DescType::U16, 0x0EC, "Pitstop group 2 %" },
+        /* 111 */ { DescType::U16, 0x0EE, "Stop 1" },
+        /* 112 */ { DescType::U16, 0x0F0, "Pit window 1" },
+        /* 113 */ { DescType::U16, 0x0F2, "Stop 2" },
+        /* 114 */ { DescType::U16, 0x0F4, "Pit window 2" },
+        /* 115 */ { DescType::U16, 0x0F6, "" },
+        /* 116 */ { DescType::U16, 0x0F8, "" },
+        /* 117 */ { DescType::U16, 0x0FA, "" },
+
+        /* 118 */ { DescType::U16, 0x0FC, "Pitstop group 3 %" },
+        /* 119 */ { DescType::U16, 0x0FE, "Stop 1" },
+        /* 120 */ { DescType::U16, 0x100, "Pit window 1" },
+        /* 121 */ { DescType::U16, 0x102, "Stop 2" },
+        /* 122 */ { DescType::U16, 0x104, "Pit window 2" },
+        /* 123 */ { DescType::U16, 0x106, "Stop 3" },
+        /* 124 */ { DescType::U16, 0x108, "Pit window 3" },
+        /* 125 */ { DescType::U16, 0x10A, "" },
+
+        /* 126 */ { DescType::U16, 0x10C, "Failure chance: suspension" },
+        /* 127 */ { DescType::U16, 0x10E, "Failure chance: loose wheel" },
+        /* 128 */ { DescType::U16, 0x110, "Failure chance: puncture" },
+        /* 129 */ { DescType::U16, 0x112, "Failure chance: engine" },
+        /* 130 */ { DescType::U16, 0x114, "Failure chance: transmission" },
+        /* 131 */ { DescType::U16, 0x116, "Failure chance: oil/water leak" },
+        /* 132 */ { DescType::U16, 0x118, "Failure chance: throttle/brake" },
+        /* 133 */ { DescType::U16, 0x11A, "Failure chance: electrics" },
+
+        /* 134 */ { DescType::U16, 0x11C, "" },
+        /* 135 */ { DescType::U16, 0x11E, "" },
+        /* 136 */ { DescType::U16, 0x120, "" },
+        /* 137 */ { DescType::U16, 0x122, "" },
+
+        /* 138 */ { DescType::U16, 0x124, "Bump factor" },
+        /* 139 */ { DescType::U16, 0x126, "Bump shift" },
+    };
+
+    // Size of the descriptor region; the bump table starts right after it.
+    constexpr std::size_t LAST_DESC_END =
+        g_Desc[DESC_COUNT - 1].offset + DescSize(g_Desc[DESC_COUNT - 1].type);
+
+    constexpr bool DescOffsetsAreContiguous()
+    {
+        if (g_Desc[0].offset != 0)
+            return false;
+
+        for (int i = 1; i < DESC_COUNT; ++i)
+        {
+            if (g_Desc[i].offset != g_Desc[i - 1].offset + DescSize(g_Desc[i - 1].type))
+                return false;
+        }
+        return true;
+    }
+
+    static_assert(DescOffsetsAreContiguous(), "descriptor offsets must follow the type sizes");
+    static_assert(LAST_DESC_END == 0x128, "GP4 magicdata descriptor region is 296 bytes");
+
+    // -------------------------------------------------------------------------
+    // Typed access: Desc<48>::Read(base) is a plain uint16_t load at 0x040
+    // -------------------------------------------------------------------------
+    template <DescType T> struct DescStorage;
+    template <> struct DescStorage<DescType::SETUP_BYTE> { using type = std::uint8_t; };
+    template <> struct DescStorage<DescType::U8> { using type = std::uint8_t; };
+    template <> struct DescStorage<DescType::U16> { using type = std::uint16_t; };
+    template <> struct DescStorage<DescType::U32> { using type = std::uint32_t; };
+
+    template <int D>
+    struct Desc
+    {
+        static_assert(D >= 1 && D <= DESC_COUNT, "descriptor index out of range");
+
+        static constexpr DescType    type = g_Desc[D - 1].type;
+        static constexpr std::size_t offset = g_Desc[D - 1].offset;
+
+        using value_type = typename DescStorage<type>::type;
+
+        static value_type Read(const std::uint8_t* base)
+        {
+            value_type v;
+            std::memcpy(&v, base + offset, sizeof(v));
+            return v;
+        }
+
+        static void Write(std::uint8_t* base, value_type v)
+        {
+            std::memcpy(base + offset, &v, sizeof(v));
+        }
+    };
+
+    // -------------------------------------------------------------------------
+    // Key names: "desc1".."desc139" without runtime formatting, and the
+    // reverse mapping key -> index in O(1) (the digits are the hash).
+    // -------------------------------------------------------------------------
+    struct DescKeyTable
+    {
+        char name[DESC_COUNT][8];
+
+        constexpr DescKeyTable() : name{}
+        {
+            for (int d = 1; d <= DESC_COUNT; ++d)
+            {
+                char* p = name[d - 1];
+                p[0] = 'd'; p[1] = 'e'; p[2] = 's'; p[3] = 'c';
+
+                int i = 4;
+                if (d >= 100) p[i++] = static_cast<char>('0' + d / 100);
+                if (d >= 10)  p[i++] = static_cast<char>('0' + d / 10 % 10);
+                p[i] = static_cast<char>('0' + d % 10);
+            }
+        }
+    };
+
+    constexpr DescKeyTable g_DescKeys{};
+
+    inline const char* DescKey(int descIndex)
+    {
+        return g_DescKeys.name[descIndex - 1];
+    }
+
+    constexpr char LowerAscii(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    // "descN" (case-insensitive prefix, no leading zeros) -> N in 1..139, else 0.
+    constexpr int FindDescKey(const char* key)
+    {
+        if (!key ||
+            LowerAscii(key[0]) != 'd' || LowerAscii(key[1]) != 'e' ||
+            LowerAscii(key[2]) != 's' || LowerAscii(key[3]) != 'c')
+            return 0;
+
+        int value = 0;
+        int digits = 0;
+        for (const char* p = key + 4; *p; ++p)
+        {
+            if (*p < '0' || *p > '9' || digits == 3 || (digits == 0 && *p == '0'))
+                return 0;
+
+            value = value * 10 + (*p - '0');
+            ++digits;
+        }
+
+        return (digits > 0 && value <= DESC_COUNT) ? value : 0;
+    }
+
+    static_assert(FindDescKey("desc48") == 48 && FindDescKey("Desc139") == 139, "key lookup");
+    static_assert(FindDescKey("desc140") == 0 && FindDescKey("desc048") == 0, "key lookup");
+}
@@ -0,0 +1,273 @@
+#include "MagicData_Snapshot.h"
+#include "MagicData.h"
+#include "MagicData_IO.h"
+#include "MagicData_Internal.h"
+#include "MagicData_Pack.h"
+#include "../Core/Hash.h"
+#include "../Core/FileIO.h"
+#include "../Core/Logging.h"
+#include "../Core/Platform.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace MagicData
+{
+    SnapshotStats g_SnapshotStats;
+
+    namespace
+    {
+        constexpr char          kSnapshotFile[] = "GP4MD.snapshot";
+        constexpr char          kSnapshotMagic[8] = { 'G', 'P', '4', 'M', 'D', 'S', 'N', 'P' };
+        constexpr std::uint32_t kSnapshotVersion = 4;
+
+        struct SnapshotHeader
+        {
+            char          magic[8];
+            std::uint32_t version;
+            std::uint32_t trackCount;
+            std::uint64_t inputsKey;
+            std::uint64_t key;
+            std::uint64_t payloadHash;
+            std::uint32_t arenaBytes;
+            std::uint32_t lapOffset;
+        };
+
+        struct SnapshotTrack
+        {
+            std::uint32_t baseOffset;
+            std::uint32_t bumpOffset;
+            std::uint32_t bumpBytes;
+            std::uint32_t bumpSize;
+            std::uint32_t blockBytes; // arena block, tail included
+        };
+
+        std::uint64_t HashStat(const std::string& path, std::uint64_t h)
+        {
+            std::uint64_t size = 0;
+            std::uint64_t mtime = 0;
+            const bool    present = Platform::StatFile(path, size, mtime);
+
+            h = HashValue(present, h);
+            h = HashValue(size, h);
+            return HashValue(mtime, h);
+        }
+    }
+
+    std::uint64_t ComputeInputsKey(const std::string& folder)
+    {
+        std::uint64_t h = FNV1A_OFFSET;
+
+        h = HashValue(kSnapshotVersion, h);
+        h = HashValue(Platform::ModuleBuildId(), h);
+
+        h = HashValue(g_TrackCount, h);
+        h = HashValue(Pack::Checksum(), h);
+
+        // Size + mtime of every file is enough to detect edits; nothing is
+        // read here
+        h = HashStat(folder + "GP4MD.ini", h);
+
+        for (int t = 0; t < g_TrackCount; ++t)
+        {
+            char file[64];
+            std::snprintf(file, sizeof(file), "Track%02d.ini", t + 1);
+
+            h = HashStat(GetDatPath(t), h);
+            h = HashStat(folder + file, h);
+        }
+
+        return h;
+    }
+
+    std::uint64_t ComputeSnapshotKey(std::uint64_t inputsKey)
+    {
+        std::uint64_t h = inputsKey;
+
+        // Original GP4 magicdata blocks + lap table
+        const std::uint8_t* orig = g_Layout[0].origBase;
+        const std::uint8_t* origEnd = g_LapTableOrig + g_TrackCount;
+        if (orig && origEnd > orig)
+            h = HashBytes(orig, static_cast<std::size_t>(origEnd - orig), h);
+
+        return h;
+    }
+
+    bool SnapshotInputsMatch(const std::string& folder, std::uint64_t inputsKey)
+    {
+        Platform::MappedFile file;
+        if (!Platform::MapFileRead(folder + kSnapshotFile, file))
+            return false;
+
+        SnapshotHeader hdr{};
+        bool           match = false;
+
+        if (file.size >= sizeof(hdr))
+        {
+            std::memcpy(&hdr, file.data, sizeof(hdr));
+            match = std::memcmp(hdr.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) == 0 &&
+                hdr.version == kSnapshotVersion &&
+                hdr.inputsKey == inputsKey;
+        }
+
+        Platform::UnmapFile(file);
+        return match;
+    }
+
+    bool LoadSnapshot(const std::string& folder,
+        std::uint64_t key,
+        Memory::Arena& arena)
+    {
+        Platform::MappedFile file;
+        if (!Platform::MapFileRead(folder + kSnapshotFile, file))
+        {
+            ++g_SnapshotStats.misses;
+            GP4MD_LOG_INFO(IO, "Snapshot: miss (no %s)\n", kSnapshotFile);
+            return false;
+        }
+
+        const std::size_t headerBytes =
+            sizeof(SnapshotHeader) + g_TrackCount * sizeof(SnapshotTrack);
+
+        SnapshotHeader             hdr{};
+        std::vector<SnapshotTrack> tracks(g_TrackCount);
+        const char*                reason = nullptr;
+
+        if (file.size < headerBytes)
+            reason = "truncated";
+        else
+        {
+            std::memcpy(&hdr, file.data, sizeof(hdr));
+            std::memcpy(tracks.data(), file.data + sizeof(hdr), tracks.size() * sizeof(SnapshotTrack));
+
+            if (std::memcmp(hdr.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+                hdr.version != kSnapshotVersion ||
+                hdr.trackCount != static_cast<std::uint32_t>(g_TrackCount))
+                reason = "format";
+            else if (hdr.key != key)
+                reason = "inputs changed";
+            else if (file.size - headerBytes < hdr.arenaBytes ||
+                hdr.lapOffset + g_TrackCount > hdr.arenaBytes)
+                reason = "size";
+            else if (HashBytes(file.data + headerBytes, hdr.arenaBytes) != hdr.payloadHash)
+                reason = "checksum";
+        }
+
+        // Same plan as the build that wrote it; arena options come from
+        // GP4MD.ini, which is part of the key
+        if (!reason)
+        {
+            std::vector<std::size_t> blockBytes(g_TrackCount);
+            for (int t = 0; t < g_TrackCount; ++t)
+                blockBytes[t] = tracks[t].blockBytes;
+
+            const int lapBlock = MagicDataInternal::PlanArena(arena, blockBytes.data());
+
+            if (arena.PlannedBytes() != hdr.arenaBytes ||
+                arena.Blocks()[lapBlock].offset != hdr.lapOffset)
+                reason = "layout";
+        }
+
+        for (int t = 0; !reason && t < g_TrackCount; ++t)
+        {
+            const SnapshotTrack& st = tracks[t];
+            if (st.baseOffset != arena.Blocks()[t].offset ||
+                st.bumpOffset < st.baseOffset ||
+                st.bumpOffset + st.bumpBytes > st.baseOffset + st.blockBytes)
+                reason = "layout";
+        }
+
+        if (!reason && !arena.Allocate())
+            reason = "allocation";
+
+        if (reason)
+        {
+            ++g_SnapshotStats.invalidated;
+            GP4MD_LOG_INFO(IO, "Snapshot: invalidated (%s)\n", reason);
+            Platform::UnmapFile(file);
+            arena.Reset(arena.Options());
+            return false;
+        }
+
+        std::uint8_t* base = arena.Data();
+
+        std::memcpy(base, file.data + headerBytes, hdr.arenaBytes);
+        Platform::UnmapFile(file);
+
+        // Pointer fix-up: everything is stored relative to the arena
+        for (int t = 0; t < g_TrackCount; ++t)
+        {
+            const SnapshotTrack& st = tracks[t];
+            g_Layout[t].base = base + st.baseOffset;
+            g_Layout[t].bumpStart = base + st.bumpOffset;
+            g_Layout[t].bumpEnd = base + st.bumpOffset + st.bumpBytes;
+            g_Layout[t].bumpSize = st.bumpSize;
+        }
+
+        g_LapTable = base + hdr.lapOffset;
+
+        ++g_SnapshotStats.hits;
+        GP4MD_LOG_INFO(IO, "Snapshot: hit (%u bytes)\n", hdr.arenaBytes);
+        return true;
+    }
+
+    bool SaveSnapshot(const std::string& folder,
+        std::uint64_t inputsKey,
+        std::uint64_t key,
+        const Memory::Arena& arena)
+    {
+        const std::uint8_t* base = arena.Data();
+        const std::size_t   usedSize = arena.PlannedBytes();
+
+        SnapshotHeader hdr{};
+        std::memcpy(hdr.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+        hdr.version = kSnapshotVersion;
+        hdr.trackCount = static_cast<std::uint32_t>(g_TrackCount);
+        hdr.inputsKey = inputsKey;
+        hdr.key = key;
+        hdr.payloadHash = HashBytes(base, usedSize);
+        hdr.arenaBytes = static_cast<std::uint32_t>(usedSize);
+        hdr.lapOffset = static_cast<std::uint32_t>(g_LapTable - base);
+
+        std::vector<SnapshotTrack> tracks(g_TrackCount);
+        for (int t = 0; t < g_TrackCount; ++t)
+        {
+            tracks[t].baseOffset = static_cast<std::uint32_t>(g_Layout[t].base - base);
+            tracks[t].bumpOffset = static_cast<std::uint32_t>(g_Layout[t].bumpStart - base);
+            tracks[t].bumpBytes =
+                static_cast<std::uint32_t>(g_Layout[t].bumpEnd - g_Layout[t].bumpStart);
+            tracks[t].bumpSize = static_cast<std::uint32_t>(g_Layout[t].bumpSize);
+            tracks[t].blockBytes = static_cast<std::uint32_t>(arena.Blocks()[t].size);
+        }
+
+        const std::string path = folder + kSnapshotFile;
+        std::FILE* f = OpenFile(path.c_str(), "wb");
+        if (!f)
+        {
+            GP4MD_LOG_ERROR(IO, "Snapshot: could not write %s\n", path.c_str());
+            return false;
+        }
+
+        bool ok = std::fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+        ok = ok && std::fwrite(tracks.data(), sizeof(SnapshotTrack), tracks.size(), f) == tracks.size();
+        ok = ok && std::fwrite(base, 1, usedSize, f) == usedSize;
+        std::fclose(f);
+
+        if (!ok)
+        {
+            GP4MD_LOG_ERROR(IO, "Snapshot: write failed, removing %s\n", path.c_str());
+            std::remove(path.c_str());
+            return false;
+        }
+
+        ++g_SnapshotStats.saves;
+        return true;
+    }
+
+    void LogSnapshotStats()
+    {
+        const SnapshotStats& s = g_SnapshotStats;
+        GP4MD_LOG_INFO(IO, "Snapshot stats: hits=%d misses=%d invalidated=%d rebuilds=%d saves=%d\n",
+            s.hits, s.misses, s.invalidated, s.rebuilds, s.saves);
+    }
+}
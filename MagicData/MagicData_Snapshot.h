@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "../Core/Arena.h"
+
+namespace MagicData
+{
+    struct SnapshotStats
+    {
+        int hits = 0;
+        int misses = 0;      // no snapshot file next to GP4MD.ini
+        int invalidated = 0; // snapshot present but stale or corrupt
+        int rebuilds = 0;    // skipped because of SnapshotRebuild=1
+        int saves = 0;
+    };
+
+    extern SnapshotStats g_SnapshotStats;
+
+    // Hash of every startup input file without reading any: size + mtime of
+    // GP4MD.ini, each .dat and each Track INI, the open pack's checksum and
+    // the module build. Needs only the track count and the pack.
+    std::uint64_t ComputeInputsKey(const std::string& folder);
+
+    // inputsKey plus the original GP4 magicdata + lap table bytes. Requires a
+    // completed Scan (origBase / g_LapTableOrig).
+    std::uint64_t ComputeSnapshotKey(std::uint64_t inputsKey);
+
+    // True when GP4MD.snapshot was written from the same input files, so the
+    // .dat and Track INI reads can wait for LoadSnapshot to fail. Reads the
+    // header only and counts nothing.
+    bool SnapshotInputsMatch(const std::string& folder, std::uint64_t inputsKey);
+
+    // On a key match, plans and allocates arena (configured, empty) with the
+    // stored block sizes, restores it and fixes up g_Layout / g_LapTable.
+    bool LoadSnapshot(const std::string& folder,
+        std::uint64_t key,
+        Memory::Arena& arena);
+
+    // Stores the whole arena together with the block sizes and layout offsets.
+    bool SaveSnapshot(const std::string& folder,
+        std::uint64_t inputsKey,
+        std::uint64_t key,
+        const Memory::Arena& arena);
+
+    void LogSnapshotStats();
+}
@@ -0,0 +1,440 @@
+#include "MagicData_Table.h"
+#include "../Core/Simd.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace MagicData
+{
+    namespace
+    {
+        constexpr std::size_t kColumnAlign = 16;
+
+        std::size_t AlignUp(std::size_t v)
+        {
+            return (v + kColumnAlign - 1) & ~(kColumnAlign - 1);
+        }
+
+        std::uint32_t LoadValue(const std::uint8_t* p, std::size_t width)
+        {
+            switch (width)
+            {
+            case 1:
+                return *p;
+            case 2:
+            {
+                std::uint16_t v;
+                std::memcpy(&v, p, sizeof(v));
+                return v;
+            }
+            default:
+            {
+                std::uint32_t v;
+                std::memcpy(&v, p, sizeof(v));
+                return v;
+            }
+            }
+        }
+
+        void StoreValue(std::uint8_t* p, std::size_t width, std::uint32_t value)
+        {
+            switch (width)
+            {
+            case 1:
+                *p = static_cast<std::uint8_t>(value);
+                break;
+            case 2:
+            {
+                const std::uint16_t v = static_cast<std::uint16_t>(value);
+                std::memcpy(p, &v, sizeof(v));
+                break;
+            }
+            default:
+                std::memcpy(p, &value, sizeof(value));
+                break;
+            }
+        }
+
+        // Runs of consecutive descriptors of one width; in the table their
+        // columns are consecutive too, so a run is one small transpose.
+        struct Run
+        {
+            int         first;  // 0-based descriptor
+            int         count;
+            std::size_t width;
+        };
+
+        std::vector<Run> BuildRuns()
+        {
+            std::vector<Run> runs;
+            for (int d = 0; d < DESC_COUNT; ++d)
+            {
+                const std::size_t width = DescSize(g_Desc[d].type);
+                if (!runs.empty() && runs.back().width == width)
+                    ++runs.back().count;
+                else
+                    runs.push_back({ d, 1, width });
+            }
+            return runs;
+        }
+
+        const std::vector<Run>& Runs()
+        {
+            static const std::vector<Run> runs = BuildRuns();
+            return runs;
+        }
+
+        // Scalar transpose of tracks [t0, t1) x fields [j0, j1) of a run.
+        // rows: each track's first field of the run; cols: the run's first
+        // column, colStride bytes apart.
+        template <typename T>
+        void GatherScalar(std::uint8_t* cols, std::size_t colStride, const std::uint8_t* const* rows,
+            int t0, int t1, int j0, int j1)
+        {
+            for (int j = j0; j < j1; ++j)
+            {
+                std::uint8_t* col = cols + j * colStride;
+                for (int t = t0; t < t1; ++t)
+                {
+                    if (rows[t])
+                        std::memcpy(col + t * sizeof(T), rows[t] + j * sizeof(T), sizeof(T));
+                }
+            }
+        }
+
+        template <typename T>
+        void ScatterScalar(std::uint8_t* const* rows, const std::uint8_t* cols, std::size_t colStride,
+            int t0, int t1, int j0, int j1)
+        {
+            for (int j = j0; j < j1; ++j)
+            {
+                const std::uint8_t* col = cols + j * colStride;
+                for (int t = t0; t < t1; ++t)
+                {
+                    if (rows[t])
+                        std::memcpy(rows[t] + j * sizeof(T), col + t * sizeof(T), sizeof(T));
+                }
+            }
+        }
+
+#if GP4MD_HAS_SSE2
+        // SSE2 tile: L x L elements (8 x uint16_t, 4 x uint32_t) transposed
+        // in registers
+        template <typename T> struct Tile;
+
+        template <> struct Tile<std::uint16_t>
+        {
+            static constexpr int L = 8;
+
+            static void Transpose(__m128i* r)
+            {
+                const __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+                const __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+                const __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+                const __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+                const __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+                const __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+                const __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+                const __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+                const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+                const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+                const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+                const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+                const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+                const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+                const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+                const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+                r[0] = _mm_unpacklo_epi64(b0, b4);
+                r[1] = _mm_unpackhi_epi64(b0, b4);
+                r[2] = _mm_unpacklo_epi64(b1, b5);
+                r[3] = _mm_unpackhi_epi64(b1, b5);
+                r[4] = _mm_unpacklo_epi64(b2, b6);
+                r[5] = _mm_unpackhi_epi64(b2, b6);
+                r[6] = _mm_unpacklo_epi64(b3, b7);
+                r[7] = _mm_unpackhi_epi64(b3, b7);
+            }
+        };
+
+        template <> struct Tile<std::uint32_t>
+        {
+            static constexpr int L = 4;
+
+            static void Transpose(__m128i* r)
+            {
+                const __m128i a0 = _mm_unpacklo_epi32(r[0], r[1]);
+                const __m128i a1 = _mm_unpackhi_epi32(r[0], r[1]);
+                const __m128i a2 = _mm_unpacklo_epi32(r[2], r[3]);
+                const __m128i a3 = _mm_unpackhi_epi32(r[2], r[3]);
+
+                r[0] = _mm_unpacklo_epi64(a0, a2);
+                r[1] = _mm_unpackhi_epi64(a0, a2);
+                r[2] = _mm_unpacklo_epi64(a1, a3);
+                r[3] = _mm_unpackhi_epi64(a1, a3);
+            }
+        };
+
+        // Largest multiple of L tracks from t0 whose rows are all present
+        template <int L>
+        int FullTiles(const std::uint8_t* const* rows, int tracks)
+        {
+            int t = 0;
+            for (; t + L <= tracks; t += L)
+            {
+                for (int i = 0; i < L; ++i)
+                {
+                    if (!rows[t + i])
+                        return t;
+                }
+            }
+            return t;
+        }
+#endif
+
+        template <typename T>
+        void GatherRun(std::uint8_t* cols, std::size_t colStride, const std::uint8_t* const* rows,
+            int tracks, int count)
+        {
+            int tileT = 0;
+            int tileJ = 0;
+
+#if GP4MD_HAS_SSE2
+            constexpr int L = Tile<T>::L;
+            tileT = FullTiles<L>(rows, tracks);
+            tileJ = count / L * L;
+
+            for (int t = 0; t < tileT; t += L)
+            {
+                for (int j = 0; j < tileJ; j += L)
+                {
+                    __m128i r[L];
+                    for (int i = 0; i < L; ++i)
+                        r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[t + i] + j * sizeof(T)));
+
+                    Tile<T>::Transpose(r);
+
+                    for (int i = 0; i < L; ++i)
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(cols + (j + i) * colStride + t * sizeof(T)), r[i]);
+                }
+            }
+#endif
+
+            GatherScalar<T>(cols, colStride, rows, 0, tileT, tileJ, count);
+            GatherScalar<T>(cols, colStride, rows, tileT, tracks, 0, count);
+        }
+
+        template <typename T>
+        void ScatterRun(std::uint8_t* const* rows, const std::uint8_t* cols, std::size_t colStride,
+            int tracks, int count)
+        {
+            int tileT = 0;
+            int tileJ = 0;
+
+#if GP4MD_HAS_SSE2
+            constexpr int L = Tile<T>::L;
+            tileT = FullTiles<L>(rows, tracks);
+            tileJ = count / L * L;
+
+            for (int t = 0; t < tileT; t += L)
+            {
+                for (int j = 0; j < tileJ; j += L)
+                {
+                    __m128i r[L];
+                    for (int i = 0; i < L; ++i)
+                        r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cols + (j + i) * colStride + t * sizeof(T)));
+
+                    Tile<T>::Transpose(r);
+
+                    for (int i = 0; i < L; ++i)
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(rows[t + i] + j * sizeof(T)), r[i]);
+                }
+            }
+#endif
+
+            ScatterScalar<T>(rows, cols, colStride, 0, tileT, tileJ, count);
+            ScatterScalar<T>(rows, cols, colStride, tileT, tracks, 0, count);
+        }
+
+        std::uint16_t ScaleValue(std::uint16_t raw, double mul)
+        {
+            double scaled = static_cast<double>(raw) * mul;
+            if (scaled > 65535.0) scaled = 65535.0;
+            if (scaled < 0.0)     scaled = 0.0;
+
+            return static_cast<std::uint16_t>(scaled);
+        }
+    }
+
+    void MagicTable::Resize(int trackCount)
+    {
+        m_Tracks = trackCount < 0 ? 0 : trackCount;
+
+        std::size_t at = 0;
+        for (int d = 0; d < DESC_COUNT; ++d)
+        {
+            m_Column[d] = at;
+            at += AlignUp(m_Tracks * DescSize(g_Desc[d].type));
+        }
+
+        m_Data.assign(at, 0);
+    }
+
+    std::uint8_t* MagicTable::ColumnData(int descIndex)
+    {
+        return m_Data.data() + m_Column[descIndex - 1];
+    }
+
+    const std::uint8_t* MagicTable::ColumnData(int descIndex) const
+    {
+        return m_Data.data() + m_Column[descIndex - 1];
+    }
+
+    void MagicTable::Gather(const std::uint8_t* const* descBase)
+    {
+        std::vector<const std::uint8_t*> rows(m_Tracks);
+
+        for (const Run& r : Runs())
+        {
+            const std::size_t offset = g_Desc[r.first].offset;
+            for (int t = 0; t < m_Tracks; ++t)
+                rows[t] = descBase[t] ? descBase[t] + offset : nullptr;
+
+            std::uint8_t*     cols = m_Data.data() + m_Column[r.first];
+            const std::size_t stride = AlignUp(m_Tracks * r.width);
+
+            switch (r.width)
+            {
+            case 1:  GatherScalar<std::uint8_t>(cols, stride, rows.data(), 0, m_Tracks, 0, r.count); break;
+            case 2:  GatherRun<std::uint16_t>(cols, stride, rows.data(), m_Tracks, r.count);         break;
+            default: GatherRun<std::uint32_t>(cols, stride, rows.data(), m_Tracks, r.count);         break;
+            }
+        }
+    }
+
+    void MagicTable::Scatter(std::uint8_t* const* descBase) const
+    {
+        std::vector<std::uint8_t*> rows(m_Tracks);
+
+        for (const Run& r : Runs())
+        {
+            const std::size_t offset = g_Desc[r.first].offset;
+            for (int t = 0; t < m_Tracks; ++t)
+                rows[t] = descBase[t] ? descBase[t] + offset : nullptr;
+
+            const std::uint8_t* cols = m_Data.data() + m_Column[r.first];
+            const std::size_t   stride = AlignUp(m_Tracks * r.width);
+
+            switch (r.width)
+            {
+            case 1:  ScatterScalar<std::uint8_t>(rows.data(), cols, stride, 0, m_Tracks, 0, r.count); break;
+            case 2:  ScatterRun<std::uint16_t>(rows.data(), cols, stride, m_Tracks, r.count);         break;
+            default: ScatterRun<std::uint32_t>(rows.data(), cols, stride, m_Tracks, r.count);         break;
+            }
+        }
+    }
+
+    std::uint32_t MagicTable::Get(int trackIndex, int descIndex) const
+    {
+        const std::size_t width = DescSize(g_Desc[descIndex - 1].type);
+        return LoadValue(ColumnData(descIndex) + trackIndex * width, width);
+    }
+
+    void MagicTable::Set(int trackIndex, int descIndex, std::uint32_t value)
+    {
+        const std::size_t width = DescSize(g_Desc[descIndex - 1].type);
+        StoreValue(ColumnData(descIndex) + trackIndex * width, width, value);
+    }
+
+    void MagicTable::Fill(int descIndex, std::uint32_t value)
+    {
+        std::uint8_t* col = ColumnData(descIndex);
+
+        switch (DescSize(g_Desc[descIndex - 1].type))
+        {
+        case 1:
+            std::fill_n(col, m_Tracks, static_cast<std::uint8_t>(value));
+            break;
+        case 2:
+            std::fill_n(reinterpret_cast<std::uint16_t*>(col), m_Tracks, static_cast<std::uint16_t>(value));
+            break;
+        default:
+            std::fill_n(reinterpret_cast<std::uint32_t*>(col), m_Tracks, value);
+            break;
+        }
+    }
+
+    int MagicTable::Scale(int descIndex, double mul)
+    {
+        if (g_Desc[descIndex - 1].type != DescType::U16)
+            return 0;
+
+        std::uint16_t* col = reinterpret_cast<std::uint16_t*>(ColumnData(descIndex));
+        int changed = 0;
+        int t = 0;
+
+#if GP4MD_HAS_SSE2
+        // 8 tracks per step: widen to doubles, multiply, clamp, truncate and
+        // pack back (biased, as packs_epi32 saturates signed)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bias32 = _mm_set1_epi32(0x8000);
+        const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+        const __m128d m = _mm_set1_pd(mul);
+        const __m128d lo = _mm_setzero_pd();
+        const __m128d hi = _mm_set1_pd(65535.0);
+
+        auto scale4 = [&](__m128i v32)
+            {
+                __m128d a = _mm_mul_pd(_mm_cvtepi32_pd(v32), m);
+                __m128d b = _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(v32, 8)), m);
+                a = _mm_max_pd(_mm_min_pd(a, hi), lo);
+                b = _mm_max_pd(_mm_min_pd(b, hi), lo);
+                return _mm_sub_epi32(_mm_unpacklo_epi64(_mm_cvttpd_epi32(a), _mm_cvttpd_epi32(b)), bias32);
+            };
+
+        for (; t + 8 <= m_Tracks; t += 8)
+        {
+            __m128i* p = reinterpret_cast<__m128i*>(col + t);
+            const __m128i v = _mm_loadu_si128(p);
+
+            const __m128i r = _mm_xor_si128(bias16, _mm_packs_epi32(
+                scale4(_mm_unpacklo_epi16(v, zero)),
+                scale4(_mm_unpackhi_epi16(v, zero))));
+
+            _mm_storeu_si128(p, r);
+
+            // Two mask bits per lane
+            for (std::uint32_t diff = ~static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(v, r))) & 0xFFFF;
+                diff; diff &= diff - 1)
+                ++changed;
+        }
+
+        changed /= 2;
+#endif
+
+        for (; t < m_Tracks; ++t)
+        {
+            const std::uint16_t v = ScaleValue(col[t], mul);
+            if (v != col[t])
+            {
+                col[t] = v;
+                ++changed;
+            }
+        }
+
+        return changed;
+    }
+
+    void MagicTable::Range(int descIndex, std::uint32_t& lo, std::uint32_t& hi) const
+    {
+        lo = 0;
+        hi = 0;
+
+        for (int t = 0; t < m_Tracks; ++t)
+        {
+            const std::uint32_t v = Get(t, descIndex);
+            if (t == 0 || v < lo) lo = v;
+            if (t == 0 || v > hi) hi = v;
+        }
+    }
+}
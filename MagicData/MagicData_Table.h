@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "MagicData_Schema.h"
+
+namespace MagicData
+{
+    // Descriptor values of a whole season, column per descriptor: column d
+    // holds desc d of every track slot, contiguous and in its schema type
+    // (uint8_t / uint16_t / uint32_t), each column 16-byte aligned in one
+    // buffer. Gather reads the descriptor regions of all tracks in one pass
+    // and Scatter writes them back in one pass, so season-wide edits and
+    // statistics run over contiguous arrays instead of 296-byte strided
+    // unaligned fields.
+    //
+    // Scatter writes plain memory: target scratch blocks or a generation
+    // that is not yet published, never blocks the hooks hand to GP4.
+    //
+    // Unused infrastructure: nothing in PatchAllTracks, the RaceSettings
+    // layer or the hooks calls it. A season is at most 64 rows, and
+    // Bench_MagicTable shows the RaceSettings edits no faster on the
+    // columns than per track, and many times slower with the Gather /
+    // Scatter round trip included. Test_MagicTable keeps it correct.
+    class MagicTable
+    {
+    public:
+        // Sizes the columns for trackCount slots (all zero).
+        void Resize(int trackCount);
+
+        int TrackCount() const { return m_Tracks; }
+
+        // descBase[t]: track t's descriptor region (LAST_DESC_END bytes);
+        // null entries leave their row unchanged.
+        void Gather(const std::uint8_t* const* descBase);
+        void Scatter(std::uint8_t* const* descBase) const;
+
+        // Typed column of desc D, TrackCount() entries
+        template <int D>
+        typename Desc<D>::value_type* Column()
+        {
+            return reinterpret_cast<typename Desc<D>::value_type*>(ColumnData(D));
+        }
+
+        template <int D>
+        const typename Desc<D>::value_type* Column() const
+        {
+            return reinterpret_cast<const typename Desc<D>::value_type*>(ColumnData(D));
+        }
+
+        // Raw column of descIndex (1-based), DescSize bytes per track
+        std::uint8_t*       ColumnData(int descIndex);
+        const std::uint8_t* ColumnData(int descIndex) const;
+
+        // Stored value (SETUP_BYTE as stored, not -151) and its write,
+        // truncated to the column type.
+        std::uint32_t Get(int trackIndex, int descIndex) const;
+        void          Set(int trackIndex, int descIndex, std::uint32_t value);
+
+        // Every track of the column set to value (truncated to the type).
+        void Fill(int descIndex, std::uint32_t value);
+
+        // U16 column times mul, clamped to 0..65535 and truncated, as
+        // RaceSettings scales fuel and tyre wear. Returns the number of
+        // tracks whose value changed.
+        int Scale(int descIndex, double mul);
+
+        // Smallest and largest stored value of the column.
+        void Range(int descIndex, std::uint32_t& lo, std::uint32_t& hi) const;
+
+    private:
+        int                       m_Tracks = 0;
+        std::size_t               m_Column[DESC_COUNT] = {}; // byte offset of each column
+        std::vector<std::uint8_t> m_Data;
+    };
+}
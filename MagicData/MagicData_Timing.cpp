@@ -0,0 +1,283 @@
+#include "MagicData_Timing.h"
+#include "MagicData_DatCache.h"
+#include "../Core/FileIO.h"
+#include "../Core/Logging.h"
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace MagicData
+{
+    namespace
+    {
+        struct PhaseTiming
+        {
+            double      ms = 0.0;
+            std::size_t bytes = 0;
+        };
+
+        constexpr char k_ReportFile[] = "GP4MD.startup";
+
+        // Changes with every build of the DLL, so reports of two releases
+        // can be told apart
+        constexpr char k_BuildId[] = __DATE__ " " __TIME__;
+
+        const char* const k_PhaseNames[PHASE_COUNT] = {
+            "GlobalIni", "RaceSettings", "PackOpen", "ReadInputs", "Scan", "Snapshot",
+            "Prepare", "Arena", "Place", "Defaults", "SnapshotSave", "LapTable", "Profiles"
+        };
+
+        PhaseTiming g_Phases[PHASE_COUNT];
+        TrackTiming g_Tracks[MAX_TRACK_COUNT];
+
+        // One row of the per-track report: name and value as text
+        struct TrackField
+        {
+            const char* name;
+            std::string value;
+        };
+
+        std::string FormatMs(double ms)
+        {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%.3f", ms);
+            return buf;
+        }
+
+        std::vector<TrackField> TrackFields(const TrackTiming& t)
+        {
+            return {
+                { "datBytes", std::to_string(t.datBytes) },
+                { "datMs", FormatMs(t.datMs) },
+                { "iniBytes", std::to_string(t.iniBytes) },
+                { "iniMs", FormatMs(t.iniMs) },
+                { "prepareMs", FormatMs(t.prepareMs) },
+                { "trackIniMs", FormatMs(t.trackIniMs) },
+                { "raceMs", FormatMs(t.raceMs) },
+                { "defaultsMs", FormatMs(t.defaultsMs) },
+                { "patchFields", std::to_string(t.patchFields) },
+                { "patchBytes", std::to_string(t.patchBytes) },
+            };
+        }
+
+        void AppendLine(std::string& out, const char* fmt, ...)
+        {
+            char buf[256];
+
+            va_list args;
+            va_start(args, fmt);
+            const int n = std::vsnprintf(buf, sizeof(buf), fmt, args);
+            va_end(args);
+
+            if (n > 0)
+                out.append(buf, static_cast<std::size_t>(n) < sizeof(buf) ? n : sizeof(buf) - 1);
+        }
+
+        std::string BuildJson(double inputsMs, double commitMs, int threads, bool fromSnapshot)
+        {
+            std::string out;
+            out.reserve(1024 + g_TrackCount * 320);
+
+            out += "{\n";
+            AppendLine(out, "  \"version\": 1,\n");
+            AppendLine(out, "  \"build\": \"%s\",\n", k_BuildId);
+            AppendLine(out, "  \"trackCount\": %d,\n", g_TrackCount);
+            AppendLine(out, "  \"threads\": %d,\n", threads);
+            AppendLine(out, "  \"snapshot\": %s,\n", fromSnapshot ? "true" : "false");
+            AppendLine(out, "  \"inputsMs\": %.3f,\n", inputsMs);
+            AppendLine(out, "  \"commitMs\": %.3f,\n", commitMs);
+
+            out += "  \"phases\": [\n";
+            for (int p = 0; p < PHASE_COUNT; ++p)
+            {
+                AppendLine(out, "    { \"name\": \"%s\", \"ms\": %.3f, \"bytes\": %zu }%s\n",
+                    k_PhaseNames[p], g_Phases[p].ms, g_Phases[p].bytes, p + 1 < PHASE_COUNT ? "," : "");
+            }
+            out += "  ],\n";
+
+            out += "  \"tracks\": [\n";
+            for (int t = 0; t < g_TrackCount; ++t)
+            {
+                AppendLine(out, "    { \"track\": %d", t + 1);
+                for (const TrackField& f : TrackFields(g_Tracks[t]))
+                    AppendLine(out, ", \"%s\": %s", f.name, f.value.c_str());
+                out += t + 1 < g_TrackCount ? " },\n" : " }\n";
+            }
+            out += "  ]\n}\n";
+
+            return out;
+        }
+
+        // Long format, one value per row, as defaults.csv
+        std::string BuildCsv(double inputsMs, double commitMs, int threads, bool fromSnapshot)
+        {
+            std::string out = "scope,metric,value\n";
+
+            AppendLine(out, "startup,build,%s\n", k_BuildId);
+            AppendLine(out, "startup,trackCount,%d\n", g_TrackCount);
+            AppendLine(out, "startup,threads,%d\n", threads);
+            AppendLine(out, "startup,snapshot,%d\n", fromSnapshot ? 1 : 0);
+            AppendLine(out, "startup,inputsMs,%.3f\n", inputsMs);
+            AppendLine(out, "startup,commitMs,%.3f\n", commitMs);
+
+            for (int p = 0; p < PHASE_COUNT; ++p)
+            {
+                AppendLine(out, "%s,ms,%.3f\n", k_PhaseNames[p], g_Phases[p].ms);
+                AppendLine(out, "%s,bytes,%zu\n", k_PhaseNames[p], g_Phases[p].bytes);
+            }
+
+            for (int t = 0; t < g_TrackCount; ++t)
+            {
+                for (const TrackField& f : TrackFields(g_Tracks[t]))
+                    AppendLine(out, "Track%02d,%s,%s\n", t + 1, f.name, f.value.c_str());
+            }
+
+            return out;
+        }
+
+        void WriteReport(const std::string& path, const std::string& text)
+        {
+            std::FILE* f = OpenFile(path.c_str(), "wb");
+            bool ok = f != nullptr;
+            if (f)
+            {
+                ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+                ok = std::fclose(f) == 0 && ok;
+            }
+
+            if (!ok)
+            {
+                GP4MD_LOG_ERROR(IO, "Could not write %s\n", path.c_str());
+                return;
+            }
+
+            GP4MD_LOG_INFO(IO, "Startup report: %s (%zu bytes)\n", path.c_str(), text.size());
+        }
+    }
+
+    namespace Timing
+    {
+        unsigned ParseReportFormats(const std::string& text)
+        {
+            unsigned formats = 0;
+            std::size_t pos = 0;
+
+            while (pos <= text.size())
+            {
+                std::size_t comma = text.find(',', pos);
+                if (comma == std::string::npos)
+                    comma = text.size();
+
+                std::string name;
+                for (std::size_t i = pos; i < comma; ++i)
+                {
+                    const char c = text[i];
+                    if (c != ' ' && c != '\t')
+                        name += static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+                }
+
+                if (name == "json")
+                    formats |= REPORT_JSON;
+                else if (name == "csv")
+                    formats |= REPORT_CSV;
+
+                pos = comma + 1;
+            }
+
+            return formats;
+        }
+
+        void Begin()
+        {
+            for (PhaseTiming& p : g_Phases)
+                p = PhaseTiming{};
+
+            for (TrackTiming& t : g_Tracks)
+                t = TrackTiming{};
+        }
+
+        void AddPhase(Phase phase, double ms, std::size_t bytes)
+        {
+            PhaseTiming& p = g_Phases[static_cast<int>(phase)];
+            p.ms += ms;
+            p.bytes += bytes;
+        }
+
+        void AddBytes(Phase phase, std::size_t bytes)
+        {
+            g_Phases[static_cast<int>(phase)].bytes += bytes;
+        }
+
+        TrackTiming* Tracks()
+        {
+            return g_Tracks;
+        }
+
+        void CaptureDatStats()
+        {
+            for (int t = 0; t < g_TrackCount; ++t)
+            {
+                const DatLoadStats& s = DatCache::Stats(t);
+                if (!s.present)
+                    continue;
+
+                g_Tracks[t].datBytes = s.bytesRead;
+                g_Tracks[t].datMs = s.loadMs + s.scanMs;
+            }
+        }
+
+        void Report(const std::string& folder, unsigned formats, double inputsMs, double commitMs,
+            int threads, bool fromSnapshot)
+        {
+            const double wallMs = inputsMs + commitMs;
+
+            GP4MD_LOG_INFO(MagicData, "Startup profile: inputs %.3f ms + commit %.3f ms, %d thread(s)%s\n",
+                inputsMs, commitMs, threads, fromSnapshot ? ", from snapshot" : "");
+            GP4MD_LOG_INFO(MagicData, "  %-14s %10s %7s %10s\n", "phase", "ms", "%", "bytes");
+
+            for (int p = 0; p < PHASE_COUNT; ++p)
+            {
+                const PhaseTiming& ph = g_Phases[p];
+                if (ph.ms == 0.0 && ph.bytes == 0)
+                    continue;
+
+                GP4MD_LOG_INFO(MagicData, "  %-14s %10.3f %6.1f%% %10zu\n",
+                    k_PhaseNames[p], ph.ms, wallMs > 0.0 ? ph.ms * 100.0 / wallMs : 0.0, ph.bytes);
+            }
+
+            TrackTiming sum;
+            for (int t = 0; t < g_TrackCount; ++t)
+            {
+                const TrackTiming& tt = g_Tracks[t];
+
+                GP4MD_LOG_DEBUG(MagicData,
+                    "  Track %02d: .dat %zu bytes %.3f ms, ini %zu bytes %.3f ms, prepare %.3f ms "
+                    "(track ini %.3f, race settings %.3f), defaults %.3f ms, %zu field(s) %zu byte(s)\n",
+                    t + 1, tt.datBytes, tt.datMs, tt.iniBytes, tt.iniMs, tt.prepareMs,
+                    tt.trackIniMs, tt.raceMs, tt.defaultsMs, tt.patchFields, tt.patchBytes);
+
+                sum.datBytes += tt.datBytes;
+                sum.datMs += tt.datMs;
+                sum.iniBytes += tt.iniBytes;
+                sum.iniMs += tt.iniMs;
+                sum.prepareMs += tt.prepareMs;
+                sum.patchFields += tt.patchFields;
+                sum.patchBytes += tt.patchBytes;
+            }
+
+            // Per-track times add up worker time, not wall time
+            GP4MD_LOG_INFO(MagicData,
+                "  tracks: .dat %zu bytes %.3f ms, ini %zu bytes %.3f ms, prepare %.3f ms, "
+                "%zu field(s) %zu byte(s) patched\n",
+                sum.datBytes, sum.datMs, sum.iniBytes, sum.iniMs, sum.prepareMs,
+                sum.patchFields, sum.patchBytes);
+
+            if (formats & REPORT_JSON)
+                WriteReport(folder + k_ReportFile + ".json", BuildJson(inputsMs, commitMs, threads, fromSnapshot));
+
+            if (formats & REPORT_CSV)
+                WriteReport(folder + k_ReportFile + ".csv", BuildCsv(inputsMs, commitMs, threads, fromSnapshot));
+        }
+    }
+}
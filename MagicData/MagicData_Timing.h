@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "MagicData.h"
+#include "../Core/Platform.h"
+
+namespace MagicData
+{
+    // Startup phases in the order they run: PrepareInputs up to ReadInputs,
+    // PatchAllTracks from Scan on.
+    enum class Phase : int
+    {
+        GlobalIni,    // GP4MD.ini, logging, TrackCount
+        RaceSettings, // [RaceSettings] parse, [Rules] compile
+        PackOpen,
+        ReadInputs,   // every .dat mapped and scanned, every Track INI read
+        Scan,         // GP4's original blocks
+        Snapshot,     // inputs key, header check and restore
+        Prepare,      // every track staged in scratch memory
+        Arena,        // plan and allocation
+        Place,        // blocks copied into the arena
+        Defaults,     // defaults.* export
+        SnapshotSave,
+        LapTable,     // GP4 lap table write
+        Profiles,     // race profiles built
+        Count
+    };
+
+    constexpr int PHASE_COUNT = static_cast<int>(Phase::Count);
+
+    // One track of the startup; written only by the worker handling it.
+    struct TrackTiming
+    {
+        std::size_t datBytes = 0;     // .dat mapped (0: none or from the pack)
+        double      datMs = 0.0;      // .dat open, map and marker scan
+        std::size_t iniBytes = 0;     // Track INI read
+        double      iniMs = 0.0;      // Track INI read and section scan
+        double      prepareMs = 0.0;  // whole PrepareTrack
+        double      trackIniMs = 0.0; // Track INI layer (PatchTrack)
+        double      raceMs = 0.0;     // RaceSettings layer (rules or ApplyRaceSettings)
+        double      defaultsMs = 0.0; // defaults.* formatting, all formats
+        std::size_t patchFields = 0;  // fields staged over all layers
+        std::size_t patchBytes = 0;   // bytes the commit wrote to the block
+    };
+
+    // Phase and per-track timers of one startup (PrepareInputs through
+    // PatchAllTracks), reported as a log table and optionally as
+    // GP4MD.startup.json / .csv next to GP4MD.ini ([General] StartupReport).
+    // Reloads and profile builds are not timed. Phases are timed from the
+    // startup thread only.
+    namespace Timing
+    {
+        constexpr unsigned REPORT_JSON = 1u << 0;
+        constexpr unsigned REPORT_CSV = 1u << 1;
+
+        // Comma-separated json / csv; unknown names are ignored, empty is none.
+        unsigned ParseReportFormats(const std::string& text);
+
+        // Clears every phase and track counter.
+        void Begin();
+
+        void AddPhase(Phase phase, double ms, std::size_t bytes = 0);
+        void AddBytes(Phase phase, std::size_t bytes);
+
+        // MAX_TRACK_COUNT entries
+        TrackTiming* Tracks();
+
+        // .dat figures from DatCache; call before DatCache::Release.
+        void CaptureDatStats();
+
+        // Logs the phase table (info) and every track (debug) and writes the
+        // requested report files. inputsMs / commitMs: wall time of
+        // PrepareInputs and PatchAllTracks.
+        void Report(const std::string& folder, unsigned formats, double inputsMs, double commitMs,
+            int threads, bool fromSnapshot);
+
+        // Adds the scope's wall time to a phase
+        class Scope
+        {
+        public:
+            explicit Scope(Phase phase) : m_Phase(phase), m_Start(Platform::NowMs()) {}
+            ~Scope() { AddPhase(m_Phase, Platform::NowMs() - m_Start); }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            Phase  m_Phase;
+            double m_Start;
+        };
+    }
+}
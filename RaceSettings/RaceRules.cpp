@@ -0,0 +1,863 @@
+#include <cctype>
+#include <cmath>
+#include <initializer_list>
+
+#include "RaceRules.h"
+#include "../MagicData/MagicData.h"
+#include "../Core/Encoding.h"
+#include "../Core/Logging.h"
+
+using namespace MagicData;
+
+namespace RaceRules
+{
+    namespace
+    {
+        constexpr int kMaxStack = 32;
+        constexpr int kMaxNesting = 64;
+
+        enum Var : std::uint16_t
+        {
+            VAR_SPRINT_RACE,
+            VAR_SPRINT_PIT_STOP,
+            VAR_SPRINT_PIT_STOP_LAP,
+            VAR_SPRINT_PIT_STOP_WINDOW,
+            VAR_FUEL_MULTIPLIER,
+            VAR_TYRE_WEAR_MULTIPLIER,
+            VAR_CC_YIELD,
+            VAR_CC_START_CAUTION,
+            VAR_SPRINT_LAPS,
+            VAR_TRACK,
+            VAR_COUNT
+        };
+
+        const char* const k_VarNames[VAR_COUNT] = {
+            "SprintRace", "SprintPitStop", "SprintPitStopLap", "SprintPitStopWindow",
+            "FuelMultiplier", "TyreWearMultiplier", "CCYield", "CCStartCaution",
+            "SprintLaps", "track"
+        };
+
+        bool SameWord(const char* p, std::size_t n, const char* word)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (!word[i] || std::tolower(static_cast<unsigned char>(p[i])) !=
+                    std::tolower(static_cast<unsigned char>(word[i])))
+                    return false;
+            }
+            return word[n] == '\0';
+        }
+
+        // Recursive descent over one expression, emitting postfix code
+        class Parser
+        {
+        public:
+            Parser(const std::string& text, std::vector<Instr>& code, std::vector<double>& consts)
+                : m_Start(text.c_str()), m_P(text.c_str()), m_Code(code), m_Consts(consts)
+            {
+            }
+
+            bool Parse(std::string& error)
+            {
+                Ternary();
+                Skip();
+                if (m_Error.empty() && *m_P)
+                    Fail("unexpected text");
+
+                if (!m_Error.empty())
+                {
+                    error = m_Error + " at column " + std::to_string(m_ErrorAt - m_Start + 1);
+                    return false;
+                }
+                return true;
+            }
+
+        private:
+            void Fail(const std::string& what)
+            {
+                if (m_Error.empty())
+                {
+                    m_Error = what;
+                    m_ErrorAt = m_P;
+                }
+            }
+
+            // Stack effect of each emitted instruction is tracked so a rule
+            // can never overrun the evaluation stack
+            void Emit(Op op, std::uint16_t arg, int delta)
+            {
+                m_Code.push_back({ op, arg });
+                m_Depth += delta;
+                if (m_Depth > kMaxStack)
+                    Fail("expression too deep");
+            }
+
+            void Skip()
+            {
+                while (*m_P == ' ' || *m_P == '\t')
+                    ++m_P;
+            }
+
+            bool Accept(const char* tok)
+            {
+                Skip();
+                std::size_t n = 0;
+                while (tok[n] && m_P[n] == tok[n])
+                    ++n;
+
+                if (tok[n])
+                    return false;
+
+                m_P += n;
+                return true;
+            }
+
+            void Expect(const char* tok)
+            {
+                if (!Accept(tok))
+                    Fail(std::string("expected ") + tok);
+            }
+
+            // Ternary and Unary are the only self-recursive rules; both count
+            // against kMaxNesting, which bounds the recursion
+            void Ternary()
+            {
+                if (!m_Error.empty())
+                    return;
+
+                if (++m_Nesting > kMaxNesting)
+                    Fail("expression too deep");
+                else
+                {
+                    Or();
+                    if (m_Error.empty() && Accept("?"))
+                    {
+                        Ternary();
+                        Expect(":");
+                        Ternary();
+                        Emit(Op::Select, 0, -2);
+                    }
+                }
+
+                --m_Nesting;
+            }
+
+            void Or()
+            {
+                And();
+                while (m_Error.empty() && Accept("||"))
+                {
+                    And();
+                    Emit(Op::Or, 0, -1);
+                }
+            }
+
+            void And()
+            {
+                Equality();
+                while (m_Error.empty() && Accept("&&"))
+                {
+                    Equality();
+                    Emit(Op::And, 0, -1);
+                }
+            }
+
+            void Equality()
+            {
+                Relational();
+                while (m_Error.empty())
+                {
+                    Op op;
+                    if (Accept("=="))      op = Op::Eq;
+                    else if (Accept("!=")) op = Op::Ne;
+                    else break;
+
+                    Relational();
+                    Emit(op, 0, -1);
+                }
+            }
+
+            void Relational()
+            {
+                Additive();
+                while (m_Error.empty())
+                {
+                    Op op;
+                    if (Accept("<="))      op = Op::Le;
+                    else if (Accept(">=")) op = Op::Ge;
+                    else if (Accept("<"))  op = Op::Lt;
+                    else if (Accept(">"))  op = Op::Gt;
+                    else break;
+
+                    Additive();
+                    Emit(op, 0, -1);
+                }
+            }
+
+            void Additive()
+            {
+                Multiplicative();
+                while (m_Error.empty())
+                {
+                    Op op;
+                    if (Accept("+"))      op = Op::Add;
+                    else if (Accept("-")) op = Op::Sub;
+                    else break;
+
+                    Multiplicative();
+                    Emit(op, 0, -1);
+                }
+            }
+
+            void Multiplicative()
+            {
+                Unary();
+                while (m_Error.empty())
+                {
+                    Op op;
+                    if (Accept("*"))      op = Op::Mul;
+                    else if (Accept("/")) op = Op::Div;
+                    else if (Accept("%")) op = Op::Mod;
+                    else break;
+
+                    Unary();
+                    Emit(op, 0, -1);
+                }
+            }
+
+            void Unary()
+            {
+                if (!m_Error.empty())
+                    return;
+
+                if (++m_Nesting > kMaxNesting)
+                    Fail("expression too deep");
+                else if (Accept("-"))
+                {
+                    Unary();
+                    Emit(Op::Neg, 0, 0);
+                }
+                else if (Accept("!"))
+                {
+                    Unary();
+                    Emit(Op::Not, 0, 0);
+                }
+                else
+                    Primary();
+
+                --m_Nesting;
+            }
+
+            // digits [. digits], converted like the [RaceSettings] values so
+            // "self * 1.15" and FuelMultiplier=1.15 are the same double
+            void Number()
+            {
+                const char* start = m_P;
+                while (std::isdigit(static_cast<unsigned char>(*m_P)))
+                    ++m_P;
+
+                if (*m_P == '.')
+                {
+                    ++m_P;
+                    while (std::isdigit(static_cast<unsigned char>(*m_P)))
+                        ++m_P;
+                }
+
+                double v = 0.0;
+                if (!IniText::ParseDouble(std::string(start, m_P), v))
+                {
+                    m_P = start;
+                    Fail("bad number");
+                    return;
+                }
+
+                m_Consts.push_back(v);
+                Emit(Op::Const, static_cast<std::uint16_t>(m_Consts.size() - 1), 1);
+            }
+
+            int FindVar(const char* name, std::size_t n)
+            {
+                for (int v = 0; v < VAR_COUNT; ++v)
+                {
+                    if (SameWord(name, n, k_VarNames[v]))
+                        return v;
+                }
+                return -1;
+            }
+
+            // Function arguments: count expressions separated by commas
+            void Arguments(int count)
+            {
+                Expect("(");
+                for (int i = 0; i < count && m_Error.empty(); ++i)
+                {
+                    if (i)
+                        Expect(",");
+                    Ternary();
+                }
+                Expect(")");
+            }
+
+            void Primary()
+            {
+                Skip();
+
+                if (std::isdigit(static_cast<unsigned char>(*m_P)) || *m_P == '.')
+                {
+                    Number();
+                    return;
+                }
+
+                if (Accept("("))
+                {
+                    Ternary();
+                    Expect(")");
+                    return;
+                }
+
+                const char* name = m_P;
+                while (std::isalnum(static_cast<unsigned char>(*m_P)) || *m_P == '_')
+                    ++m_P;
+
+                const std::size_t n = static_cast<std::size_t>(m_P - name);
+                if (!n)
+                {
+                    Fail("expected a value");
+                    return;
+                }
+
+                const std::string word(name, n);
+
+                if (const int d = FindDescKey(word.c_str()))
+                    Emit(Op::Desc, static_cast<std::uint16_t>(d), 1);
+                else if (SameWord(name, n, "self"))
+                    Emit(Op::Self, 0, 1);
+                else if (SameWord(name, n, "laps"))
+                    Emit(Op::Laps, 0, 1);
+                else if (SameWord(name, n, "min"))
+                {
+                    Arguments(2);
+                    Emit(Op::Min, 0, -1);
+                }
+                else if (SameWord(name, n, "max"))
+                {
+                    Arguments(2);
+                    Emit(Op::Max, 0, -1);
+                }
+                else if (SameWord(name, n, "clamp"))
+                {
+                    Arguments(3);
+                    Emit(Op::Clamp, 0, -2);
+                }
+                else if (SameWord(name, n, "floor"))
+                {
+                    Arguments(1);
+                    Emit(Op::Floor, 0, 0);
+                }
+                else if (SameWord(name, n, "abs"))
+                {
+                    Arguments(1);
+                    Emit(Op::Abs, 0, 0);
+                }
+                else if (SameWord(name, n, "has"))
+                {
+                    Expect("(");
+                    Skip();
+
+                    const char* arg = m_P;
+                    while (std::isalnum(static_cast<unsigned char>(*m_P)) || *m_P == '_')
+                        ++m_P;
+
+                    const int v = FindVar(arg, static_cast<std::size_t>(m_P - arg));
+                    if (v < 0)
+                    {
+                        m_P = arg;
+                        Fail("has() needs a RaceSettings key");
+                        return;
+                    }
+
+                    Emit(Op::Has, static_cast<std::uint16_t>(v), 1);
+                    Expect(")");
+                }
+                else
+                {
+                    const int v = FindVar(name, n);
+                    if (v < 0)
+                    {
+                        m_P = name;
+                        Fail("unknown name");
+                        return;
+                    }
+
+                    Emit(Op::Var, static_cast<std::uint16_t>(v), 1);
+                }
+            }
+
+            const char*          m_Start;
+            const char*          m_P;
+            const char*          m_ErrorAt = nullptr;
+            std::vector<Instr>&  m_Code;
+            std::vector<double>& m_Consts;
+            std::string          m_Error;
+            int                  m_Depth = 0;
+            int                  m_Nesting = 0;
+        };
+
+        // [RaceSettings] keys are fixed for a whole Build and folded into
+        // constants; only these are read while running
+        bool IsTrackVar(std::uint16_t v)
+        {
+            return v == VAR_SPRINT_LAPS || v == VAR_TRACK;
+        }
+
+        double ConfigValue(const RaceConfig& r, std::uint16_t v)
+        {
+            switch (v)
+            {
+            case VAR_SPRINT_RACE:            return r.sprint ? 1.0 : 0.0;
+            case VAR_SPRINT_PIT_STOP:        return r.sprintPitStop ? 1.0 : 0.0;
+            case VAR_SPRINT_PIT_STOP_LAP:    return r.sprintPitStopLap;
+            case VAR_SPRINT_PIT_STOP_WINDOW: return r.sprintPitStopWindow;
+            case VAR_FUEL_MULTIPLIER:        return r.fuel;
+            case VAR_TYRE_WEAR_MULTIPLIER:   return r.tyre;
+            case VAR_CC_YIELD:               return r.yield;
+            case VAR_CC_START_CAUTION:       return r.caution;
+            }
+            return 0.0;
+        }
+
+        bool ConfigHas(const RaceConfig& r, std::uint16_t v)
+        {
+            switch (v)
+            {
+            case VAR_FUEL_MULTIPLIER:      return r.hasFuel;
+            case VAR_TYRE_WEAR_MULTIPLIER: return r.hasTyre;
+            case VAR_CC_YIELD:             return r.hasYield;
+            case VAR_CC_START_CAUTION:     return r.hasCaution;
+            }
+            return ConfigValue(r, v) != 0.0;
+        }
+
+        double TrackValue(const RuleInputs& in, std::uint16_t v)
+        {
+            return v == VAR_SPRINT_LAPS ? in.sprintLaps : in.trackIndex + 1;
+        }
+
+        // Target value in rule units (setup bytes as in the Track INIs)
+        double ReadTarget(int target, const Patch::Transaction& txn, const std::uint8_t* lapAddr)
+        {
+            if (target == 0)
+                return *lapAddr;
+
+            const DescInfo&     D = g_Desc[target - 1];
+            const std::uint32_t raw = txn.Read(static_cast<std::uint32_t>(D.offset),
+                static_cast<std::uint8_t>(DescSize(D.type)));
+
+            return D.type == DescType::SETUP_BYTE ? static_cast<double>(raw) - 151.0 : raw;
+        }
+
+        double Truthy(double v)
+        {
+            return v != 0.0 ? 1.0 : 0.0;
+        }
+
+        double ApplyUnary(Op op, double a)
+        {
+            switch (op)
+            {
+            case Op::Neg:   return -a;
+            case Op::Not:   return a == 0.0 ? 1.0 : 0.0;
+            case Op::Floor: return std::floor(a);
+            case Op::Abs:   return std::fabs(a);
+            default:        return a;
+            }
+        }
+
+        double ApplyBinary(Op op, double a, double b)
+        {
+            switch (op)
+            {
+            case Op::Add: return a + b;
+            case Op::Sub: return a - b;
+            case Op::Mul: return a * b;
+            case Op::Div: return b != 0.0 ? a / b : 0.0;
+            case Op::Mod: return b != 0.0 ? std::fmod(a, b) : 0.0;
+            case Op::Lt:  return a < b ? 1.0 : 0.0;
+            case Op::Le:  return a <= b ? 1.0 : 0.0;
+            case Op::Gt:  return a > b ? 1.0 : 0.0;
+            case Op::Ge:  return a >= b ? 1.0 : 0.0;
+            case Op::Eq:  return a == b ? 1.0 : 0.0;
+            case Op::Ne:  return a != b ? 1.0 : 0.0;
+            case Op::And: return Truthy(a) * Truthy(b);
+            case Op::Or:  return Truthy(a) + Truthy(b) != 0.0 ? 1.0 : 0.0;
+            case Op::Min: return b < a ? b : a;
+            case Op::Max: return b > a ? b : a;
+            default:      return a;
+            }
+        }
+
+        double ApplyClamp(double v, double lo, double hi)
+        {
+            if (v > hi) v = hi;
+            if (v < lo) v = lo;
+            return v;
+        }
+
+        // Rule result to the target's stored value: truncated toward zero and
+        // wrapped to the width (setup bytes encoded); false if not finite
+        bool EncodeResult(int target, double v, std::uint32_t& out)
+        {
+            if (!(v > -9.0e18 && v < 9.0e18))
+                return false;
+
+            const std::int64_t i = static_cast<std::int64_t>(v);
+
+            if (target != 0 && g_Desc[target - 1].type == DescType::SETUP_BYTE)
+                out = EncodeSetupByte(static_cast<int>(i % 256));
+            else
+                out = static_cast<std::uint32_t>(static_cast<std::uint64_t>(i));
+
+            return true;
+        }
+
+        // Constant folding of parsed postfix code against the config: every
+        // operand that does not depend on the track becomes a constant, a
+        // constant condition keeps only its branch.
+        class Folder
+        {
+        public:
+            explicit Folder(std::vector<double>& consts) : m_Consts(consts) {}
+
+            void Fold(const std::vector<Instr>& src, const std::vector<double>& srcConsts,
+                const RaceConfig& race, std::vector<Instr>& out)
+            {
+                m_Stack.clear();
+
+                for (const Instr& in : src)
+                {
+                    switch (in.op)
+                    {
+                    case Op::Const:
+                        PushConst(srcConsts[in.arg]);
+                        break;
+
+                    case Op::Var:
+                    case Op::Has:
+                        if (IsTrackVar(in.arg))
+                            PushCode(in);
+                        else if (in.op == Op::Var)
+                            PushConst(ConfigValue(race, in.arg));
+                        else
+                            PushConst(ConfigHas(race, in.arg) ? 1.0 : 0.0);
+                        break;
+
+                    case Op::Desc:
+                    case Op::Self:
+                    case Op::Laps:
+                        PushCode(in);
+                        break;
+
+                    case Op::Neg:
+                    case Op::Not:
+                    case Op::Floor:
+                    case Op::Abs:
+                    {
+                        Node& a = m_Stack.back();
+                        if (a.constant)
+                            a.value = ApplyUnary(in.op, a.value);
+                        else
+                            a.code.push_back(in);
+                        break;
+                    }
+
+                    case Op::Clamp:
+                    case Op::Select:
+                    {
+                        Node c = Pop();
+                        Node b = Pop();
+                        Node a = Pop();
+
+                        if (in.op == Op::Select && a.constant)
+                            m_Stack.push_back(a.value != 0.0 ? b : c);
+                        else if (a.constant && b.constant && c.constant)
+                            PushConst(ApplyClamp(a.value, b.value, c.value));
+                        else
+                            Combine(a, { &b, &c }, in);
+                        break;
+                    }
+
+                    default:
+                    {
+                        Node b = Pop();
+                        Node a = Pop();
+
+                        if (a.constant && b.constant)
+                            PushConst(ApplyBinary(in.op, a.value, b.value));
+                        else
+                            Combine(a, { &b }, in);
+                        break;
+                    }
+                    }
+                }
+
+                Node& result = m_Stack.back();
+                Materialize(result);
+                out = result.code;
+            }
+
+        private:
+            struct Node
+            {
+                bool               constant = false;
+                double             value = 0.0;
+                std::vector<Instr> code;
+            };
+
+            Node Pop()
+            {
+                Node n = m_Stack.back();
+                m_Stack.pop_back();
+                return n;
+            }
+
+            void PushConst(double v)
+            {
+                Node n;
+                n.constant = true;
+                n.value = v;
+                m_Stack.push_back(n);
+            }
+
+            void PushCode(const Instr& in)
+            {
+                Node n;
+                n.code.push_back(in);
+                m_Stack.push_back(n);
+            }
+
+            void Materialize(Node& n)
+            {
+                if (!n.constant)
+                    return;
+
+                m_Consts.push_back(n.value);
+                n.code.assign(1, Instr{ Op::Const, static_cast<std::uint16_t>(m_Consts.size() - 1) });
+                n.constant = false;
+            }
+
+            void Combine(Node& first, std::initializer_list<Node*> rest, const Instr& op)
+            {
+                Materialize(first);
+                for (Node* n : rest)
+                {
+                    Materialize(*n);
+                    first.code.insert(first.code.end(), n->code.begin(), n->code.end());
+                }
+
+                first.code.push_back(op);
+                m_Stack.push_back(first);
+            }
+
+            std::vector<double>& m_Consts;
+            std::vector<Node>    m_Stack;
+        };
+
+        double Evaluate(const Instr* code, const Instr* end, const double* consts,
+            const RuleInputs& in, int target, const Patch::Transaction& txn, const std::uint8_t* lapAddr)
+        {
+            double stack[kMaxStack];
+            int    sp = 0;
+
+            for (; code != end; ++code)
+            {
+                const std::uint16_t arg = code->arg;
+
+                switch (code->op)
+                {
+                case Op::Const: stack[sp++] = consts[arg]; break;
+                case Op::Desc:  stack[sp++] = ReadTarget(arg, txn, lapAddr); break;
+                case Op::Self:  stack[sp++] = ReadTarget(target, txn, lapAddr); break;
+                case Op::Laps:  stack[sp++] = *lapAddr; break;
+                case Op::Var:   stack[sp++] = TrackValue(in, arg); break;
+                case Op::Has:   stack[sp++] = TrackValue(in, arg) > 0.0 ? 1.0 : 0.0; break;
+
+                case Op::Neg:   stack[sp - 1] = -stack[sp - 1]; break;
+                case Op::Not:   stack[sp - 1] = stack[sp - 1] == 0.0 ? 1.0 : 0.0; break;
+                case Op::Floor: stack[sp - 1] = std::floor(stack[sp - 1]); break;
+                case Op::Abs:   stack[sp - 1] = std::fabs(stack[sp - 1]); break;
+
+                case Op::Clamp:
+                    sp -= 2;
+                    stack[sp - 1] = ApplyClamp(stack[sp - 1], stack[sp], stack[sp + 1]);
+                    break;
+
+                case Op::Select:
+                    sp -= 2;
+                    stack[sp - 1] = stack[sp - 1] != 0.0 ? stack[sp] : stack[sp + 1];
+                    break;
+
+                default:
+                    --sp;
+                    stack[sp - 1] = ApplyBinary(code->op, stack[sp - 1], stack[sp]);
+                    break;
+                }
+            }
+
+            return stack[0];
+        }
+    }
+
+    bool Program::Add(const std::string& targets, const std::string& expression, std::string& error)
+    {
+        std::vector<int> list;
+        std::size_t      pos = 0;
+
+        while (pos <= targets.size())
+        {
+            std::size_t comma = targets.find(',', pos);
+            if (comma == std::string::npos)
+                comma = targets.size();
+
+            std::string name = targets.substr(pos, comma - pos);
+            name.erase(0, name.find_first_not_of(" \t"));
+            name.erase(name.find_last_not_of(" \t") + 1);
+
+            const int d = FindDescKey(name.c_str());
+            if (d > 0)
+                list.push_back(d);
+            else if (IniText::EqualsNoCase(name.c_str(), "laps"))
+                list.push_back(0);
+            else
+            {
+                error = "unknown target \"" + name + "\"";
+                return false;
+            }
+
+            pos = comma + 1;
+        }
+
+        std::vector<Instr>  parsed;
+        std::vector<double> parsedConsts;
+
+        Parser parser(expression, parsed, parsedConsts);
+        if (!parser.Parse(error))
+            return false;
+
+        std::vector<Instr> code;
+        Folder(m_Consts).Fold(parsed, parsedConsts, m_Race, code);
+
+        // A rule that folded to its own target ("SprintRace ? 0 : self"
+        // without SprintRace) changes nothing and is dropped
+        const std::size_t begin = m_Code.size();
+        bool              used = false;
+
+        for (int target : list)
+        {
+            const Instr& only = code[0];
+            const bool noop = code.size() == 1 &&
+                (only.op == Op::Self ||
+                 (only.op == Op::Laps && target == 0) ||
+                 (only.op == Op::Desc && only.arg == target));
+
+            if (noop)
+                continue;
+
+            Rule rule{};
+            rule.target = target;
+            rule.constant = only.op == Op::Const && code.size() == 1;
+
+            if (target != 0)
+            {
+                rule.offset = static_cast<std::uint32_t>(g_Desc[target - 1].offset);
+                rule.width = static_cast<std::uint8_t>(DescSize(g_Desc[target - 1].type));
+            }
+
+            if (rule.constant)
+            {
+                if (!EncodeResult(target, m_Consts[only.arg], rule.value))
+                    continue;
+            }
+            else
+            {
+                if (!used)
+                    m_Code.insert(m_Code.end(), code.begin(), code.end());
+
+                rule.begin = static_cast<std::uint32_t>(begin);
+                rule.end = static_cast<std::uint32_t>(m_Code.size());
+                used = true;
+            }
+
+            m_Rules.push_back(rule);
+        }
+
+        return true;
+    }
+
+    std::size_t Program::Run(const RuleInputs& in, Patch::Transaction& txn, std::uint8_t* lapAddr) const
+    {
+        std::size_t changed = 0;
+
+        for (const Rule& r : m_Rules)
+        {
+            std::uint32_t value = r.value;
+
+            if (!r.constant)
+            {
+                const double v = Evaluate(m_Code.data() + r.begin, m_Code.data() + r.end,
+                    m_Consts.data(), in, r.target, txn, lapAddr);
+
+                if (!EncodeResult(r.target, v, value))
+                    continue;
+            }
+
+            if (r.target == 0)
+            {
+                const std::uint8_t laps = static_cast<std::uint8_t>(value);
+                if (laps == *lapAddr)
+                    continue;
+
+                GP4MD_LOG_DEBUG(RaceSettings, "Track %02d laps %u -> %u\n",
+                    in.trackIndex + 1, *lapAddr, laps);
+
+                *lapAddr = laps;
+                ++changed;
+                continue;
+            }
+
+            // Stage truncates to the width
+            std::uint32_t oldValue = 0;
+            if (txn.Stage(r.offset, r.width, value, &oldValue))
+            {
+                GP4MD_LOG_DEBUG(RaceSettings, "Track %02d %s %u -> %u\n",
+                    in.trackIndex + 1, DescKey(r.target), oldValue,
+                    r.width < 4 ? value & ((1u << (r.width * 8)) - 1) : value);
+                ++changed;
+            }
+        }
+
+        return changed;
+    }
+
+    Program Build(const RaceConfig& race, const IniText::Section& rulesSec)
+    {
+        Program     program(race);
+        std::string error;
+
+        for (const IniText::Entry& e : rulesSec.entries)
+        {
+            if (e.value.empty())
+                continue;
+
+            error.clear();
+            if (!program.Add(e.key, e.value, error))
+                GP4MD_LOG_INFO(RaceSettings, "Rules: ignored %s (%s)\n", e.key.c_str(), error.c_str());
+        }
+
+        if (rulesSec.present)
+        {
+            GP4MD_LOG_INFO(RaceSettings, "Rules: %zu rule(s) active, %zu instruction(s)\n",
+                program.RuleCount(), program.CodeSize());
+        }
+        return program;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "RaceSettings.h"
+#include "../Core/IniText.h"
+#include "../Core/Patch.h"
+
+// Descriptor rules: "target = expression" lines compiled once into a small
+// stack bytecode and run for every track in the RaceSettings layer, after
+// [RaceSettings] (which only applies to tracks with a Track INI).
+//
+//   target      descN or laps; several targets share one expression when
+//               separated by commas ("desc48, desc70 = self * 2")
+//   operands    numbers, descN (current value; setup bytes as in the
+//               Track INIs), laps, self (the target),
+//               track (1-based), SprintLaps (Track INI) and the
+//               [RaceSettings] keys SprintRace, SprintPitStop,
+//               SprintPitStopLap, SprintPitStopWindow, FuelMultiplier,
+//               TyreWearMultiplier, CCYield, CCStartCaution
+//   operators   ?: || && == != < <= > >= + - * / % ! and unary -
+//   functions   min(a, b) max(a, b) clamp(x, lo, hi) floor(x) abs(x)
+//               has(key): CCYield / CCStartCaution set, a multiplier set
+//               and not 1, SprintLaps > 0; other keys: not 0
+//
+// Arithmetic is in double; x / 0 and x % 0 are 0. The result is truncated
+// toward zero and stored modulo the target's width, as a C++ cast would;
+// a result that is not finite leaves the target unchanged.
+// Rules run in order and each sees the writes of the ones before it.
+namespace RaceRules
+{
+    enum class Op : std::uint8_t
+    {
+        Const, Desc, Self, Laps, Var, Has,
+        Neg, Not,
+        Add, Sub, Mul, Div, Mod,
+        Lt, Le, Gt, Ge, Eq, Ne, And, Or,
+        Min, Max, Floor, Abs, Clamp, Select
+    };
+
+    struct Instr
+    {
+        Op            op;
+        std::uint16_t arg; // constant, descriptor or variable index
+    };
+
+    struct Rule
+    {
+        int           target;   // 1..DESC_COUNT, 0 = laps
+        std::uint32_t offset;   // target field in the block
+        std::uint8_t  width;
+        bool          constant; // folded to one value, stored without running
+        std::uint32_t value;    // that value, encoded for the target
+        std::uint32_t begin;    // code range
+        std::uint32_t end;
+    };
+
+    // Per-track values a rule can read besides the block and the lap count
+    struct RuleInputs
+    {
+        int sprintLaps = 0; // Track INI SprintLaps, 0 = none
+        int trackIndex = 0;
+    };
+
+    // Rules compiled against one RaceConfig: its keys are constants in the
+    // bytecode, so conditions on them are decided once, not per track.
+    class Program
+    {
+    public:
+        explicit Program(const RaceConfig& race = RaceConfig()) : m_Race(race) {}
+
+        // Compiles one INI entry (key = targets, value = expression). On a
+        // syntax error nothing is added and error says why.
+        bool Add(const std::string& targets, const std::string& expression, std::string& error);
+
+        // Runs every rule on one track; txn is based at the track's block
+        // and lapAddr is its lap byte. Returns the number of changed fields.
+        std::size_t Run(const RuleInputs& in, Patch::Transaction& txn, std::uint8_t* lapAddr) const;
+
+        std::size_t RuleCount() const { return m_Rules.size(); }
+        std::size_t CodeSize() const { return m_Code.size(); }
+
+    private:
+        RaceConfig          m_Race;
+        std::vector<Instr>  m_Code;
+        std::vector<double> m_Consts;
+        std::vector<Rule>   m_Rules;
+    };
+
+    // The entries of [Rules] (may be absent); blank entries are skipped and
+    // entries that do not compile are logged and skipped.
+    Program Build(const RaceConfig& race, const IniText::Section& rulesSec);
+}
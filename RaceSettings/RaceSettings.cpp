@@ -1,29 +1,26 @@
-#include <windows.h>
+#include <cmath>
 #include <cstdio>
+#include <cstdlib>
 
 #include "RaceSettings.h"
 #include "../MagicData/MagicData.h"
 #include "../Core/Logging.h"
-#include "../GP4MemLib/GP4MemLib.h"
 
-using namespace IniLib;
-using namespace GP4MemLib;
 using namespace MagicData;
 
 namespace
 {
-    inline bool PatchIfChanged16(std::uint8_t* addr,
+    inline bool PatchIfChanged16(Patch::Transaction& txn,
+        int desc,
         std::uint16_t newVal,
         const char* label,
         int trackIndex)
     {
-        const auto oldVal = *reinterpret_cast<std::uint16_t*>(addr);
-        if (oldVal == newVal)
+        std::uint32_t oldVal = 0;
+        if (!txn.Stage(g_Desc[desc - 1].offset, 2, newVal, &oldVal))
             return false;
 
-        MemUtils::patchAddress(addr, MemUtils::toBytes(newVal), 2, false);
-
-        Logging::LogRS("Track %02d %s %u -> %u\n",
+        GP4MD_LOG_DEBUG(RaceSettings, "Track %02d %s %u -> %u\n",
             trackIndex + 1, label, oldVal, newVal);
         return true;
     }
@@ -37,52 +34,192 @@ namespace
         if (oldVal == newVal)
             return false;
 
-        MemUtils::patchAddress(addr, MemUtils::toBytes(newVal), 1, false);
+        *addr = newVal;
 
-        Logging::LogRS("Track %02d %s %u -> %u\n",
+        GP4MD_LOG_DEBUG(RaceSettings, "Track %02d %s %u -> %u\n",
             trackIndex + 1, label, oldVal, newVal);
         return true;
     }
+
+    // Key with a non-empty value that parses
+    bool GetRaceValue(const IniText::Section& raceSec, const char* key, int& out)
+    {
+        const IniText::Entry* e = raceSec.Find(key);
+        if (!e || e->value.empty())
+            return false;
+
+        if (!IniText::ParseInt(e->value, out))
+        {
+            GP4MD_LOG_INFO(RaceSettings, "RaceSettings: ignored %s (not an integer)\n", key);
+            return false;
+        }
+        return true;
+    }
+
+    bool GetMultiplier(const IniText::Section& raceSec, const char* key, double& out)
+    {
+        const IniText::Entry* e = raceSec.Find(key);
+        if (!e || e->value.empty())
+            return false;
+
+        double m = 1.0;
+        if (!IniText::ParseDouble(e->value, m))
+        {
+            GP4MD_LOG_INFO(RaceSettings, "RaceSettings: ignored %s (not a number)\n", key);
+            return false;
+        }
+
+        out = m;
+        return m != 1.0;
+    }
+
+    // Profile key: 0 = absent, 1 = set to out, -1 = blank (back to the
+    // RaceConfig default); a value that does not parse counts as absent.
+    int GetProfileInt(const IniText::Section& profile, const char* key, int& out)
+    {
+        const IniText::Entry* e = profile.Find(key);
+        if (!e)
+            return 0;
+        if (e->value.empty())
+            return -1;
+
+        if (!IniText::ParseInt(e->value, out))
+        {
+            GP4MD_LOG_INFO(RaceSettings, "Profile: ignored %s (not an integer)\n", key);
+            return 0;
+        }
+        return 1;
+    }
+
+    int GetProfileMultiplier(const IniText::Section& profile, const char* key, double& out)
+    {
+        const IniText::Entry* e = profile.Find(key);
+        if (!e)
+            return 0;
+        if (e->value.empty())
+            return -1;
+
+        double m = 1.0;
+        if (!IniText::ParseDouble(e->value, m))
+        {
+            GP4MD_LOG_INFO(RaceSettings, "Profile: ignored %s (not a number)\n", key);
+            return 0;
+        }
+
+        out = m;
+        return 1;
+    }
+
+    // desc (U16) times mul, clamped to 0..65535 and truncated
+    bool ScaleField16(Patch::Transaction& txn, int desc, double mul, int trackIndex)
+    {
+        double scaled = static_cast<double>(txn.Read(g_Desc[desc - 1].offset, 2)) * mul;
+        if (scaled > 65535.0) scaled = 65535.0;
+        if (scaled < 0.0)     scaled = 0.0;
+
+        return PatchIfChanged16(txn, desc, static_cast<std::uint16_t>(scaled), DescKey(desc), trackIndex);
+    }
 }
 
-void ApplyRaceSettings(const IniFile& raceIni,
-    const IniFile& trackIni,
-    int trackIndex)
+RaceConfig ParseRaceSettings(const IniText::Section& raceSec)
 {
-    constexpr const char* raceSec = "RaceSettings";
+    RaceConfig race;
+    race.present = raceSec.present;
+    if (!race.present)
+        return race;
+
+    int flag = 0;
+    if (GetRaceValue(raceSec, "SprintRace", flag))
+        race.sprint = flag == 1;
+    if (GetRaceValue(raceSec, "SprintPitStop", flag))
+        race.sprintPitStop = flag == 1;
+
+    GetRaceValue(raceSec, "SprintPitStopLap", race.sprintPitStopLap);
+    GetRaceValue(raceSec, "SprintPitStopWindow", race.sprintPitStopWindow);
+
+    race.hasFuel = GetMultiplier(raceSec, "FuelMultiplier", race.fuel);
+    race.hasTyre = GetMultiplier(raceSec, "TyreWearMultiplier", race.tyre);
+    race.hasYield = GetRaceValue(raceSec, "CCYield", race.yield);
+    race.hasCaution = GetRaceValue(raceSec, "CCStartCaution", race.caution);
+
+    GP4MD_LOG_DEBUG(RaceSettings, "RaceSettings: sprint=%d pitstop=%d fuel=%.3f tyre=%.3f\n",
+        race.sprint, race.sprintPitStop, race.fuel, race.tyre);
+    return race;
+}
 
-    if (!raceIni.hasSection(raceSec))
-        return;
+RaceConfig ParseRaceProfile(const RaceConfig& race, const IniText::Section& profile)
+{
+    const RaceConfig def;
+    RaceConfig       out = race;
+    out.present = true;
+
+    int flag = 0;
+    switch (GetProfileInt(profile, "SprintRace", flag))
+    {
+    case 1:  out.sprint = flag == 1; break;
+    case -1: out.sprint = def.sprint; break;
+    }
+
+    switch (GetProfileInt(profile, "SprintPitStop", flag))
+    {
+    case 1:  out.sprintPitStop = flag == 1; break;
+    case -1: out.sprintPitStop = def.sprintPitStop; break;
+    }
 
-    std::uint8_t* base = g_Layout[trackIndex].base;
+    if (GetProfileInt(profile, "SprintPitStopLap", out.sprintPitStopLap) < 0)
+        out.sprintPitStopLap = def.sprintPitStopLap;
+    if (GetProfileInt(profile, "SprintPitStopWindow", out.sprintPitStopWindow) < 0)
+        out.sprintPitStopWindow = def.sprintPitStopWindow;
 
-    // ------------------------------------------------------------
-    // SprintRace / SprintLaps
-    // ------------------------------------------------------------
-    int sprint = 0;
-    if (raceIni.hasKey(raceSec, "SprintRace"))
+    switch (GetProfileMultiplier(profile, "FuelMultiplier", out.fuel))
     {
-        IniValue v = raceIni.get(raceSec, "SprintRace");
-        if (v.length() > 0)
-            sprint = v.getAs<int>();
+    case 1:  out.hasFuel = out.fuel != 1.0; break;
+    case -1: out.hasFuel = false; out.fuel = def.fuel; break;
     }
 
-    std::uint8_t* lapAddr = g_LapTable + trackIndex;
+    switch (GetProfileMultiplier(profile, "TyreWearMultiplier", out.tyre))
+    {
+    case 1:  out.hasTyre = out.tyre != 1.0; break;
+    case -1: out.hasTyre = false; out.tyre = def.tyre; break;
+    }
+
+    switch (GetProfileInt(profile, "CCYield", out.yield))
+    {
+    case 1:  out.hasYield = true; break;
+    case -1: out.hasYield = false; out.yield = def.yield; break;
+    }
+
+    switch (GetProfileInt(profile, "CCStartCaution", out.caution))
+    {
+    case 1:  out.hasCaution = true; break;
+    case -1: out.hasCaution = false; out.caution = def.caution; break;
+    }
+
+    return out;
+}
+
+void ApplyRaceSettings(const RaceConfig& race,
+    const IniText::Section& trackSec,
+    int trackIndex,
+    Patch::Transaction& txn,
+    std::uint8_t* lapAddr)
+{
+    if (!race.present)
+        return;
+
+    // ------------------------------------------------------------
+    // SprintRace / SprintLaps
+    // ------------------------------------------------------------
     const std::uint8_t rawLaps = *lapAddr;
     std::uint8_t newLaps = rawLaps;
 
-    if (sprint == 1)
+    if (race.sprint)
     {
-        char trackSec[32];
-        std::snprintf(trackSec, sizeof(trackSec), "Track%02d", trackIndex + 1);
-
         int sprintLaps = 0;
-        if (trackIni.hasSection(trackSec) &&
-            trackIni.hasKey(trackSec, "SprintLaps"))
+        if (const IniText::Entry* e = trackSec.Find("SprintLaps"))
         {
-            IniValue v = trackIni.get(trackSec, "SprintLaps");
-            if (v.length() > 0)
-                sprintLaps = v.getAs<int>();
+            if (!e->value.empty())
+                IniText::ParseInt(e->value, sprintLaps);
         }
 
         if (sprintLaps > 0)
@@ -106,255 +243,106 @@ void ApplyRaceSettings(const IniFile& raceIni,
     // ------------------------------------------------------------
     // Sprint‑specific pitstop logic (only when SprintRace = 1)
     // ------------------------------------------------------------
-    if (sprint == 1)
+    if (race.sprint && race.sprintPitStop)
     {
-        int pitStop = 0;
-        if (raceIni.hasKey(raceSec, "SprintPitStop"))
-        {
-            IniValue v = raceIni.get(raceSec, "SprintPitStop");
-            if (v.length() > 0)
-                pitStop = v.getAs<int>();
-        }
-
-        if (pitStop == 1)
-        {
-            // desc102 = 100
-            {
-                const DescInfo& D = g_Desc[102 - 1];
-                std::uint8_t* addr = base + D.offset;
-                PatchIfChanged16(addr, 100, "desc102", trackIndex);
-            }
-
-            // desc110–114, 118–124 = 0
-            const int zeroList[] = {
-                110,111,112,113,114,
-                118,119,120,121,122,123,124
-            };
+        // desc102 = 100
+        PatchIfChanged16(txn, 102, 100, "desc102", trackIndex);
 
-            for (int desc : zeroList)
-            {
-                const DescInfo& D = g_Desc[desc - 1];
-                std::uint8_t* addr = base + D.offset;
+        // desc110–114, 118–124 = 0
+        const int zeroList[] = {
+            110,111,112,113,114,
+            118,119,120,121,122,123,124
+        };
 
-                char label[16];
-                std::snprintf(label, sizeof(label), "desc%d", desc);
+        for (int desc : zeroList)
+            PatchIfChanged16(txn, desc, 0, DescKey(desc), trackIndex);
 
-                PatchIfChanged16(addr, 0, label, trackIndex);
-            }
+        // desc103 (SprintPitStopLap)
+        {
+            int pitLap = race.sprintPitStopLap;
 
-            // desc103 (SprintPitStopLap)
+            if (pitLap <= 0)
             {
-                int pitLap = -1;
-
-                if (raceIni.hasKey(raceSec, "SprintPitStopLap"))
-                {
-                    IniValue v = raceIni.get(raceSec, "SprintPitStopLap");
-                    if (v.length() > 0)
-                        pitLap = v.getAs<int>();
-                }
-
-                if (pitLap <= 0)
-                {
-                    const int laps = *lapAddr;
-                    pitLap = (laps + 1) / 2;
-                    if (pitLap < 1) pitLap = 1;
-                }
-
-                const DescInfo& D = g_Desc[103 - 1];
-                std::uint8_t* addr = base + D.offset;
-                PatchIfChanged16(addr,
-                    static_cast<std::uint16_t>(pitLap),
-                    "desc103",
-                    trackIndex);
+                const int laps = *lapAddr;
+                pitLap = (laps + 1) / 2;
+                if (pitLap < 1) pitLap = 1;
             }
 
-            // desc104 (SprintPitStopWindow)
-            {
-                int pitWindow = 3;
-
-                if (raceIni.hasKey(raceSec, "SprintPitStopWindow"))
-                {
-                    IniValue v = raceIni.get(raceSec, "SprintPitStopWindow");
-                    if (v.length() > 0)
-                        pitWindow = v.getAs<int>();
-                }
-
-                const DescInfo& D = g_Desc[104 - 1];
-                std::uint8_t* addr = base + D.offset;
-                PatchIfChanged16(addr,
-                    static_cast<std::uint16_t>(pitWindow),
-                    "desc104",
-                    trackIndex);
-            }
+            PatchIfChanged16(txn, 103,
+                static_cast<std::uint16_t>(pitLap),
+                "desc103",
+                trackIndex);
         }
+
+        // desc104 (SprintPitStopWindow)
+        PatchIfChanged16(txn, 104,
+            static_cast<std::uint16_t>(race.sprintPitStopWindow),
+            "desc104",
+            trackIndex);
     }
 
     // --------------------------------------------------------
-    // FuelMultiplier (desc48, desc70, desc71)
+    // FuelMultiplier (desc48, desc70, desc71) and
+    // TyreWearMultiplier (desc50, desc72)
     // --------------------------------------------------------
+    if (race.hasFuel || race.hasTyre)
     {
-        double fm = 1.0;
-        bool   hasFm = false;
+        const int fuelFields[] = { 48, 70, 71 }; // fuel per lap, fuel player, fuel CC
+        const int tyreFields[] = { 50, 72 };     // tyre wear player, tyre wear CC
+
+        bool anyFuelChanged = false;
+        bool anyTyreChanged = false;
 
-        if (raceIni.hasKey(raceSec, "FuelMultiplier"))
+        if (race.hasFuel)
         {
-            IniValue v = raceIni.get(raceSec, "FuelMultiplier");
-            if (v.length() > 0)
-            {
-                fm = v.getAs<double>();
-                hasFm = true;
-            }
+            for (int desc : fuelFields)
+                anyFuelChanged |= ScaleField16(txn, desc, race.fuel, trackIndex);
         }
 
-        if (hasFm && fm != 1.0)
+        if (race.hasTyre)
         {
-            bool anyFuelChanged = false;
-
-            auto applyFuelMul16 = [&](int desc)
-                {
-                    const DescInfo& D = g_Desc[desc - 1];
-                    std::uint8_t* addr = base + D.offset;
-
-                    const std::uint16_t raw =
-                        *reinterpret_cast<std::uint16_t*>(addr);
-
-                    double scaled = static_cast<double>(raw) * fm;
-                    if (scaled > 65535.0) scaled = 65535.0;
-                    if (scaled < 0.0)     scaled = 0.0;
-
-                    const std::uint16_t newVal =
-                        static_cast<std::uint16_t>(scaled);
-
-                    char label[16];
-                    std::snprintf(label, sizeof(label), "desc%d", desc);
-                    if (PatchIfChanged16(addr, newVal, label, trackIndex))
-                        anyFuelChanged = true;
-                };
-
-            applyFuelMul16(48);   // fuel per lap
-            applyFuelMul16(70);   // fuel player
-            applyFuelMul16(71);   // fuel CC
-
-            if (anyFuelChanged)
-            {
-                Logging::LogRS("Track %02d FuelMultiplier applied = %.3f\n",
-                    trackIndex + 1, fm);
-            }
+            for (int desc : tyreFields)
+                anyTyreChanged |= ScaleField16(txn, desc, race.tyre, trackIndex);
         }
-    }
-
-    // --------------------------------------------------------
-    // TyreWearMultiplier (desc50, desc72)
-    // --------------------------------------------------------
-    {
-        double tm = 1.0;
-        bool   hasTm = false;
 
-        if (raceIni.hasKey(raceSec, "TyreWearMultiplier"))
+        if (anyFuelChanged)
         {
-            IniValue v = raceIni.get(raceSec, "TyreWearMultiplier");
-            if (v.length() > 0)
-            {
-                tm = v.getAs<double>();
-                hasTm = true;
-            }
+            GP4MD_LOG_INFO(RaceSettings, "Track %02d FuelMultiplier applied = %.3f\n",
+                trackIndex + 1, race.fuel);
         }
 
-        if (hasTm && tm != 1.0)
+        if (anyTyreChanged)
         {
-            bool anyTyreChanged = false;
-
-            auto applyTyreMul16 = [&](int desc)
-                {
-                    const DescInfo& D = g_Desc[desc - 1];
-                    std::uint8_t* addr = base + D.offset;
-
-                    const std::uint16_t raw =
-                        *reinterpret_cast<std::uint16_t*>(addr);
-
-                    double scaled = static_cast<double>(raw) * tm;
-                    if (scaled > 65535.0) scaled = 65535.0;
-                    if (scaled < 0.0)     scaled = 0.0;
-
-                    const std::uint16_t newVal =
-                        static_cast<std::uint16_t>(scaled);
-
-                    char label[16];
-                    std::snprintf(label, sizeof(label), "desc%d", desc);
-                    if (PatchIfChanged16(addr, newVal, label, trackIndex))
-                        anyTyreChanged = true;
-                };
-
-            applyTyreMul16(50);   // tyre wear player
-            applyTyreMul16(72);   // tyre wear CC
-
-            if (anyTyreChanged)
-            {
-                Logging::LogRS("Track %02d TyreWearMultiplier applied = %.3f\n",
-                    trackIndex + 1, tm);
-            }
+            GP4MD_LOG_INFO(RaceSettings, "Track %02d TyreWearMultiplier applied = %.3f\n",
+                trackIndex + 1, race.tyre);
         }
     }
 
     // --------------------------------------------------------
     // CCYield (desc49)
     // --------------------------------------------------------
+    if (race.hasYield)
     {
-        int  yield = 0;
-        bool hasYield = false;
+        const std::uint16_t v = static_cast<std::uint16_t>(race.yield);
 
-        if (raceIni.hasKey(raceSec, "CCYield"))
+        if (PatchIfChanged16(txn, 49, v, "desc49", trackIndex))
         {
-            IniValue v = raceIni.get(raceSec, "CCYield");
-            if (v.length() > 0)
-            {
-                yield = v.getAs<int>();
-                hasYield = true;
-            }
-        }
-
-        if (hasYield)
-        {
-            const DescInfo& D = g_Desc[49 - 1];
-            std::uint8_t* addr = base + D.offset;
-            const std::uint16_t v = static_cast<std::uint16_t>(yield);
-
-            if (PatchIfChanged16(addr, v, "desc49", trackIndex))
-            {
-                Logging::LogRS("RaceSettings: Track %02d CCYield changed to %d\n",
-                    trackIndex + 1, yield);
-            }
+            GP4MD_LOG_INFO(RaceSettings, "RaceSettings: Track %02d CCYield changed to %d\n",
+                trackIndex + 1, race.yield);
         }
     }
 
     // --------------------------------------------------------
     // CCStartCaution (desc73)
     // --------------------------------------------------------
+    if (race.hasCaution)
     {
-        int  caution = 0;
-        bool hasCaution = false;
+        const std::uint16_t v = static_cast<std::uint16_t>(race.caution);
 
-        if (raceIni.hasKey(raceSec, "CCStartCaution"))
+        if (PatchIfChanged16(txn, 73, v, "desc73", trackIndex))
         {
-            IniValue v = raceIni.get(raceSec, "CCStartCaution");
-            if (v.length() > 0)
-            {
-                caution = v.getAs<int>();
-                hasCaution = true;
-            }
-        }
-
-        if (hasCaution)
-        {
-            const DescInfo& D = g_Desc[73 - 1];
-            std::uint8_t* addr = base + D.offset;
-            const std::uint16_t v = static_cast<std::uint16_t>(caution);
-
-            if (PatchIfChanged16(addr, v, "desc73", trackIndex))
-            {
-                Logging::LogRS("RaceSettings: Track %02d CCStartCaution changed to %d\n",
-                    trackIndex + 1, caution);
-            }
+            GP4MD_LOG_INFO(RaceSettings, "RaceSettings: Track %02d CCStartCaution changed to %d\n",
+                trackIndex + 1, race.caution);
         }
     }
 }
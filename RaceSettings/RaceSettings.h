@@ -1,6 +1,45 @@
 #pragma once
-#include "../IniLib/IniLib.h"
+#include <cstdint>
+#include "../Core/IniText.h"
+#include "../Core/Patch.h"
 
-void ApplyRaceSettings(const IniLib::IniFile& raceIni,
-    const IniLib::IniFile& trackIni,
-    int trackIndex);
+// [RaceSettings] of GP4MD.ini, parsed and checked once per startup or
+// reload and then applied to every track that has a Track INI.
+struct RaceConfig
+{
+    bool present = false;          // the section exists
+
+    bool sprint = false;           // SprintRace=1
+    bool sprintPitStop = false;    // SprintPitStop=1
+    int  sprintPitStopLap = -1;    // <= 0: half the race
+    int  sprintPitStopWindow = 3;
+
+    bool   hasFuel = false;        // FuelMultiplier set and != 1
+    double fuel = 1.0;
+    bool   hasTyre = false;        // TyreWearMultiplier set and != 1
+    double tyre = 1.0;
+
+    bool hasYield = false;         // CCYield
+    int  yield = 0;
+    bool hasCaution = false;       // CCStartCaution
+    int  caution = 0;
+};
+
+// Reads the [RaceSettings] section of GP4MD.ini (present = false when the
+// file has none); a value that is not a number is ignored with a log line.
+RaceConfig ParseRaceSettings(const IniText::Section& raceSec);
+
+// race with the keys of a [Profile.<Name>] section on top: a key the
+// profile sets replaces the [RaceSettings] value, a blank one clears it and
+// the rest are inherited. A profile always applies, even without
+// [RaceSettings].
+RaceConfig ParseRaceProfile(const RaceConfig& race, const IniText::Section& profile);
+
+// txn is based at the track's magicdata block and sees edits already staged
+// by PatchTrack; lapAddr is the track's lap byte. Both live in private scratch
+// memory during the parallel prepare phase.
+void ApplyRaceSettings(const RaceConfig& race,
+    const IniText::Section& trackSec,
+    int trackIndex,
+    Patch::Transaction& txn,
+    std::uint8_t* lapAddr);
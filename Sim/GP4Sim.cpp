@@ -0,0 +1,207 @@
+#include "GP4Sim.h"
+#include "../Core/GP4Addresses.h"
+#include "../Core/Platform.h"
+#include "../Core/FileIO.h"
+#include <cstring>
+
+namespace
+{
+    using namespace MagicData;
+
+    GP4Sim::MemoryImage* g_Image = nullptr;
+    std::string          g_ModuleFolder;
+    std::string          g_GameFolder;
+
+    std::uint32_t NextRandom(std::uint32_t& state)
+    {
+        // xorshift32
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    std::uint8_t* SimAddressToPtr(std::uint32_t addr)
+    {
+        return g_Image ? GP4Sim::AddressToPtr(*g_Image, addr) : nullptr;
+    }
+
+    std::string SimModuleFolder()
+    {
+        return g_ModuleFolder;
+    }
+
+    std::string SimGameFolder()
+    {
+        return g_GameFolder;
+    }
+
+    void SimPatchBytes(void* dst, const void* src, std::size_t size)
+    {
+        std::memcpy(dst, src, size);
+    }
+}
+
+namespace GP4Sim
+{
+    void BuildImage(const ImageSpec& spec, MemoryImage& image)
+    {
+        const std::size_t lastDescEnd = LAST_DESC_END;
+        const std::size_t lapOffsetReal =
+            GP4Addresses::LAP_TABLE_ADDR - GP4Addresses::BASE_TRACK1_ADDR;
+
+        const int count = spec.trackCount;
+
+        // Default bump sizes: spread the real gap evenly, remainder on the
+        // last track. Counts too large for the gap get a fixed size and a
+        // lap table past LAP_TABLE_ADDR (AddressToPtr still maps it).
+        const std::size_t terminators = (count - 1) * 4 + 2;
+        const std::size_t minimum = count * (lastDescEnd + 2) + terminators;
+
+        std::vector<std::size_t> bump(count, 0);
+        if (spec.bumpBytes.size() >= static_cast<std::size_t>(count))
+        {
+            for (int t = 0; t < count; ++t)
+                bump[t] = spec.bumpBytes[t] & ~static_cast<std::size_t>(1);
+        }
+        else if (lapOffsetReal < minimum)
+        {
+            for (int t = 0; t < count; ++t)
+                bump[t] = 56;
+        }
+        else
+        {
+            const std::size_t total = lapOffsetReal - count * lastDescEnd - terminators;
+            const std::size_t each = (total / count) & ~static_cast<std::size_t>(1);
+
+            for (int t = 0; t < count - 1; ++t)
+                bump[t] = each;
+            bump[count - 1] = total - each * (count - 1);
+        }
+
+        std::size_t size = 0;
+        for (int t = 0; t < count; ++t)
+            size += lastDescEnd + bump[t] + (t < count - 1 ? 4 : 2);
+        size += count;
+        size += 0x20000; // GP4.exe data goes on past the lap table: a TrackCount
+                         // above count scans it up to the 128 KB per-block limit
+
+        image.bytes.assign(size, 0);
+        image.trackOffset.assign(count, 0);
+        image.trackCount = count;
+
+        std::uint32_t rng = spec.seed ? spec.seed : 1;
+        std::uint8_t* p = image.bytes.data();
+
+        for (int t = 0; t < count; ++t)
+        {
+            image.trackOffset[t] = static_cast<std::size_t>(p - image.bytes.data());
+
+            // Descriptors: setup bytes near the encoded zero, everything else < 0x80
+            for (int d = 0; d < DESC_COUNT; ++d)
+            {
+                const DescInfo& D = g_Desc[d];
+                const std::size_t width =
+                    D.type == DescType::U32 ? 4 : D.type == DescType::U16 ? 2 : 1;
+
+                for (std::size_t i = 0; i < width; ++i)
+                    p[D.offset + i] = static_cast<std::uint8_t>(NextRandom(rng) & 0x7F);
+
+                if (D.type == DescType::SETUP_BYTE)
+                    p[D.offset] = static_cast<std::uint8_t>(151 + NextRandom(rng) % 10);
+            }
+            p += lastDescEnd;
+
+            for (std::size_t i = 0; i < bump[t]; ++i)
+                *p++ = static_cast<std::uint8_t>(NextRandom(rng) & 0x7F);
+
+            *p++ = 0xFF;
+            *p++ = 0xFF;
+            if (t < count - 1)
+            {
+                *p++ = 0x00;
+                *p++ = 0x00;
+            }
+        }
+
+        image.lapOffset = static_cast<std::size_t>(p - image.bytes.data());
+        for (int t = 0; t < count; ++t)
+        {
+            const std::uint8_t laps = t < static_cast<int>(spec.laps.size()) ? spec.laps[t] : 0;
+            *p++ = laps ? laps : static_cast<std::uint8_t>(44 + NextRandom(rng) % 30);
+        }
+    }
+
+    std::uint8_t* AddressToPtr(MemoryImage& image, std::uint32_t addr)
+    {
+        const std::uint32_t lapAddr = GP4Addresses::LAP_TABLE_ADDR;
+        const std::uint32_t baseAddr = GP4Addresses::BASE_TRACK1_ADDR;
+
+        if (addr >= lapAddr && addr < lapAddr + static_cast<std::uint32_t>(image.trackCount))
+            return image.bytes.data() + image.lapOffset + (addr - lapAddr);
+
+        if (addr < baseAddr || addr - baseAddr >= image.bytes.size())
+            return nullptr;
+
+        return image.bytes.data() + (addr - baseAddr);
+    }
+
+    void Install(MemoryImage& image,
+        const std::string& moduleFolder,
+        const std::string& gameFolder)
+    {
+        g_Image = &image;
+        g_ModuleFolder = moduleFolder;
+        g_GameFolder = gameFolder;
+
+        Platform::Providers p;
+        p.addressToPtr = &SimAddressToPtr;
+        p.moduleFolder = &SimModuleFolder;
+        p.gameFolder = &SimGameFolder;
+        p.patchBytes = &SimPatchBytes;
+        Platform::SetProviders(p);
+    }
+
+    void Uninstall()
+    {
+        Platform::SetProviders(Platform::DefaultProviders());
+        g_Image = nullptr;
+        g_ModuleFolder.clear();
+        g_GameFolder.clear();
+    }
+
+    bool WriteSyntheticDat(const std::string& gameFolder,
+        int trackIndex,
+        const std::uint8_t* magic,
+        std::size_t magicSize,
+        int laps,
+        std::size_t padding)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "Circuits/S1CT%02d.DAT", trackIndex + 1);
+
+        std::FILE* f = OpenFile((gameFolder + name).c_str(), "wb");
+        if (!f)
+            return false;
+
+        // Padding from a marker-free alphabet
+        std::uint32_t rng = static_cast<std::uint32_t>(trackIndex + 1) * 2654435761u;
+        std::vector<std::uint8_t> pad(padding);
+        for (std::uint8_t& b : pad)
+            b = static_cast<std::uint8_t>(0x10 + NextRandom(rng) % 0x30);
+
+        static const std::uint8_t ma03[] = { 'M', 'A', '0', '3' };
+        static const std::uint8_t term[] = { 0x00, 0xFF, 0xFF };
+
+        bool ok = std::fwrite(pad.data(), 1, pad.size(), f) == pad.size();
+        ok = ok && std::fwrite(ma03, 1, sizeof(ma03), f) == sizeof(ma03);
+        ok = ok && std::fwrite(magic, 1, magicSize, f) == magicSize;
+        ok = ok && std::fwrite(term, 1, sizeof(term), f) == sizeof(term);
+
+        if (ok && laps > 0)
+            ok = std::fprintf(f, "laps|%d", laps) > 0;
+
+        std::fclose(f);
+        return ok;
+    }
+}
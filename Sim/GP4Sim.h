@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "../MagicData/MagicData.h"
+
+// Headless stand-in for the GP4 process. Builds a byte buffer laid out like
+// GP4.exe from BASE_TRACK1_ADDR and routes the Platform providers to it, so
+// PatchAllTracks, Scan and the .dat / INI paths run without the game.
+namespace GP4Sim
+{
+    struct ImageSpec
+    {
+        // Number of magicdata blocks; match [General] TrackCount.
+        int trackCount = MagicData::DEFAULT_TRACK_COUNT;
+
+        // Bump table bytes per track, excluding the terminator (even values).
+        // Empty: sizes that put the lap table at GP4Addresses::LAP_TABLE_ADDR.
+        std::vector<std::size_t> bumpBytes;
+
+        // Laps per track; missing or 0 entries get a generated value.
+        std::vector<std::uint8_t> laps;
+        std::uint32_t             seed = 1;
+    };
+
+    // trackCount magicdata blocks (descriptors, bump table, terminator) followed by
+    // the lap table. Generated bytes never contain FF FF, so the only
+    // terminators are the ones written at block ends.
+    struct MemoryImage
+    {
+        std::vector<std::uint8_t> bytes;
+        std::vector<std::size_t>  trackOffset;
+        std::size_t               lapOffset = 0;
+        int                       trackCount = 0;
+    };
+
+    void BuildImage(const ImageSpec& spec, MemoryImage& image);
+
+    // Maps a GP4 address into the image; the lap table address always maps to
+    // the image's lap table, even when oversized bump tables move it.
+    std::uint8_t* AddressToPtr(MemoryImage& image, std::uint32_t addr);
+
+    // Points the Platform providers at image and the given folders (with
+    // trailing separator). The image must outlive the installation.
+    void Install(MemoryImage& image,
+        const std::string& moduleFolder,
+        const std::string& gameFolder);
+
+    void Uninstall();
+
+    // Writes <gameFolder>/Circuits/S1CTnn.DAT: padding, "MA03", magicdata,
+    // 00 FF FF, then "laps|<laps>" (omitted when laps <= 0).
+    bool WriteSyntheticDat(const std::string& gameFolder,
+        int trackIndex,
+        const std::uint8_t* magic,
+        std::size_t magicSize,
+        int laps,
+        std::size_t padding);
+}
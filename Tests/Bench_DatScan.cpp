@@ -0,0 +1,63 @@
+// .dat marker scan: ScanDatMarkers (the dispatched SIMD path) against the
+// byte-at-a-time loops of ScanDatMarkersScalar, on synthetic circuit files
+// from 64 KB to 16 MB.
+#include "TestSupport.h"
+#include "../MagicData/MagicData_IO.h"
+
+using namespace MagicData;
+
+namespace
+{
+    // Both scans over ~64 MB of input, so small files are timed as often as
+    // a large one
+    constexpr std::size_t BYTES_PER_RUN = 64u << 20;
+
+    bool SameMarkers(const DatMarkers& a, const DatMarkers& b)
+    {
+        return a.magicStart == b.magicStart && a.magicEnd == b.magicEnd && a.lapsMarker == b.lapsMarker;
+    }
+}
+
+int main()
+{
+    const std::string folder = TestSupport::ScratchFolder("Bench_DatScan");
+    const std::size_t paddings[] = { 64u << 10, 1u << 20, 16u << 20 };
+
+    std::printf("%-10s %12s %12s %8s  (%s)\n", "padding", "scalar MB/s", "simd MB/s", "speedup", DatScanPathName());
+
+    int mismatches = 0;
+    for (std::size_t i = 0; i < sizeof(paddings) / sizeof(paddings[0]); ++i)
+    {
+        std::vector<std::uint8_t> magic(340, 0x21);
+        GP4Sim::WriteSyntheticDat(folder, static_cast<int>(i), magic.data(), magic.size(), 60, paddings[i]);
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "Circuits/S1CT%02d.DAT", static_cast<int>(i) + 1);
+        const std::string text = TestSupport::ReadText(folder + name);
+
+        const auto* data = reinterpret_cast<const std::uint8_t*>(text.data());
+        const std::size_t size = text.size();
+        const std::size_t repeat = BYTES_PER_RUN / size + 1;
+
+        DatMarkers scalar, simd;
+        const double scalarMs = TestSupport::BestOfMs(5, [&]
+            {
+                for (std::size_t r = 0; r < repeat; ++r)
+                    ScanDatMarkersScalar(data, size, scalar);
+            });
+        const double simdMs = TestSupport::BestOfMs(5, [&]
+            {
+                for (std::size_t r = 0; r < repeat; ++r)
+                    ScanDatMarkers(data, size, simd);
+            });
+
+        if (!SameMarkers(scalar, simd))
+            ++mismatches;
+
+        const double mb = static_cast<double>(size) * repeat / (1024.0 * 1024.0);
+        std::printf("%-10zu %12.0f %12.0f %7.1fx%s\n", paddings[i], mb * 1000.0 / scalarMs,
+            mb * 1000.0 / simdMs, scalarMs / simdMs, SameMarkers(scalar, simd) ? "" : "  MISMATCH");
+    }
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+// Logging on against off: PatchAllTracks on the simulated image with every
+// category at debug, written by the flusher (LogAsync=1) or by each caller
+// (LogAsync=0), against Log=0. The debug sink costs ~20 us a line, about
+// what OutputDebugStringA costs with DebugView attached.
+#include "TestSupport.h"
+#include "../Core/Logging.h"
+
+using namespace MagicData;
+
+namespace
+{
+    void SlowSink(const char*)
+    {
+        const double start = Platform::NowMs();
+        while (Platform::NowMs() - start < 0.02)
+        {
+        }
+    }
+
+    struct Mode
+    {
+        const char* name;
+        const char* general;
+    };
+}
+
+int main()
+{
+    const std::string folder = TestSupport::ScratchFolder("Bench_Logging");
+
+    TestSupport::WriteDats(folder, DEFAULT_TRACK_COUNT);
+    TestSupport::WriteTrackInis(folder, DEFAULT_TRACK_COUNT);
+
+    const Mode modes[] = {
+        { "off",   "[General]\nLog=0\nLogFile=0\n" },
+        { "async", "[General]\nLogLevel=debug\nLogAsync=1\nLogFile=1\n" },
+        { "sync",  "[General]\nLogLevel=debug\nLogAsync=0\nLogFile=1\n" },
+    };
+
+    std::printf("%-6s %10s %10s %12s\n", "mode", "ms", "lines", "vs off");
+
+    double offMs = 0.0;
+    std::uint64_t lines = 0;
+    for (const Mode& m : modes)
+    {
+        TestSupport::WriteText(folder + "GP4MD.ini", m.general);
+
+        GP4Sim::ImageSpec   spec;
+        GP4Sim::MemoryImage image;
+        GP4Sim::BuildImage(spec, image);
+        GP4Sim::Install(image, folder, folder);
+
+        Platform::Providers p = Platform::Current();
+        p.debugOutput = &SlowSink;
+        Platform::SetProviders(p);
+
+        const double ms = TestSupport::BestOfMs(5, [&]
+            {
+                PatchAllTracks();
+            });
+        Logging::Flush();
+
+        const std::uint64_t queued = Logging::GetStats().queued;
+        const std::uint64_t perRun = (queued - lines) / 5;
+        lines = queued;
+
+        if (&m == &modes[0])
+            offMs = ms;
+
+        std::printf("%-6s %10.3f %10llu %11.2fx\n", m.name, ms,
+            static_cast<unsigned long long>(perRun), ms / offMs);
+
+        GP4Sim::Uninstall();
+    }
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+// Season-wide descriptor edit, MagicTable against the per-track pointer
+// path: tyre wear x1.3, fuel x2.5, the pit stop group zeroed and
+// desc102=100 for every slot. The table is timed with the columns kept
+// between edits and with a Gather / Scatter round trip around each one.
+#include "TestSupport.h"
+#include "../MagicData/MagicData_Table.h"
+#include <cstring>
+
+using namespace MagicData;
+
+namespace
+{
+    constexpr int CALLS = 20000;
+
+    const int FUEL[] = { 48, 70, 71 };
+    const int TYRES[] = { 50, 72 };
+    const int ZERO[] = { 110, 111, 112, 113, 114, 118, 119, 120, 121, 122, 123, 124 };
+
+    std::uint16_t Read16(const std::uint8_t* base, int desc)
+    {
+        std::uint16_t v;
+        std::memcpy(&v, base + g_Desc[desc - 1].offset, 2);
+        return v;
+    }
+
+    void Write16(std::uint8_t* base, int desc, std::uint16_t v)
+    {
+        std::memcpy(base + g_Desc[desc - 1].offset, &v, 2);
+    }
+
+    // RaceSettings' clamp and truncation
+    std::uint16_t Scaled(std::uint16_t raw, double mul)
+    {
+        double v = static_cast<double>(raw) * mul;
+        if (v > 65535.0) v = 65535.0;
+        if (v < 0.0)     v = 0.0;
+        return static_cast<std::uint16_t>(v);
+    }
+
+    // Block by block, field by field, as PrepareTrack stages them
+    void EditPointers(std::uint8_t* const* blocks, int tracks)
+    {
+        for (int t = 0; t < tracks; ++t)
+        {
+            std::uint8_t* b = blocks[t];
+
+            for (int d : TYRES)
+                Write16(b, d, Scaled(Read16(b, d), 1.3));
+            for (int d : FUEL)
+                Write16(b, d, Scaled(Read16(b, d), 2.5));
+            for (int d : ZERO)
+                Write16(b, d, 0);
+            Write16(b, 102, 100);
+        }
+    }
+
+    void EditTable(MagicTable& table)
+    {
+        for (int d : TYRES)
+            table.Scale(d, 1.3);
+        for (int d : FUEL)
+            table.Scale(d, 2.5);
+        for (int d : ZERO)
+            table.Fill(d, 0);
+        table.Fill(102, 100);
+    }
+
+    // Descriptor regions of tracks blocks, with a GP4-sized bump table
+    // after each
+    std::vector<std::uint8_t> Season(int tracks)
+    {
+        std::vector<std::uint8_t> bytes(tracks * (LAST_DESC_END + 56));
+        std::uint32_t rng = 7;
+        for (std::uint8_t& b : bytes)
+        {
+            rng = rng * 1103515245u + 12345u;
+            b = static_cast<std::uint8_t>(rng >> 16);
+        }
+        return bytes;
+    }
+
+    std::vector<std::uint8_t*> Blocks(std::vector<std::uint8_t>& season, int tracks)
+    {
+        std::vector<std::uint8_t*> blocks(tracks);
+        for (int t = 0; t < tracks; ++t)
+            blocks[t] = season.data() + t * (LAST_DESC_END + 56);
+        return blocks;
+    }
+}
+
+int main()
+{
+    std::printf("%-7s %12s %12s %14s %10s\n", "tracks", "pointer us", "table us", "round trip us", "same");
+
+    int mismatches = 0;
+    const int counts[] = { DEFAULT_TRACK_COUNT, 40, MAX_TRACK_COUNT };
+    for (int tracks : counts)
+    {
+        // One edit both ways, compared byte for byte
+        std::vector<std::uint8_t> a = Season(tracks), b = a;
+        const std::vector<std::uint8_t*> pa = Blocks(a, tracks), pb = Blocks(b, tracks);
+
+        MagicTable table;
+        table.Resize(tracks);
+
+        EditPointers(pa.data(), tracks);
+        table.Gather(pb.data());
+        EditTable(table);
+        table.Scatter(pb.data());
+
+        const bool same = a == b;
+        if (!same)
+            ++mismatches;
+
+        const double pointerMs = TestSupport::BestOfMs(5, [&]
+            {
+                for (int c = 0; c < CALLS; ++c)
+                    EditPointers(pa.data(), tracks);
+            });
+        const double tableMs = TestSupport::BestOfMs(5, [&]
+            {
+                for (int c = 0; c < CALLS; ++c)
+                    EditTable(table);
+            });
+        const double roundTripMs = TestSupport::BestOfMs(5, [&]
+            {
+                for (int c = 0; c < CALLS; ++c)
+                {
+                    table.Gather(pb.data());
+                    EditTable(table);
+                    table.Scatter(pb.data());
+                }
+            });
+
+        std::printf("%-7d %12.3f %12.3f %14.3f %10s\n", tracks, pointerMs * 1000.0 / CALLS,
+            tableMs * 1000.0 / CALLS, roundTripMs * 1000.0 / CALLS, same ? "yes" : "MISMATCH");
+    }
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+// RaceSettings layer per season of 17 tracks: ApplyRaceSettings (the
+// default path), the same settings as rules (BuiltinRules.h), and a
+// typical [Rules] section run after ApplyRaceSettings.
+#include "TestSupport.h"
+#include "BuiltinRules.h"
+#include "../Core/Logging.h"
+
+using namespace MagicData;
+
+namespace
+{
+    constexpr int CALLS = 20000;
+
+    std::vector<std::vector<std::uint8_t>> Season()
+    {
+        std::vector<std::vector<std::uint8_t>> blocks(DEFAULT_TRACK_COUNT, std::vector<std::uint8_t>(LAST_DESC_END));
+
+        std::uint32_t rng = 3;
+        for (std::vector<std::uint8_t>& b : blocks)
+        {
+            for (std::uint8_t& byte : b)
+            {
+                rng = rng * 1103515245u + 12345u;
+                byte = static_cast<std::uint8_t>(rng >> 16);
+            }
+        }
+        return blocks;
+    }
+
+    // One pass over the season; fills changed with the staged field count
+    template <typename F>
+    double SeasonUs(std::vector<std::vector<std::uint8_t>>& blocks, std::size_t& changed, F apply)
+    {
+        const double ms = TestSupport::BestOfMs(5, [&]
+            {
+                changed = 0;
+                for (int c = 0; c < CALLS; ++c)
+                {
+                    for (int t = 0; t < DEFAULT_TRACK_COUNT; ++t)
+                    {
+                        std::uint8_t       laps = 60;
+                        Patch::Transaction txn(blocks[t].data(), LAST_DESC_END);
+                        apply(t, txn, &laps);
+                        changed += txn.Changes().size();
+                    }
+                }
+            });
+        return ms * 1000.0 / CALLS;
+    }
+}
+
+int main()
+{
+    Logging::SetAllLevels(Logging::Level::Error);
+
+    IniText::Section raceSec;
+    raceSec.present = true;
+    raceSec.entries = {
+        { "SprintRace", "1" }, { "SprintPitStop", "1" }, { "FuelMultiplier", "2.5" },
+        { "TyreWearMultiplier", "3" }, { "CCYield", "1234" }, { "CCStartCaution", "7" },
+    };
+    const RaceConfig race = ParseRaceSettings(raceSec);
+
+    IniText::Section rulesSec;
+    rulesSec.present = true;
+    rulesSec.entries = {
+        { "desc48, desc70", "clamp(self * 1.15, 0, 65535)" },
+        { "desc102", "track > 10 ? 90 : self" },
+        { "laps", "SprintLaps > 0 && SprintRace ? SprintLaps : laps" },
+    };
+
+    const RaceRules::Program builtin = TestSupport::BuiltinRules(race);
+    const RaceRules::Program rules = RaceRules::Build(race, rulesSec);
+
+    IniText::Section trackSec;
+    trackSec.present = true;
+
+    std::vector<std::vector<std::uint8_t>> blocks = Season();
+    std::size_t changedApply = 0, changedBuiltin = 0, changedRules = 0;
+
+    const double applyUs = SeasonUs(blocks, changedApply, [&](int t, Patch::Transaction& txn, std::uint8_t* laps)
+        {
+            ApplyRaceSettings(race, trackSec, t, txn, laps);
+        });
+
+    const double builtinUs = SeasonUs(blocks, changedBuiltin, [&](int t, Patch::Transaction& txn, std::uint8_t* laps)
+        {
+            RaceRules::RuleInputs in;
+            in.trackIndex = t;
+            builtin.Run(in, txn, laps);
+        });
+
+    const double rulesUs = SeasonUs(blocks, changedRules, [&](int t, Patch::Transaction& txn, std::uint8_t* laps)
+        {
+            ApplyRaceSettings(race, trackSec, t, txn, laps);
+
+            RaceRules::RuleInputs in;
+            in.trackIndex = t;
+            rules.Run(in, txn, laps);
+        });
+
+    std::printf("%-34s %10s %10s\n", "17 tracks", "us", "staged");
+    std::printf("%-34s %10.3f %10zu\n", "ApplyRaceSettings", applyUs, changedApply / CALLS);
+    std::printf("%-34s %10.3f %10zu\n", "BuiltinRules", builtinUs, changedBuiltin / CALLS);
+    std::printf("%-34s %10.3f %10zu\n", "ApplyRaceSettings + 3 [Rules]", rulesUs, changedRules / CALLS);
+
+    return changedApply == changedBuiltin ? 0 : 1;
+}
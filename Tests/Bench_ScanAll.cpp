@@ -0,0 +1,78 @@
+// Original layout scan: ScanAll (one forward pass, SSE2 where available)
+// against ScanAllScalar (Scan per block), on GP4's layout and on images
+// whose bump tables grow to 100 KB, the first ones largest.
+#include "TestSupport.h"
+#include "../MagicData/MagicData_Internal.h"
+
+using namespace MagicData;
+
+namespace
+{
+    // Both scans over ~64 MB of image per run
+    constexpr std::size_t BYTES_PER_RUN = 64u << 20;
+
+    struct Layout
+    {
+        const char* name;
+        std::size_t first; // bump bytes of the first track; 0: GP4's sizes
+        std::size_t rest;
+    };
+}
+
+int main()
+{
+    const Layout layouts[] = {
+        { "gp4",          0,      0 },
+        { "first 8K",     8192,   56 },
+        { "first 100K",   100000, 56 },
+        { "all 8K",       8192,   8192 },
+        { "all 100K",     100000, 100000 },
+    };
+
+    std::printf("%-12s %10s %12s %12s %8s\n", "layout", "image KB", "scalar MB/s", "vector MB/s", "speedup");
+
+    int mismatches = 0;
+    for (const Layout& l : layouts)
+    {
+        GP4Sim::ImageSpec spec;
+        if (l.first)
+        {
+            spec.bumpBytes.assign(DEFAULT_TRACK_COUNT, l.rest);
+            spec.bumpBytes[0] = l.first;
+        }
+
+        GP4Sim::MemoryImage image;
+        GP4Sim::BuildImage(spec, image);
+        SetTrackCount(spec.trackCount);
+
+        std::uint8_t* base = image.bytes.data();
+        const std::size_t size = image.lapOffset;
+        const std::size_t repeat = BYTES_PER_RUN / size + 1;
+
+        std::vector<MagicBlockLayout> vec(g_TrackCount), ref(g_TrackCount);
+        int vecFound = 0, refFound = 0;
+
+        const double scalarMs = TestSupport::BestOfMs(5, [&]
+            {
+                for (std::size_t r = 0; r < repeat; ++r)
+                    refFound = MagicDataInternal::ScanAllScalar(base, ref.data());
+            });
+        const double vectorMs = TestSupport::BestOfMs(5, [&]
+            {
+                for (std::size_t r = 0; r < repeat; ++r)
+                    vecFound = MagicDataInternal::ScanAll(base, vec.data());
+            });
+
+        bool same = vecFound == refFound && vecFound == g_TrackCount;
+        for (int t = 0; same && t < vecFound; ++t)
+            same = vec[t].bumpEnd == ref[t].bumpEnd;
+        if (!same)
+            ++mismatches;
+
+        const double mb = static_cast<double>(size) * repeat / (1024.0 * 1024.0);
+        std::printf("%-12s %10zu %12.0f %12.0f %7.1fx%s\n", l.name, size / 1024, mb * 1000.0 / scalarMs,
+            mb * 1000.0 / vectorMs, scalarMs / vectorMs, same ? "" : "  MISMATCH");
+    }
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+// Track INI overrides, sparse against dense: PatchTrack walks the keys a
+// section contains, the replaced code looked up every descriptor key
+// whether or not the file had it. Both parse the section first, as a
+// startup does.
+#include "TestSupport.h"
+#include "../MagicData/MagicData_Internal.h"
+#include "../Core/IniText.h"
+#include "../Core/Logging.h"
+
+using namespace MagicData;
+
+namespace
+{
+    constexpr int CALLS = 20000;
+
+    // [Track01] with keyCount descriptor keys spread over the schema
+    std::string TrackText(int keyCount)
+    {
+        std::string text = "[Track01]\nlaps = 52\n";
+        for (int i = 0; i < keyCount; ++i)
+        {
+            char line[32];
+            std::snprintf(line, sizeof(line), "desc%d = %d\n", 1 + i * DESC_COUNT / keyCount, 10 + i);
+            text += line;
+        }
+        return text;
+    }
+
+    // The descriptor-driven lookup PatchTrack replaced
+    void PatchEveryDescriptor(Patch::Transaction& txn, const IniText::Section& sec)
+    {
+        for (int d = 1; d <= DESC_COUNT; ++d)
+        {
+            char key[16];
+            std::snprintf(key, sizeof(key), "desc%d", d);
+
+            int value = 0;
+            const IniText::Entry* e = sec.Find(key);
+            if (e && IniText::ParseInt(e->value, value))
+                MagicDataInternal::PatchDesc(txn, d, value);
+        }
+    }
+}
+
+int main()
+{
+    Logging::SetAllLevels(Logging::Level::Error);
+
+    std::vector<std::uint8_t> block(LAST_DESC_END + 64, 0);
+    std::uint8_t lap = 0;
+
+    std::printf("%-6s %14s %14s %8s\n", "keys", "sparse us", "dense us", "ratio");
+
+    const int keyCounts[] = { 0, 4, 16, 64, DESC_COUNT };
+    for (int keys : keyCounts)
+    {
+        const std::string text = TrackText(keys);
+
+        const double sparseMs = TestSupport::BestOfMs(5, [&]
+            {
+                for (int c = 0; c < CALLS; ++c)
+                {
+                    IniText::Section sec;
+                    IniText::ReadSection(text, "Track01", sec);
+
+                    Patch::Transaction txn(block.data(), block.size());
+                    MagicDataInternal::PatchTrack(txn, &lap, sec, false, 0);
+                }
+            });
+
+        const double denseMs = TestSupport::BestOfMs(5, [&]
+            {
+                for (int c = 0; c < CALLS; ++c)
+                {
+                    IniText::Section sec;
+                    IniText::ReadSection(text, "Track01", sec);
+
+                    Patch::Transaction txn(block.data(), block.size());
+                    PatchEveryDescriptor(txn, sec);
+                }
+            });
+
+        std::printf("%-6d %14.3f %14.3f %7.1fx\n", keys, sparseMs * 1000.0 / CALLS,
+            denseMs * 1000.0 / CALLS, denseMs / sparseMs);
+    }
+
+    return 0;
+}
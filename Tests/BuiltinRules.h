@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+#include "TestSupport.h"
+#include "../RaceSettings/RaceRules.h"
+
+// ApplyRaceSettings written as [Rules] entries, in its order. Not shipped:
+// the DLL always applies [RaceSettings] through ApplyRaceSettings; the
+// tests use this as an independent reference for it and the bench as a
+// rule program of known size.
+namespace TestSupport
+{
+    constexpr const char* BUILTIN_RULES[][2] = {
+        { "laps",    "SprintRace ? (SprintLaps > 0 ? min(SprintLaps, 255) : max(laps / 3, 1)) : laps" },
+        { "desc102", "SprintRace && SprintPitStop ? 100 : self" },
+        { "desc110, desc111, desc112, desc113, desc114, desc118, desc119, desc120, desc121, desc122, desc123, desc124",
+                     "SprintRace && SprintPitStop ? 0 : self" },
+        { "desc103", "SprintRace && SprintPitStop ? (SprintPitStopLap > 0 ? SprintPitStopLap : max((laps + 1) / 2, 1)) : self" },
+        { "desc104", "SprintRace && SprintPitStop ? SprintPitStopWindow : self" },
+        { "desc48, desc70, desc71", "clamp(self * FuelMultiplier, 0, 65535)" },
+        { "desc50, desc72",         "clamp(self * TyreWearMultiplier, 0, 65535)" },
+        { "desc49",  "has(CCYield) ? CCYield : self" },
+        { "desc73",  "has(CCStartCaution) ? CCStartCaution : self" },
+    };
+
+    // Every entry must compile; a failure is a failed check
+    inline RaceRules::Program BuiltinRules(const RaceConfig& race)
+    {
+        RaceRules::Program program(race);
+        std::string        error;
+
+        for (const auto& rule : BUILTIN_RULES)
+        {
+            if (!program.Add(rule[0], rule[1], error))
+                Fail(__FILE__, __LINE__, (std::string("built-in rule ") + rule[0] + ": " + error).c_str());
+        }
+        return program;
+    }
+}
@@ -0,0 +1,191 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../Core/FileIO.h"
+#include "../Core/Hash.h"
+#include "../Core/Platform.h"
+#include "../MagicData/MagicData.h"
+#include "../Sim/GP4Sim.h"
+
+// Shared by the tests and benches of the CMake build (POSIX hosts): checks,
+// scratch folders and a synthetic season for the simulated GP4 image. Each
+// test is its own executable, so the core's globals start fresh in each.
+namespace TestSupport
+{
+    // -------------------------------------------------------------------------
+    // Checks
+    // -------------------------------------------------------------------------
+    inline int& Failures()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    inline void Fail(const char* file, int line, const char* what)
+    {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+        ++Failures();
+    }
+
+    // Exit code for main
+    inline int Result(const char* name)
+    {
+        if (Failures() == 0)
+        {
+            std::printf("%s: passed\n", name);
+            return 0;
+        }
+
+        std::printf("%s: %d check(s) failed\n", name, Failures());
+        return 1;
+    }
+
+    // -------------------------------------------------------------------------
+    // Benchmarks
+    // -------------------------------------------------------------------------
+
+    // Fastest of runs calls of f, in milliseconds
+    template <typename F>
+    double BestOfMs(int runs, F f)
+    {
+        double best = 0.0;
+        for (int r = 0; r < runs; ++r)
+        {
+            const double start = Platform::NowMs();
+            f();
+            const double ms = Platform::NowMs() - start;
+
+            if (r == 0 || ms < best)
+                best = ms;
+        }
+        return best;
+    }
+
+    // -------------------------------------------------------------------------
+    // Files
+    // -------------------------------------------------------------------------
+    inline void RemoveTree(const std::string& path)
+    {
+        if (DIR* dir = opendir(path.c_str()))
+        {
+            while (const dirent* e = readdir(dir))
+            {
+                const std::string name = e->d_name;
+                if (name != "." && name != "..")
+                    RemoveTree(path + "/" + name);
+            }
+            closedir(dir);
+            rmdir(path.c_str());
+        }
+        else
+        {
+            unlink(path.c_str());
+        }
+    }
+
+    // Empty <working folder>/<name>.tmp/ with a Circuits subfolder; returned
+    // with a trailing separator, as Platform::ModuleFolder does.
+    inline std::string ScratchFolder(const std::string& name)
+    {
+        const std::string dir = name + ".tmp";
+
+        RemoveTree(dir);
+        mkdir(dir.c_str(), 0755);
+        mkdir((dir + "/Circuits").c_str(), 0755);
+
+        char cwd[4096];
+        const std::string base = getcwd(cwd, sizeof(cwd)) ? cwd : ".";
+        return base + "/" + dir + "/";
+    }
+
+    inline bool WriteText(const std::string& path, const std::string& text)
+    {
+        std::FILE* f = OpenFile(path.c_str(), "wb");
+        if (!f)
+            return false;
+
+        const bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+        return std::fclose(f) == 0 && ok;
+    }
+
+    inline std::string ReadText(const std::string& path)
+    {
+        std::string text;
+        Platform::ReadWholeFile(path, text);
+        return text;
+    }
+
+    // -------------------------------------------------------------------------
+    // Synthetic season
+    // -------------------------------------------------------------------------
+
+    // [General] lines every test starts from: errors only, no log file.
+    constexpr char QUIET_GENERAL[] = "[General]\nLogLevel=error\nLogDebug=0\nLogFile=0\n";
+
+    // S1CTnn.DAT for the first datTracks tracks: magicdata of 336 bytes
+    // (426 for track 3) filled with 0x11 + t, laps 50 + t.
+    inline void WriteDats(const std::string& folder, int datTracks)
+    {
+        for (int t = 0; t < datTracks; ++t)
+        {
+            std::vector<std::uint8_t> magic(296 + (t == 2 ? 90 : 40), static_cast<std::uint8_t>(0x11 + t));
+            magic[0] = 160;
+            GP4Sim::WriteSyntheticDat(folder, t, magic.data(), magic.size(), 50 + t, 1 << 16);
+        }
+    }
+
+    // TrackNN.ini for every track: a laps key on two tracks out of three
+    // (blank on the second), SprintLaps on every fourth and a fixed set of
+    // descriptors, one of them behind an inline comment.
+    inline void WriteTrackInis(const std::string& folder, int trackCount)
+    {
+        for (int t = 0; t < trackCount; ++t)
+        {
+            char text[512];
+            int  n = std::snprintf(text, sizeof(text), "[Track%02d]\n", t + 1);
+
+            if (t % 3 == 0)
+                n += std::snprintf(text + n, sizeof(text) - n, "laps = %d\n", 40 + t);
+            else if (t % 3 == 1)
+                n += std::snprintf(text + n, sizeof(text) - n, "laps =\n");
+
+            if (t % 4 == 0)
+                n += std::snprintf(text + n, sizeof(text) - n, "SprintLaps = %d\n", 10 + t);
+
+            std::snprintf(text + n, sizeof(text) - n,
+                "desc1 = 3\ndesc25 = 70000 ; c\ndesc35 = 54\ndesc48 = %d\ndesc50 = 40000\n"
+                "desc139 = 9\ndesc140 = 5\ndesc0 = 1\n", 3000 + t);
+
+            char name[32];
+            std::snprintf(name, sizeof(name), "Track%02d.ini", t + 1);
+            WriteText(folder + name, text);
+        }
+    }
+
+    // Everything PatchAllTracks publishes: each relocated block and its
+    // size, the relocated lap table and GP4's memory up to the end of its
+    // lap table. Independent of the host's word size.
+    inline std::uint64_t HashPatched(const GP4Sim::MemoryImage& image)
+    {
+        std::uint64_t h = FNV1A_OFFSET;
+
+        for (int t = 0; t < MagicData::g_TrackCount; ++t)
+        {
+            const MagicData::MagicBlockLayout& l = MagicData::g_Layout[t];
+            h = HashBytes(l.base, MagicData::LAST_DESC_END + l.bumpSize, h);
+            h = HashValue(static_cast<std::uint32_t>(l.bumpSize), h);
+        }
+
+        h = HashBytes(MagicData::g_LapTable, MagicData::g_TrackCount, h);
+        return HashBytes(image.bytes.data(), image.lapOffset + MagicData::g_TrackCount, h);
+    }
+}
+
+#define CHECK(cond) \
+    do { if (!(cond)) TestSupport::Fail(__FILE__, __LINE__, #cond); } while (0)
@@ -0,0 +1,96 @@
+// DatCache on synthetic S1CTnn.DAT files: each file is mapped once however
+// often it is requested, and the bytes and time per track reach the startup
+// profile.
+#include "TestSupport.h"
+#include "../MagicData/MagicData_DatCache.h"
+#include "../MagicData/MagicData_Timing.h"
+#include <cstring>
+
+using namespace MagicData;
+
+namespace
+{
+    constexpr int DAT_TRACKS = 5;
+
+    std::size_t FileSize(const std::string& folder, int t)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "Circuits/S1CT%02d.DAT", t + 1);
+        return TestSupport::ReadText(folder + name).size();
+    }
+}
+
+int main()
+{
+    const std::string folder = TestSupport::ScratchFolder("Test_DatCache");
+
+    GP4Sim::ImageSpec   spec;
+    GP4Sim::MemoryImage image;
+    GP4Sim::BuildImage(spec, image);
+
+    TestSupport::WriteText(folder + "GP4MD.ini", TestSupport::QUIET_GENERAL);
+    TestSupport::WriteDats(folder, DAT_TRACKS);
+
+    GP4Sim::Install(image, folder, folder);
+
+    // 1) The cache alone: two requests per track, one mapping
+    DatCache::Resize(spec.trackCount);
+
+    for (int t = 0; t < spec.trackCount; ++t)
+    {
+        DatView first, second;
+        const bool hasFirst = DatCache::Get(t, first);
+        const bool hasSecond = DatCache::Get(t, second);
+
+        const DatLoadStats& s = DatCache::Stats(t);
+        CHECK(s.requests == 2);
+
+        if (t < DAT_TRACKS)
+        {
+            CHECK(hasFirst && hasSecond);
+            CHECK(s.present);
+            CHECK(first.data == second.data);
+            CHECK(first.hasMarkers);
+            CHECK(s.bytesRead == FileSize(folder, t));
+            CHECK(s.loadMs >= 0.0 && s.scanMs >= 0.0);
+        }
+        else
+        {
+            CHECK(!hasFirst && !hasSecond);
+            CHECK(!s.present && s.bytesRead == 0);
+        }
+    }
+
+    DatCache::Release();
+    CHECK(!DatCache::Stats(0).present);
+
+    // 2) A whole startup: per-track .dat figures in the profile, and the
+    //    .dat magicdata in the relocated blocks
+    CHECK(PatchAllTracks());
+
+    const TrackTiming* timing = Timing::Tracks();
+    std::size_t totalBytes = 0;
+    double      totalMs = 0.0;
+
+    for (int t = 0; t < g_TrackCount; ++t)
+    {
+        if (t < DAT_TRACKS)
+        {
+            CHECK(timing[t].datBytes == FileSize(folder, t));
+            CHECK(g_Layout[t].base[1] == 0x11 + t);
+        }
+        else
+        {
+            CHECK(timing[t].datBytes == 0);
+        }
+
+        std::printf("Track %02d: .dat %zu bytes, %.3f ms\n", t + 1, timing[t].datBytes, timing[t].datMs);
+        totalBytes += timing[t].datBytes;
+        totalMs += timing[t].datMs;
+    }
+
+    std::printf("total: %zu bytes, %.3f ms\n", totalBytes, totalMs);
+
+    GP4Sim::Uninstall();
+    return TestSupport::Result("Test_DatCache");
+}
@@ -0,0 +1,137 @@
+// The asynchronous logging pipeline without Flush: the flusher must wake on
+// its own for bursts from several threads and for a single message after it
+// went idle, keeping each thread's messages in order. Messages too large for
+// a ring record arrive whole, in order. After BeginShutdown each message is
+// written by its caller.
+#include "TestSupport.h"
+#include "../Core/Logging.h"
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    std::mutex               g_LinesMutex;
+    std::vector<std::string> g_Lines;
+
+    void Collect(const char* text)
+    {
+        std::lock_guard<std::mutex> lock(g_LinesMutex);
+        g_Lines.push_back(text);
+    }
+
+    std::size_t LineCount()
+    {
+        std::lock_guard<std::mutex> lock(g_LinesMutex);
+        return g_Lines.size();
+    }
+
+    // Waits for the flusher alone to write count lines
+    bool WaitForLines(std::size_t count, double timeoutMs)
+    {
+        const double deadline = Platform::NowMs() + timeoutMs;
+        while (LineCount() < count)
+        {
+            if (Platform::NowMs() > deadline)
+                return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+}
+
+int main()
+{
+    constexpr int THREADS = 4;
+    constexpr int BURSTS = 10;
+    constexpr int PER_BURST = 20;
+
+    Platform::Providers p = Platform::Current();
+    p.debugOutput = &Collect;
+    Platform::SetProviders(p);
+
+    Logging::Config cfg;
+    cfg.async = true;
+    Logging::Configure(cfg);
+
+    // 1) Bursts from several threads, with pauses long enough for the
+    //    flusher to go idle in between
+    std::vector<std::thread> producers;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        producers.emplace_back([t]
+            {
+                for (int b = 0; b < BURSTS; ++b)
+                {
+                    for (int i = 0; i < PER_BURST; ++i)
+                        GP4MD_LOG_INFO(IO, "thread %d message %d\n", t, b * PER_BURST + i);
+
+                    std::this_thread::sleep_for(std::chrono::milliseconds(3));
+                }
+            });
+    }
+
+    for (std::thread& th : producers)
+        th.join();
+
+    const std::size_t total = THREADS * BURSTS * PER_BURST;
+    CHECK(WaitForLines(total, 2000.0));
+    CHECK(Logging::GetStats().dropped == 0);
+
+    {
+        std::lock_guard<std::mutex> lock(g_LinesMutex);
+
+        int next[THREADS] = {};
+        for (const std::string& line : g_Lines)
+        {
+            int t = -1, n = -1;
+            CHECK(std::sscanf(line.c_str(), "GP4MD IO: thread %d message %d", &t, &n) == 2);
+            CHECK(t >= 0 && t < THREADS && n == next[t]);
+
+            if (t >= 0 && t < THREADS)
+                next[t] = n + 1;
+        }
+    }
+
+    // 2) One message after a long idle stretch
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    GP4MD_LOG_INFO(IO, "after idle\n");
+    CHECK(WaitForLines(total + 1, 2000.0));
+
+    // 3) Long %s text and more arguments than a record holds
+    const std::string path = "C:\\Games\\Grand Prix 4\\" + std::string(300, 'x') + "\\GP4MD.gp4mdpack";
+
+    GP4MD_LOG_INFO(IO, "Pack: %s rejected (%s)\n", path.c_str(), "bad header");
+    GP4MD_LOG_INFO(IO, "%d %d %d %d %d %d %d %d %d %d %d %d %d %d\n",
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14);
+    GP4MD_LOG_INFO(IO, "last\n");
+    CHECK(WaitForLines(total + 4, 2000.0));
+
+    {
+        std::lock_guard<std::mutex> lock(g_LinesMutex);
+        CHECK(g_Lines[total + 1] == "GP4MD IO: Pack: " + path + " rejected (bad header)\n");
+        CHECK(g_Lines[total + 2] == "GP4MD IO: 1 2 3 4 5 6 7 8 9 10 11 12 13 14\n");
+        CHECK(g_Lines[total + 3] == "GP4MD IO: last\n");
+    }
+
+    Logging::Stats s = Logging::GetStats();
+    CHECK(s.queued == total + 4 && s.written == total + 4);
+    CHECK(s.oversized == 2 && s.dropped == 0);
+
+    // 4) Shutdown (DLL detach): written before the call returns
+    Logging::BeginShutdown();
+    GP4MD_LOG_INFO(IO, "detach %d\n", 1);
+    GP4MD_LOG_INFO(IO, "Pack: %s closed\n", path.c_str());
+    CHECK(LineCount() == total + 6);
+
+    {
+        std::lock_guard<std::mutex> lock(g_LinesMutex);
+        CHECK(g_Lines[total + 4] == "GP4MD IO: detach 1\n");
+        CHECK(g_Lines[total + 5] == "GP4MD IO: Pack: " + path + " closed\n");
+    }
+
+    s = Logging::GetStats();
+    CHECK(s.queued == total + 6 && s.written == total + 6 && s.dropped == 0);
+
+    return TestSupport::Result("Test_Logging");
+}
@@ -0,0 +1,188 @@
+// MagicTable: Gather / Scatter reproduce every descriptor of every track
+// for counts on and off the SSE2 tile sizes, null rows are left alone both
+// ways, and Scale clamps and truncates as RaceSettings does.
+#include "TestSupport.h"
+#include "../MagicData/MagicData_Table.h"
+#include <cstring>
+
+using namespace MagicData;
+
+namespace
+{
+    std::uint32_t Next(std::uint32_t& rng)
+    {
+        rng = rng * 1103515245u + 12345u;
+        return rng >> 8;
+    }
+
+    std::vector<std::vector<std::uint8_t>> Season(int tracks, std::uint32_t& rng)
+    {
+        std::vector<std::vector<std::uint8_t>> blocks(tracks, std::vector<std::uint8_t>(LAST_DESC_END));
+        for (std::vector<std::uint8_t>& b : blocks)
+        {
+            for (std::uint8_t& byte : b)
+                byte = static_cast<std::uint8_t>(Next(rng));
+        }
+        return blocks;
+    }
+
+    std::uint32_t Read(const std::uint8_t* base, int desc)
+    {
+        std::uint32_t v = 0;
+        std::memcpy(&v, base + g_Desc[desc - 1].offset, DescSize(g_Desc[desc - 1].type));
+        return v;
+    }
+
+    // RaceSettings' clamp and truncation
+    std::uint16_t Scaled(std::uint16_t raw, double mul)
+    {
+        double v = static_cast<double>(raw) * mul;
+        if (v > 65535.0) v = 65535.0;
+        if (v < 0.0)     v = 0.0;
+        return static_cast<std::uint16_t>(v);
+    }
+
+    void RoundTrip(int tracks, std::uint32_t& rng)
+    {
+        std::vector<std::vector<std::uint8_t>> blocks = Season(tracks, rng);
+        const std::vector<std::vector<std::uint8_t>> original = blocks;
+
+        // Every third slot absent
+        std::vector<std::uint8_t*> rows(tracks);
+        for (int t = 0; t < tracks; ++t)
+            rows[t] = t % 3 == 2 ? nullptr : blocks[t].data();
+
+        MagicTable table;
+        table.Resize(tracks);
+        CHECK(table.TrackCount() == tracks);
+
+        table.Gather(rows.data());
+
+        int wrong = 0;
+        for (int t = 0; t < tracks; ++t)
+        {
+            for (int d = 1; d <= DESC_COUNT; ++d)
+            {
+                const std::uint32_t expected = rows[t] ? Read(rows[t], d) : 0;
+                if (table.Get(t, d) != expected)
+                    ++wrong;
+            }
+        }
+        CHECK(wrong == 0);
+
+        // Unchanged columns scatter back to the same bytes
+        table.Scatter(rows.data());
+        CHECK(blocks == original);
+
+        // Edits land in present rows only
+        for (int t = 0; t < tracks; ++t)
+        {
+            for (int d = 1; d <= DESC_COUNT; ++d)
+                table.Set(t, d, Next(rng));
+        }
+        table.Scatter(rows.data());
+
+        wrong = 0;
+        for (int t = 0; t < tracks; ++t)
+        {
+            if (!rows[t])
+            {
+                if (blocks[t] != original[t])
+                    ++wrong;
+                continue;
+            }
+
+            for (int d = 1; d <= DESC_COUNT; ++d)
+            {
+                if (Read(rows[t], d) != table.Get(t, d))
+                    ++wrong;
+            }
+        }
+        CHECK(wrong == 0);
+    }
+
+    void ScaleColumn(int tracks, double mul, std::uint32_t& rng)
+    {
+        MagicTable table;
+        table.Resize(tracks);
+
+        std::vector<std::uint16_t> expected(tracks);
+        int expectedChanged = 0;
+
+        for (int t = 0; t < tracks; ++t)
+        {
+            // Edges, then random values
+            const std::uint16_t raw = t == 0 ? 0 : t == 1 ? 65535 : t == 2 ? 1 : static_cast<std::uint16_t>(Next(rng));
+            table.Set(t, 48, raw);
+
+            expected[t] = Scaled(raw, mul);
+            if (expected[t] != raw)
+                ++expectedChanged;
+        }
+
+        CHECK(table.Scale(48, mul) == expectedChanged);
+
+        int wrong = 0;
+        for (int t = 0; t < tracks; ++t)
+        {
+            if (table.Get(t, 48) != expected[t])
+                ++wrong;
+        }
+        if (wrong)
+            std::printf("Scale x%g on %d tracks: %d wrong\n", mul, tracks, wrong);
+        CHECK(wrong == 0);
+    }
+}
+
+int main()
+{
+    std::uint32_t rng = 11;
+
+    // 1) Gather / Scatter: tile multiples (8 x U16, 4 x U32) and remainders
+    const int counts[] = { 1, 4, 7, 8, 9, DEFAULT_TRACK_COUNT, 24, 40, MAX_TRACK_COUNT };
+    for (int tracks : counts)
+        RoundTrip(tracks, rng);
+
+    // 2) Scale: 100 x 1.15 truncates to 114, clamps at both ends
+    {
+        MagicTable table;
+        table.Resize(3);
+        table.Set(0, 48, 100);
+        table.Set(1, 48, 60000);
+        table.Set(2, 48, 7);
+
+        CHECK(table.Scale(48, 1.15) == 3);
+        CHECK(table.Get(0, 48) == 114);
+        CHECK(table.Get(1, 48) == 65535);
+        CHECK(table.Get(2, 48) == 8);
+
+        CHECK(table.Scale(48, -2.0) == 3);
+        CHECK(table.Get(0, 48) == 0 && table.Get(1, 48) == 0 && table.Get(2, 48) == 0);
+    }
+
+    const double muls[] = { 0.0, 0.07, 0.5, 1.0, 1.15, 1.3, 2.5, 1000.0, -1.0 };
+    for (int tracks : counts)
+    {
+        for (double mul : muls)
+            ScaleColumn(tracks, mul, rng);
+    }
+
+    // 3) Scale leaves columns that are not U16 alone
+    {
+        MagicTable table;
+        table.Resize(DEFAULT_TRACK_COUNT);
+
+        int notU16 = 0;
+        for (int d = 1; d <= DESC_COUNT && !notU16; ++d)
+        {
+            if (g_Desc[d - 1].type != DescType::U16)
+                notU16 = d;
+        }
+
+        table.Fill(notU16, 200);
+        CHECK(table.Scale(notU16, 2.0) == 0);
+        CHECK(table.Get(0, notU16) == 200);
+    }
+
+    return TestSupport::Result("Test_MagicTable");
+}
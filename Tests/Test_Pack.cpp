@@ -0,0 +1,119 @@
+// .gp4mdpack against the INI path it replaces: a pack compiled from a full
+// install, loaded next to that install or alone on a bare client, must
+// publish exactly the bytes the .dat + Track INI path publishes. A
+// corrupted pack is rejected.
+#include "TestSupport.h"
+#include "../MagicData/MagicData_Overlay.h"
+#include <cstring>
+
+using namespace MagicData;
+
+namespace
+{
+    constexpr char RACE_SETTINGS[] =
+        "[RaceSettings]\nSprintRace=1\nSprintPitStop=1\nFuelMultiplier=2.5\n"
+        "TyreWearMultiplier=3\nCCYield=1234\n";
+
+    struct Published
+    {
+        bool                      ok = false;
+        std::vector<std::uint8_t> bytes; // what HashPatched hashes, in order
+        Layer            descSource = Layer::Default;
+    };
+
+    void Append(std::vector<std::uint8_t>& out, const void* data, std::size_t size)
+    {
+        const auto* p = static_cast<const std::uint8_t*>(data);
+        out.insert(out.end(), p, p + size);
+    }
+
+    Published Run(const std::string& folder, const char* general)
+    {
+        TestSupport::WriteText(folder + "GP4MD.ini",
+            std::string(TestSupport::QUIET_GENERAL) + general + RACE_SETTINGS);
+
+        GP4Sim::ImageSpec   spec;
+        GP4Sim::MemoryImage image;
+        GP4Sim::BuildImage(spec, image);
+
+        GP4Sim::Install(image, folder, folder);
+
+        Published r;
+        r.ok = PatchAllTracks();
+
+        if (r.ok)
+        {
+            for (int t = 0; t < g_TrackCount; ++t)
+            {
+                const MagicBlockLayout& l = g_Layout[t];
+                const std::uint32_t bumpSize = static_cast<std::uint32_t>(l.bumpSize);
+
+                Append(r.bytes, l.base, LAST_DESC_END + l.bumpSize);
+                Append(r.bytes, &bumpSize, sizeof(bumpSize));
+            }
+
+            Append(r.bytes, g_LapTable, g_TrackCount);
+            Append(r.bytes, image.bytes.data(), image.lapOffset + g_TrackCount);
+
+            r.descSource = Overlay::DescSource(1, 2);
+        }
+
+        GP4Sim::Uninstall();
+        return r;
+    }
+
+    bool Same(const Published& a, const Published& b, const char* what)
+    {
+        if (a.bytes == b.bytes)
+            return true;
+
+        std::size_t at = 0;
+        while (at < a.bytes.size() && at < b.bytes.size() && a.bytes[at] == b.bytes[at])
+            ++at;
+
+        std::printf("%s: first difference at byte %zu of %zu / %zu\n", what, at, a.bytes.size(), b.bytes.size());
+        return false;
+    }
+}
+
+int main()
+{
+    const std::string full = TestSupport::ScratchFolder("Test_Pack_full");
+    const std::string client = TestSupport::ScratchFolder("Test_Pack_client");
+
+    TestSupport::WriteDats(full, 2);
+    TestSupport::WriteTrackInis(full, DEFAULT_TRACK_COUNT);
+
+    // 1) The INI path, then the same install compiling the pack
+    const Published ini = Run(full, "");
+    const Published compiled = Run(full, "Pack=season.gp4mdpack\nPackCompile=1\n");
+
+    CHECK(ini.ok && compiled.ok);
+    CHECK(Same(ini, compiled, "PackCompile=1"));
+
+    // 2) The pack next to the install it came from
+    const Published packed = Run(full, "Pack=season.gp4mdpack\n");
+    CHECK(packed.ok);
+    CHECK(packed.descSource == Layer::Pack);
+    CHECK(Same(ini, packed, "pack with install"));
+
+    // 3) The pack alone: no .dat files, no Track INIs
+    std::string pack = TestSupport::ReadText(full + "season.gp4mdpack");
+    CHECK(!pack.empty());
+    TestSupport::WriteText(client + "season.gp4mdpack", pack);
+
+    const Published bare = Run(client, "Pack=season.gp4mdpack\n");
+    CHECK(bare.ok);
+    CHECK(bare.descSource == Layer::Pack);
+    CHECK(Same(ini, bare, "pack alone"));
+
+    // 4) One flipped byte: the pack is not used
+    pack[pack.size() / 2] ^= 0x01;
+    TestSupport::WriteText(client + "season.gp4mdpack", pack);
+
+    const Published corrupt = Run(client, "Pack=season.gp4mdpack\n");
+    CHECK(corrupt.descSource != Layer::Pack);
+    CHECK(corrupt.bytes != ini.bytes);
+
+    return TestSupport::Result("Test_Pack");
+}
@@ -0,0 +1,60 @@
+// The parallel prepare / serial commit split against the serial path it
+// replaced: for every thread count, PatchAllTracks publishes the bytes the
+// old one-track-after-another PatchAllTracks produced on the same inputs.
+#include "TestSupport.h"
+
+using namespace MagicData;
+
+namespace
+{
+    // HashPatched of the serial PatchAllTracks (the baseline before the
+    // prepare / commit split, built against GP4Sim's image with IniLib and
+    // GP4MemLib shims) on the inputs below. Only .dat blocks that fit the
+    // original slots are used: the serial path wrote larger ones past
+    // their slot.
+    constexpr std::uint64_t SERIAL_HASH = 0x5399e1c286e03e33ull;
+
+    std::uint64_t Run(const std::string& folder, int threads)
+    {
+        char text[512];
+        std::snprintf(text, sizeof(text),
+            "%sThreads=%d\n"
+            "[RaceSettings]\nSprintRace=1\nSprintPitStop=1\nFuelMultiplier=2.5\n"
+            "TyreWearMultiplier=3\nCCYield=1234\nCCStartCaution=7\n",
+            TestSupport::QUIET_GENERAL, threads);
+        TestSupport::WriteText(folder + "GP4MD.ini", text);
+
+        GP4Sim::ImageSpec   spec;
+        GP4Sim::MemoryImage image;
+        GP4Sim::BuildImage(spec, image);
+
+        GP4Sim::Install(image, folder, folder);
+        CHECK(PatchAllTracks());
+
+        const std::uint64_t hash = TestSupport::HashPatched(image);
+        GP4Sim::Uninstall();
+        return hash;
+    }
+}
+
+int main()
+{
+    const std::string folder = TestSupport::ScratchFolder("Test_Prepare");
+
+    TestSupport::WriteDats(folder, 2);
+    TestSupport::WriteTrackInis(folder, DEFAULT_TRACK_COUNT);
+
+    const int threadCounts[] = { 1, 2, 4, 8, 17 };
+    for (int threads : threadCounts)
+    {
+        const std::uint64_t hash = Run(folder, threads);
+        if (hash != SERIAL_HASH)
+        {
+            std::printf("Threads=%d: %016llx, serial path %016llx\n", threads,
+                static_cast<unsigned long long>(hash), static_cast<unsigned long long>(SERIAL_HASH));
+        }
+        CHECK(hash == SERIAL_HASH);
+    }
+
+    return TestSupport::Result("Test_Prepare");
+}
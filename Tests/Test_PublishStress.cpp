@@ -0,0 +1,173 @@
+// The hook path under concurrent republication: GP4's loader thread goes
+// through Hooks::ResolveMem / ResolveDat and the other readers through
+// Publish::Acquire while the writer commits and reclaims thousands of
+// generations. Every block a reader holds must stay mapped and unchanged
+// until its next acquire. A slot without a published block leaves GP4 its
+// own.
+#include "TestSupport.h"
+#include "../MagicData/MagicData_Hooks.h"
+#include "../MagicData/MagicData_Publish.h"
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+using namespace MagicData;
+
+namespace
+{
+    constexpr std::size_t BLOCK = 512;
+    constexpr int         GENERATIONS = 20000;
+
+    std::atomic<bool> g_Stop(false);
+    std::atomic<long> g_Checks(0);
+    std::atomic<long> g_Bad(0);
+
+    // A generation's block: the track index, then its stamp throughout
+    void Fill(std::uint8_t* block, int t, std::uint8_t stamp)
+    {
+        std::memset(block, stamp, BLOCK);
+        block[0] = static_cast<std::uint8_t>(t);
+    }
+
+    // Reads the block the way GP4 does while it holds it
+    void Hold(const std::uint8_t* block, int t)
+    {
+        for (int pass = 0; pass < 20; ++pass)
+        {
+            const std::uint8_t stamp = block[1];
+
+            bool ok = block[0] == t;
+            for (std::size_t i = 2; i < BLOCK && ok; i += 13)
+                ok = block[i] == stamp;
+
+            if (!ok)
+                ++g_Bad;
+            ++g_Checks;
+        }
+    }
+
+    void HookReader(const std::vector<std::uint8_t*>& origBase)
+    {
+        std::uint32_t rng = 1;
+        while (!g_Stop)
+        {
+            rng = rng * 1103515245u + 12345u;
+            const int t = static_cast<int>((rng >> 8) % g_TrackCount);
+
+            Hold(reinterpret_cast<std::uint8_t*>(Hooks::ResolveMem(origBase[t])), t);
+            Hold(reinterpret_cast<std::uint8_t*>(Hooks::ResolveDat(0)), t);
+        }
+    }
+
+    void Reader(int reader)
+    {
+        std::uint32_t rng = static_cast<std::uint32_t>(reader) * 7919u + 1u;
+        while (!g_Stop)
+        {
+            rng = rng * 1103515245u + 12345u;
+            const int t = static_cast<int>((rng >> 8) % g_TrackCount);
+
+            Hold(Publish::Acquire(t, reader), t);
+        }
+    }
+
+    // One generation holding the tracks in mask
+    void Republish(TrackMask mask, std::uint8_t stamp)
+    {
+        int count = 0;
+        for (int t = 0; t < g_TrackCount; ++t)
+            count += (mask >> t) & 1;
+
+        std::uint8_t* gen = Publish::NewGeneration(count * BLOCK);
+        std::uint8_t* p = gen;
+
+        for (int t = 0; t < g_TrackCount; ++t)
+        {
+            if (!((mask >> t) & 1))
+                continue;
+
+            Fill(p, t, stamp);
+            g_Layout[t].base = p;
+            p += BLOCK;
+        }
+
+        Publish::Commit(gen, mask);
+    }
+}
+
+int main()
+{
+    const std::string folder = TestSupport::ScratchFolder("Test_PublishStress");
+
+    GP4Sim::ImageSpec   spec;
+    GP4Sim::MemoryImage image;
+    GP4Sim::BuildImage(spec, image);
+
+    TestSupport::WriteText(folder + "GP4MD.ini", TestSupport::QUIET_GENERAL);
+    GP4Sim::Install(image, folder, folder);
+    CHECK(PatchAllTracks());
+
+    std::vector<std::uint8_t*> origBase(g_TrackCount), arenaBase(g_TrackCount);
+    for (int t = 0; t < g_TrackCount; ++t)
+    {
+        origBase[t] = g_Layout[t].origBase;
+        arenaBase[t] = g_Layout[t].base;
+    }
+
+    const TrackMask all = (TrackMask(1) << (g_TrackCount - 1) << 1) - 1;
+
+    // Every track in the stamped format before the readers start
+    Republish(all, 0);
+
+    std::vector<std::thread> readers;
+    readers.emplace_back(HookReader, std::cref(origBase));
+    for (int r = 1; r < Publish::MAX_READERS; ++r)
+        readers.emplace_back(Reader, r);
+
+    int freed = 0;
+    for (int i = 1; i <= GENERATIONS; ++i)
+    {
+        const TrackMask mask = (TrackMask(1) << (i % g_TrackCount)) | (TrackMask(1) << ((i * 7) % g_TrackCount));
+        Republish(mask, static_cast<std::uint8_t>(i));
+        freed += Publish::Reclaim();
+    }
+
+    g_Stop = true;
+    for (std::thread& th : readers)
+        th.join();
+
+    // Back to the startup arena; once every reader has moved on, nothing
+    // is left to reclaim
+    for (int t = 0; t < g_TrackCount; ++t)
+        g_Layout[t].base = arenaBase[t];
+    Publish::Commit(nullptr, all);
+
+    for (int r = 0; r < Publish::MAX_READERS; ++r)
+        Publish::Acquire(0, r);
+    freed += Publish::Reclaim();
+
+    std::printf("%d generations, %d freed, %ld checks, %ld bad\n", GENERATIONS + 1, freed, g_Checks.load(), g_Bad.load());
+
+    CHECK(g_Bad == 0);
+    CHECK(g_Checks > 0);
+    CHECK(freed == GENERATIONS + 1);
+    CHECK(Publish::GenerationBytes() == 0);
+    CHECK(Hooks::g_Counters.memMisses == 0);
+
+    // A slot with no published block, as after a PatchAllTracks that failed
+    // once the lookup was built: both hooks fall back to GP4's pointers
+    const int unpublished = g_TrackCount - 1;
+    Publish::g_TrackBase[unpublished].store(nullptr);
+
+    const std::uint32_t datMisses = Hooks::g_Counters.datMisses;
+    const std::uint32_t hits = Hooks::g_Counters.trackHits[unpublished];
+
+    CHECK(Hooks::ResolveMem(origBase[unpublished]) == reinterpret_cast<std::uintptr_t>(origBase[unpublished]));
+    CHECK(g_CurrentTrackIndex == unpublished);
+    CHECK(Hooks::ResolveDat(0x1234) == 0x1234);
+    CHECK(Hooks::g_Counters.datMisses == datMisses + 1);
+    CHECK(Hooks::g_Counters.trackHits[unpublished] == hits + 1); // the memory hook's
+
+    GP4Sim::Uninstall();
+    return TestSupport::Result("Test_PublishStress");
+}
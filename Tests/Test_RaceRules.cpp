@@ -0,0 +1,209 @@
+// Descriptor rules: numeric literals convert exactly as the [RaceSettings]
+// values do, the rules of BuiltinRules.h match ApplyRaceSettings on random
+// configs, and on the simulated image [Rules] reaches every track, Track INI
+// or not, after [RaceSettings].
+#include "TestSupport.h"
+#include "BuiltinRules.h"
+#include "../Core/Logging.h"
+
+using namespace MagicData;
+
+namespace
+{
+    // desc48 (U16) = 100, then one rule; -1 when it does not compile
+    long RunOnDesc48(const char* expression)
+    {
+        RaceRules::Program program;
+        std::string        error;
+        if (!program.Add("desc48", expression, error))
+            return -1;
+
+        std::vector<std::uint8_t> block(LAST_DESC_END, 0);
+        Desc<48>::Write(block.data(), 100);
+
+        std::uint8_t       laps = 50;
+        Patch::Transaction txn(block.data(), block.size());
+        program.Run(RaceRules::RuleInputs(), txn, &laps);
+        txn.Commit(Patch::CommitMode::Plain);
+
+        return Desc<48>::Read(block.data());
+    }
+
+    std::uint32_t Next(std::uint32_t& rng)
+    {
+        rng = rng * 1103515245u + 12345u;
+        return rng >> 8;
+    }
+
+    // Any combination of keys, including out-of-range values
+    RaceConfig RandomConfig(std::uint32_t& rng)
+    {
+        RaceConfig r;
+        if (Next(rng) % 8 == 0)
+            return r;
+
+        r.present = true;
+        r.sprint = Next(rng) % 2 != 0;
+        r.sprintPitStop = Next(rng) % 2 != 0;
+        r.sprintPitStopLap = Next(rng) % 3 ? -1 : static_cast<int>(Next(rng) % 80) - 5;
+        r.sprintPitStopWindow = Next(rng) % 3 ? 3 : static_cast<int>(Next(rng) % 70000) - 100;
+
+        r.hasFuel = Next(rng) % 2 != 0;
+        r.fuel = r.hasFuel ? (static_cast<int>(Next(rng) % 4000) - 300) / 1000.0 : 1.0;
+        r.hasTyre = Next(rng) % 2 != 0;
+        r.tyre = r.hasTyre ? (Next(rng) % 4000) / 997.0 : 1.0;
+
+        r.hasYield = Next(rng) % 2 != 0;
+        r.yield = static_cast<int>(Next(rng) % 140000) - 5000;
+        r.hasCaution = Next(rng) % 2 != 0;
+        r.caution = static_cast<int>(Next(rng) % 300);
+        return r;
+    }
+
+    // PatchAllTracks with [RaceSettings] CCYield=1234 and [Rules] rules
+    bool RunSeason(const std::string& folder, const char* general, const char* rules)
+    {
+        TestSupport::WriteText(folder + "GP4MD.ini", std::string(TestSupport::QUIET_GENERAL) + general +
+            "[RaceSettings]\nCCYield=1234\n[Rules]\n" + rules);
+
+        GP4Sim::ImageSpec   spec;
+        GP4Sim::MemoryImage image;
+        GP4Sim::BuildImage(spec, image);
+
+        GP4Sim::Install(image, folder, folder);
+        const bool ok = PatchAllTracks();
+        GP4Sim::Uninstall();
+        return ok;
+    }
+}
+
+int main()
+{
+    Logging::SetAllLevels(Logging::Level::Error);
+
+    // 1) Literals: 100 * 1.15 is 114.99999999999999 in double
+    CHECK(RunOnDesc48("self * 1.15") == 114);
+    CHECK(RunOnDesc48("self * 1.3") == 130);
+    CHECK(RunOnDesc48("self * 0.07") == 7);
+    CHECK(RunOnDesc48("self * .5") == 50);
+    CHECK(RunOnDesc48("self * 2.") == 200);
+    CHECK(RunOnDesc48("123456789 % 1000") == 789);
+    CHECK(RunOnDesc48("self * 1.0000000000000000001") == 100);
+
+    // and the same factors through FuelMultiplier
+    const char* factors[] = { "1.15", "1.3", "0.07", "2.345", "0.333" };
+    for (const char* f : factors)
+    {
+        IniText::Section race;
+        race.present = true;
+        race.entries.push_back({ "FuelMultiplier", f });
+
+        const RaceConfig config = ParseRaceSettings(race);
+
+        std::vector<std::uint8_t> block(LAST_DESC_END, 0);
+        Desc<48>::Write(block.data(), 100);
+
+        IniText::Section   trackSec;
+        std::uint8_t       laps = 50;
+        Patch::Transaction txn(block.data(), block.size());
+        ApplyRaceSettings(config, trackSec, 0, txn, &laps);
+        txn.Commit(Patch::CommitMode::Plain);
+
+        CHECK(RunOnDesc48((std::string("self * ") + f).c_str()) == Desc<48>::Read(block.data()));
+    }
+
+    // 2) Malformed numbers do not compile
+    CHECK(RunOnDesc48(".") == -1);
+    CHECK(RunOnDesc48("1.5.2") == -1);
+    CHECK(RunOnDesc48("self * 1e3") == -1);
+
+    // Deep nesting is refused, not recursed into: ternary chains, unary
+    // chains and parentheses alike
+    std::string chain, unary, parens;
+    for (int i = 0; i < 100000; ++i)
+    {
+        chain += "0?1:";
+        unary += "-";
+        parens += "(";
+    }
+    CHECK(RunOnDesc48((chain + "7").c_str()) == -1);
+    CHECK(RunOnDesc48((unary + "7").c_str()) == -1);
+    CHECK(RunOnDesc48((parens + "7").c_str()) == -1);
+
+    std::string shallow; // 21 values on the evaluation stack
+    for (int i = 0; i < 10; ++i)
+        shallow += "0?1:";
+    CHECK(RunOnDesc48((shallow + "7").c_str()) == 7);
+    CHECK(RunOnDesc48("((((((((((self))))))))))") == 100);
+
+    // 3) Built-in rules against ApplyRaceSettings
+    std::uint32_t rng = 1;
+    int mismatches = 0;
+    for (int i = 0; i < 5000; ++i)
+    {
+        const RaceConfig config = RandomConfig(rng);
+
+        std::vector<std::uint8_t> a(LAST_DESC_END);
+        for (std::uint8_t& byte : a)
+            byte = static_cast<std::uint8_t>(Next(rng));
+        std::vector<std::uint8_t> b = a;
+
+        const int sprintLaps = Next(rng) % 3 ? 0 : static_cast<int>(Next(rng) % 300) + 1;
+        IniText::Section trackSec;
+        trackSec.present = true;
+        if (sprintLaps)
+            trackSec.entries.push_back({ "SprintLaps", std::to_string(sprintLaps) });
+
+        std::uint8_t lapsA = static_cast<std::uint8_t>(Next(rng));
+        std::uint8_t lapsB = lapsA;
+
+        Patch::Transaction txnA(a.data(), a.size());
+        ApplyRaceSettings(config, trackSec, 3, txnA, &lapsA);
+        txnA.Commit(Patch::CommitMode::Plain);
+
+        RaceRules::RuleInputs in;
+        in.sprintLaps = sprintLaps > 255 ? 255 : sprintLaps;
+        in.trackIndex = 3;
+
+        Patch::Transaction txnB(b.data(), b.size());
+        TestSupport::BuiltinRules(config).Run(in, txnB, &lapsB);
+        txnB.Commit(Patch::CommitMode::Plain);
+
+        if (a != b || lapsA != lapsB)
+            ++mismatches;
+    }
+    CHECK(mismatches == 0);
+
+    // 4) [Rules] on every track; [RaceSettings] (CCYield, desc49) only on
+    //    the ones with a Track INI, and the rules see its write
+    const std::string folder = TestSupport::ScratchFolder("Test_RaceRules");
+    const int iniTracks = 5;
+    for (int t = 0; t < iniTracks; ++t)
+    {
+        char name[32], text[32];
+        std::snprintf(name, sizeof(name), "Track%02d.ini", t + 1);
+        std::snprintf(text, sizeof(text), "[Track%02d]\n", t + 1);
+        TestSupport::WriteText(folder + name, text);
+    }
+
+    const char* rules = "desc48 = 4321\ndesc50 = desc49 + 1\nlaps = track + 30\n";
+    CHECK(RunSeason(folder, "", rules));
+
+    for (int t = 0; t < g_TrackCount; ++t)
+    {
+        const std::uint8_t* block = g_Layout[t].base;
+        const std::uint16_t desc49 = Desc<49>::Read(block);
+
+        CHECK(Desc<48>::Read(block) == 4321);
+        CHECK((t < iniTracks) == (desc49 == 1234));
+        CHECK(Desc<50>::Read(block) == static_cast<std::uint16_t>(desc49 + 1));
+        CHECK(g_LapTable[t] == t + 31);
+    }
+
+    // RaceRules=0: [RaceSettings] alone
+    CHECK(RunSeason(folder, "RaceRules=0\n", rules));
+    for (int t = 0; t < g_TrackCount; ++t)
+        CHECK(Desc<48>::Read(g_Layout[t].base) != 4321);
+
+    return TestSupport::Result("Test_RaceRules");
+}
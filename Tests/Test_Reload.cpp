@@ -0,0 +1,74 @@
+// The watcher race profiles start without HotReload: a [Profile.<Name>]
+// section alone starts it, GP4MD.profile switches the season, and
+// StopHotReload joins it within its wait so it can be started again.
+#include "TestSupport.h"
+#include "../MagicData/MagicData_Hooks.h"
+#include "../MagicData/MagicData_Reload.h"
+
+using namespace MagicData;
+
+namespace
+{
+    // desc49 (CCYield) of track 1 as the hooks hand it to GP4
+    std::uint16_t PublishedYield()
+    {
+        const auto* block = reinterpret_cast<const std::uint8_t*>(Hooks::ResolveMem(g_Layout[0].origBase));
+        return Desc<49>::Read(block);
+    }
+
+    bool WaitForYield(std::uint16_t yield, double timeoutMs)
+    {
+        const double deadline = Platform::NowMs() + timeoutMs;
+        while (PublishedYield() != yield)
+        {
+            if (Platform::NowMs() > deadline)
+                return false;
+            Platform::SleepMs(10);
+        }
+        return true;
+    }
+}
+
+int main()
+{
+    const std::string folder = TestSupport::ScratchFolder("Test_Reload");
+
+    TestSupport::WriteText(folder + "GP4MD.ini", std::string(TestSupport::QUIET_GENERAL) +
+        "HotReload=0\n[RaceSettings]\nCCYield=1234\n[Profile.Wet]\nCCYield=4321\n");
+    TestSupport::WriteText(folder + "Track01.ini", "[Track01]\n");
+
+    GP4Sim::ImageSpec   spec;
+    GP4Sim::MemoryImage image;
+    GP4Sim::BuildImage(spec, image);
+
+    GP4Sim::Install(image, folder, folder);
+    CHECK(PatchAllTracks());
+    CHECK(ProfileCount() == 1);
+    CHECK(PublishedYield() == 1234);
+
+    // 1) Profile only: the control file switches the season
+    StartHotReload();
+    Platform::SleepMs(50);
+
+    TestSupport::WriteText(folder + "GP4MD.profile", "Wet\n");
+    CHECK(WaitForYield(4321, 3000.0));
+
+    // 2) Stop returns within the watcher's wait
+    double start = Platform::NowMs();
+    StopHotReload();
+    CHECK(Platform::NowMs() - start < 1500.0);
+
+    // 3) and the watcher starts again, back to [RaceSettings]
+    StartHotReload();
+    Platform::SleepMs(50);
+
+    TestSupport::WriteText(folder + "GP4MD.profile", "\n");
+    CHECK(WaitForYield(1234, 3000.0));
+
+    start = Platform::NowMs();
+    StopHotReload();
+    CHECK(Platform::NowMs() - start < 1500.0);
+
+    GP4Sim::Uninstall();
+    return TestSupport::Result("Test_Reload");
+}
@@ -0,0 +1,175 @@
+// ScanAll (the SSE2 terminator search where available) against
+// ScanAllScalar on simulated images copied to every alignment of a 64-byte
+// line: oversized bump tables first, random sizes, a terminator at the
+// scan limit and near-miss patterns that only an even-offset exact match
+// may reject.
+#include "TestSupport.h"
+#include "../MagicData/MagicData_Internal.h"
+#include <cstring>
+
+using namespace MagicData;
+
+namespace
+{
+    // MagicData_Internal.cpp's per-block bound, counted from the block start
+    constexpr std::size_t SCAN_LIMIT = 0x20000;
+
+    // Slack around the copy: the vector scan reads whole aligned blocks
+    constexpr std::size_t SLACK = 128;
+
+    std::uint32_t Next(std::uint32_t& rng)
+    {
+        rng = rng * 1103515245u + 12345u;
+        return rng >> 8;
+    }
+
+    // Patterns the scan must step over, each in a bump table only: FF FF
+    // 00 00 at an odd offset, FF FF 00 xx and FF FF xx 00 at even offsets
+    // (not in the last block, where FF FF alone terminates) and an FF right
+    // before the real terminator.
+    void AddNearMisses(GP4Sim::MemoryImage& image, std::uint32_t& rng)
+    {
+        for (int t = 0; t < image.trackCount; ++t)
+        {
+            std::uint8_t* bump = image.bytes.data() + image.trackOffset[t] + LAST_DESC_END;
+            const std::size_t bumpSize = (t < image.trackCount - 1 ? image.trackOffset[t + 1] - 4 : image.lapOffset - 2)
+                - (image.trackOffset[t] + LAST_DESC_END);
+
+            const bool last = t == image.trackCount - 1;
+            for (std::size_t at = 8; at + 16 < bumpSize; at += 16 + 2 * (Next(rng) % 24))
+            {
+                static const std::uint8_t evenMisses[2][4] = {
+                    { 0xFF, 0xFF, 0x00, 0x05 },
+                    { 0xFF, 0xFF, 0x05, 0x00 },
+                };
+
+                const std::uint32_t kind = Next(rng) % 3;
+                if (kind == 0)
+                {
+                    const std::uint8_t odd[4] = { 0xFF, 0xFF, 0x00, 0x00 };
+                    std::memcpy(bump + at + 1, odd, 4);
+                }
+                else if (!last)
+                {
+                    std::memcpy(bump + at, evenMisses[kind - 1], 4);
+                }
+            }
+
+            if (bumpSize >= 2)
+                bump[bumpSize - 1] = 0xFF;
+        }
+    }
+
+    bool SameLayout(const MagicBlockLayout& a, const MagicBlockLayout& b)
+    {
+        return a.valid == b.valid && a.base == b.base && a.bumpStart == b.bumpStart &&
+            a.bumpEnd == b.bumpEnd && a.bumpSize == b.bumpSize;
+    }
+
+    // Both scans on image copied to offset 64 + align; returns the number
+    // of blocks ScanAll found (-1 on any difference)
+    int Compare(const GP4Sim::MemoryImage& image, std::size_t align)
+    {
+        std::vector<std::uint8_t> copy(image.bytes.size() + 2 * SLACK, 0);
+        std::uint8_t* base = copy.data() + 64 + align;
+        std::memcpy(base, image.bytes.data(), image.bytes.size());
+
+        std::vector<MagicBlockLayout> vec(g_TrackCount), ref(g_TrackCount);
+        const int found = MagicDataInternal::ScanAll(base, vec.data());
+        const int refFound = MagicDataInternal::ScanAllScalar(base, ref.data());
+
+        if (found != refFound)
+        {
+            std::printf("align %zu: ScanAll found %d blocks, ScanAllScalar %d\n", align, found, refFound);
+            return -1;
+        }
+
+        for (int t = 0; t < found; ++t)
+        {
+            if (!SameLayout(vec[t], ref[t]))
+            {
+                std::printf("align %zu: block %d ends at +%zu, ScanAllScalar +%zu\n", align, t + 1,
+                    static_cast<std::size_t>(vec[t].bumpEnd - base), static_cast<std::size_t>(ref[t].bumpEnd - base));
+                return -1;
+            }
+        }
+        return found;
+    }
+
+    // Every alignment of spec's image (after near-misses when seeded);
+    // true when all agree on expected blocks
+    bool CheckSpec(const GP4Sim::ImageSpec& spec, bool nearMisses, int expected)
+    {
+        GP4Sim::MemoryImage image;
+        GP4Sim::BuildImage(spec, image);
+
+        std::uint32_t rng = spec.seed;
+        if (nearMisses)
+            AddNearMisses(image, rng);
+
+        SetTrackCount(spec.trackCount);
+
+        bool ok = true;
+        for (std::size_t align = 0; align < 64; ++align)
+            ok &= Compare(image, align) == expected;
+        return ok;
+    }
+}
+
+int main()
+{
+    const int count = DEFAULT_TRACK_COUNT;
+
+    // 1) GP4's own layout
+    {
+        GP4Sim::ImageSpec spec;
+        CHECK(CheckSpec(spec, false, count));
+        CHECK(CheckSpec(spec, true, count));
+    }
+
+    // 2) Oversized bump tables first, then GP4-sized ones
+    {
+        const std::size_t firsts[] = { 4096, 40000, SCAN_LIMIT - LAST_DESC_END - 4 };
+        for (std::size_t first : firsts)
+        {
+            GP4Sim::ImageSpec spec;
+            spec.bumpBytes.assign(count, 56);
+            spec.bumpBytes[0] = first;
+            spec.bumpBytes[1] = first / 2;
+
+            CHECK(CheckSpec(spec, false, count));
+            CHECK(CheckSpec(spec, true, count));
+        }
+    }
+
+    // 3) A first terminator just past the scan limit: neither scan finds it
+    {
+        GP4Sim::ImageSpec spec;
+        spec.bumpBytes.assign(count, 56);
+        spec.bumpBytes[0] = SCAN_LIMIT - LAST_DESC_END - 2;
+        CHECK(CheckSpec(spec, false, 0));
+    }
+
+    // 4) Random sizes, empty bump tables included, for 17 and more slots
+    const int counts[] = { 1, 2, count, 40, MAX_TRACK_COUNT };
+    for (int slots : counts)
+    {
+        for (std::uint32_t seed = 1; seed <= 12; ++seed)
+        {
+            GP4Sim::ImageSpec spec;
+            spec.trackCount = slots;
+            spec.seed = seed;
+
+            std::uint32_t rng = seed * 2654435761u;
+            for (int t = 0; t < slots; ++t)
+            {
+                const std::uint32_t r = Next(rng);
+                spec.bumpBytes.push_back(r % 5 == 0 ? 0 : r % 7 == 0 ? 2000 + r % 9000 : r % 300);
+            }
+
+            CHECK(CheckSpec(spec, true, slots));
+        }
+    }
+
+    return TestSupport::Result("Test_ScanAll");
+}
@@ -0,0 +1,46 @@
+// PatchAllTracks end to end on the simulated GP4 image: every block is
+// relocated, and a Track INI reaches both lap tables.
+#include "TestSupport.h"
+#include "../Core/GP4Addresses.h"
+#include <cstring>
+
+using namespace MagicData;
+
+int main()
+{
+    const std::string folder = TestSupport::ScratchFolder("Test_Sim");
+
+    GP4Sim::ImageSpec   spec;
+    GP4Sim::MemoryImage image;
+    GP4Sim::BuildImage(spec, image);
+
+    // GP4's blocks and lap table before the patch
+    const std::vector<std::uint8_t> original = image.bytes;
+    const std::uint8_t* originalLaps = original.data() + image.lapOffset;
+
+    TestSupport::WriteText(folder + "GP4MD.ini", TestSupport::QUIET_GENERAL);
+    TestSupport::WriteText(folder + "Track05.ini", "[Track05]\nlaps = 33\n");
+
+    GP4Sim::Install(image, folder, folder);
+    CHECK(PatchAllTracks());
+
+    CHECK(g_TrackCount == spec.trackCount);
+
+    for (int t = 0; t < g_TrackCount; ++t)
+    {
+        const MagicBlockLayout& l = g_Layout[t];
+        const std::size_t blockBytes = LAST_DESC_END + l.bumpSize;
+
+        CHECK(l.valid);
+        CHECK(l.origBase == image.bytes.data() + image.trackOffset[t]);
+        CHECK(l.base != l.origBase);
+        CHECK(std::memcmp(l.base, original.data() + image.trackOffset[t], blockBytes) == 0);
+
+        const std::uint8_t expectedLaps = t == 4 ? 33 : originalLaps[t];
+        CHECK(g_LapTable[t] == expectedLaps);
+        CHECK(*GP4Sim::AddressToPtr(image, GP4Addresses::LAP_TABLE_ADDR + t) == expectedLaps);
+    }
+
+    GP4Sim::Uninstall();
+    return TestSupport::Result("Test_Sim");
+}
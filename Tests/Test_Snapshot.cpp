@@ -0,0 +1,122 @@
+// GP4MD.snapshot: a second startup with unchanged inputs restores the saved
+// arena without reading a .dat or Track INI and publishes the same bytes as
+// the build that wrote it. A different module build or an edited Track INI
+// invalidates it.
+#include "TestSupport.h"
+#include "../MagicData/MagicData_Snapshot.h"
+#include "../MagicData/MagicData_Timing.h"
+
+using namespace MagicData;
+
+namespace
+{
+    std::uint64_t g_BuildId = 1;
+
+    std::uint64_t SimBuildId()
+    {
+        return g_BuildId;
+    }
+
+    struct Started
+    {
+        bool          ok = false;
+        std::uint64_t hash = 0;
+        std::size_t   readBytes = 0; // .dat and Track INI bytes read
+        SnapshotStats delta;
+    };
+
+    Started Run(const std::string& folder)
+    {
+        GP4Sim::ImageSpec   spec;
+        GP4Sim::MemoryImage image;
+        GP4Sim::BuildImage(spec, image);
+
+        GP4Sim::Install(image, folder, folder);
+
+        // Install resets the providers; keep the simulator's, swap the build id
+        Platform::Providers providers = Platform::Current();
+        providers.moduleBuildId = &SimBuildId;
+        Platform::SetProviders(providers);
+
+        const SnapshotStats before = g_SnapshotStats;
+
+        Started r;
+        r.ok = PatchAllTracks();
+        if (r.ok)
+            r.hash = TestSupport::HashPatched(image);
+
+        for (int t = 0; t < g_TrackCount; ++t)
+            r.readBytes += Timing::Tracks()[t].datBytes + Timing::Tracks()[t].iniBytes;
+
+        r.delta.hits = g_SnapshotStats.hits - before.hits;
+        r.delta.misses = g_SnapshotStats.misses - before.misses;
+        r.delta.invalidated = g_SnapshotStats.invalidated - before.invalidated;
+        r.delta.saves = g_SnapshotStats.saves - before.saves;
+
+        GP4Sim::Uninstall();
+        return r;
+    }
+}
+
+int main()
+{
+    const std::string folder = TestSupport::ScratchFolder("Test_Snapshot");
+
+    TestSupport::WriteDats(folder, 2);
+    TestSupport::WriteTrackInis(folder, DEFAULT_TRACK_COUNT);
+    TestSupport::WriteText(folder + "GP4MD.ini",
+        std::string(TestSupport::QUIET_GENERAL) + "Snapshot=1\n"
+        "[RaceSettings]\nFuelMultiplier=2.5\nCCYield=1234\n");
+
+    // 1) No snapshot yet: built from the inputs, then saved
+    const Started first = Run(folder);
+    CHECK(first.ok);
+    CHECK(first.delta.misses == 1 && first.delta.saves == 1);
+    CHECK(first.readBytes > 0);
+
+    // 2) Nothing changed: restored, same bytes
+    const Started second = Run(folder);
+    CHECK(second.ok);
+    CHECK(second.delta.hits == 1);
+    CHECK(second.hash == first.hash);
+    CHECK(second.readBytes == 0);
+
+    // 3) Another build of the module: rebuilt and saved again
+    g_BuildId = 2;
+    const Started rebuilt = Run(folder);
+    CHECK(rebuilt.ok);
+    CHECK(rebuilt.delta.invalidated == 1 && rebuilt.delta.saves == 1);
+    CHECK(rebuilt.hash == first.hash);
+    CHECK(rebuilt.readBytes > 0);
+
+    const Started again = Run(folder);
+    CHECK(again.delta.hits == 1 && again.readBytes == 0);
+
+    // 4) An edited Track INI: rebuilt, and the edit is published
+    std::string track = TestSupport::ReadText(folder + "Track03.ini");
+    const std::size_t at = track.find("desc35 = 54");
+    CHECK(at != std::string::npos);
+    track.replace(at, 11, "desc35 = 55 ; edited");
+    TestSupport::WriteText(folder + "Track03.ini", track);
+
+    const Started edited = Run(folder);
+    CHECK(edited.ok);
+    CHECK(edited.delta.invalidated == 1);
+    CHECK(edited.hash != first.hash);
+    CHECK(edited.readBytes > 0);
+
+    // 5) Same input files, damaged payload: the header matches, so the reads
+    //    were deferred; the failed restore reads them and rebuilds
+    std::string snapshot = TestSupport::ReadText(folder + "GP4MD.snapshot");
+    CHECK(!snapshot.empty());
+    snapshot[snapshot.size() - 1] ^= 0x01;
+    TestSupport::WriteText(folder + "GP4MD.snapshot", snapshot);
+
+    const Started damaged = Run(folder);
+    CHECK(damaged.ok);
+    CHECK(damaged.delta.invalidated == 1 && damaged.delta.saves == 1);
+    CHECK(damaged.hash == edited.hash);
+    CHECK(damaged.readBytes > 0);
+
+    return TestSupport::Result("Test_Snapshot");
+}
@@ -0,0 +1,116 @@
+// [General] TrackCount past GP4's 17 slots on simulated images: every slot
+// is relocated, resolved by the hooks and gets its lap count, .dat and
+// Track INI data reach slots beyond 17, and counts that do not match the
+// image or the 1..64 range are rejected.
+#include "TestSupport.h"
+#include "../Core/GP4Addresses.h"
+#include "../MagicData/MagicData_Hooks.h"
+#include <cstring>
+
+using namespace MagicData;
+
+namespace
+{
+    // PatchAllTracks with TrackCount=configured on an image of imageSlots
+    // blocks; checks every slot when it succeeds
+    bool Run(const std::string& folder, int configured, int imageSlots)
+    {
+        char text[256];
+        std::snprintf(text, sizeof(text), "%sTrackCount=%d\n", TestSupport::QUIET_GENERAL, configured);
+        TestSupport::WriteText(folder + "GP4MD.ini", text);
+
+        GP4Sim::ImageSpec spec;
+        spec.trackCount = imageSlots;
+
+        GP4Sim::MemoryImage image;
+        GP4Sim::BuildImage(spec, image);
+        const std::vector<std::uint8_t> original = image.bytes;
+
+        GP4Sim::Install(image, folder, folder);
+        const bool ok = PatchAllTracks();
+
+        if (ok)
+        {
+            CHECK(g_TrackCount == configured);
+            CHECK(static_cast<int>(Hooks::g_Counters.trackHits.size()) == configured);
+
+            for (int t = 0; t < g_TrackCount; ++t)
+            {
+                const MagicBlockLayout& l = g_Layout[t];
+                const bool hasDat = t < 2 || t == configured - 1;
+
+                CHECK(l.valid);
+                CHECK(l.origBase == image.bytes.data() + image.trackOffset[t]);
+                CHECK(l.base != l.origBase);
+
+                // The original blocks stay as they were
+                CHECK(std::memcmp(l.origBase, original.data() + image.trackOffset[t], LAST_DESC_END) == 0);
+
+                // .dat blocks fill the descriptors after byte 0 with 0x11 + t
+                if (hasDat)
+                    CHECK(l.base[1] == static_cast<std::uint8_t>(0x11 + t));
+
+                CHECK(Hooks::FindTrack(l.origBase) == t);
+                CHECK(Hooks::ResolveMem(l.origBase) == reinterpret_cast<std::uintptr_t>(l.base));
+                CHECK(g_CurrentTrackIndex == t);
+                CHECK(Hooks::ResolveDat(0) == reinterpret_cast<std::uintptr_t>(l.base));
+
+                // Track INI laps on every third slot, else the .dat's, else GP4's
+                const std::uint8_t laps = t % 3 == 0 ? static_cast<std::uint8_t>(40 + t)
+                    : hasDat ? static_cast<std::uint8_t>(50 + t)
+                    : original[image.lapOffset + t];
+
+                CHECK(g_LapTable[t] == laps);
+                CHECK(*GP4Sim::AddressToPtr(image, GP4Addresses::LAP_TABLE_ADDR + t) == laps);
+            }
+
+            CHECK(Hooks::g_Counters.memMisses == 0);
+        }
+
+        GP4Sim::Uninstall();
+        return ok;
+    }
+
+    // .dat files for slots 1, 2 and the last one
+    void WriteSeasonDats(const std::string& folder, int slots)
+    {
+        const int tracks[] = { 0, 1, slots - 1 };
+        for (int t : tracks)
+        {
+            std::vector<std::uint8_t> magic(LAST_DESC_END + 40, static_cast<std::uint8_t>(0x11 + t));
+            magic[0] = 160;
+            GP4Sim::WriteSyntheticDat(folder, t, magic.data(), magic.size(), 50 + t, 1 << 12);
+        }
+    }
+}
+
+int main()
+{
+    const int counts[] = { 18, 24, 40, MAX_TRACK_COUNT };
+    for (int count : counts)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "Test_TrackCount%d", count);
+
+        const std::string folder = TestSupport::ScratchFolder(name);
+        WriteSeasonDats(folder, count);
+        TestSupport::WriteTrackInis(folder, count);
+
+        CHECK(Run(folder, count, count));
+    }
+
+    // Out of range, or not the image's block count
+    const std::string folder = TestSupport::ScratchFolder("Test_TrackCount");
+    WriteSeasonDats(folder, 24);
+    TestSupport::WriteTrackInis(folder, 24);
+
+    CHECK(!Run(folder, 0, DEFAULT_TRACK_COUNT));
+    CHECK(!Run(folder, MAX_TRACK_COUNT + 1, DEFAULT_TRACK_COUNT));
+    CHECK(!Run(folder, 24, DEFAULT_TRACK_COUNT));
+    CHECK(!Run(folder, 16, DEFAULT_TRACK_COUNT));
+
+    // and a valid count afterwards
+    CHECK(Run(folder, 24, 24));
+
+    return TestSupport::Result("Test_TrackCount");
+}